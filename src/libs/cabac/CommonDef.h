@@ -1,9 +1,14 @@
 #ifndef COMMONDEF_H
 #define COMMONDEF_H
 
+#include <climits>
+#include <cstdint>
 #include <cstring>
 #include <utility>
 #include <sstream>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 // We assume that 1000 contexts are enough for most of the scenarios.
 #define RWTH_PYTHON_IF 1
@@ -39,9 +44,47 @@ static constexpr int SCALE_BITS = 15;  // Precision for fractional bit estimates
 
 static const int RExt__GOLOMB_RICE_ADAPTATION_STATISTICS_SETS =     4;
 
+// floor(log2(x)) for x > 0, via count leading zeros
+inline unsigned int floorLog2(const uint64_t x)
+{
+#if defined(_MSC_VER)
+  unsigned long idx;
+  _BitScanReverse64(&idx, x);
+  return (unsigned int)idx;
+#else
+  return 63 - __builtin_clzll(x);
+#endif
+}
+
+// Largest value of encodeRemAbsEP/decodeRemAbsEP with the given parameters (cutoff + maxLog2TrDynamicRange <= 32 and
+// goRicePar <= maxLog2TrDynamicRange): the longest escape prefix of 32 - cutoff - maxLog2TrDynamicRange '1's is
+// followed by maxLog2TrDynamicRange suffix bins. Larger values are truncated by the escape.
+inline uint64_t getMaxRemAbsEP(const unsigned goRicePar, const unsigned cutoff, const unsigned maxLog2TrDynamicRange)
+{
+  const unsigned maxPrefixLength = 32 - cutoff - maxLog2TrDynamicRange;
+  const uint64_t maxValue = ((((uint64_t)1 << maxPrefixLength) + cutoff - 1) << goRicePar)
+    + ((uint64_t)1 << maxLog2TrDynamicRange) - 1;
+  return maxValue < UINT32_MAX ? maxValue : UINT32_MAX;
+}
+
 
 #if RWTH_PYTHON_IF
 typedef const std::function<unsigned int(unsigned int)> CtxFunction;
+
+// Context ID of bin n from a context provider, i.e. a callable (e.g. CtxFunction) or an array of context IDs
+template <class CtxProvider>
+inline unsigned int getCtxId(const CtxProvider &ctxIds, const unsigned int n) { return ctxIds(n); }
+template <class T>
+inline unsigned int getCtxId(T * const &ctxIds, const unsigned int n) { return ctxIds[n]; }
+
+// Position from which on all bins of a symbol share one context ID, for context providers with a getRestPos()
+// member (e.g. contextSelector::ContextIdProvider). Other providers give no such guarantee (UINT_MAX).
+template <class CtxProvider>
+inline auto getRestPos(const CtxProvider &ctxIds, int) -> decltype(ctxIds.getRestPos()) { return ctxIds.getRestPos(); }
+template <class CtxProvider>
+inline unsigned int getRestPos(const CtxProvider &, long) { return UINT_MAX; }
+template <class CtxProvider>
+inline unsigned int getRestPos(const CtxProvider &ctxIds) { return getRestPos(ctxIds, 0); }
 #endif // RWTH_PYTHON_IF
 
 
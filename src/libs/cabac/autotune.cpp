@@ -0,0 +1,181 @@
+#include "autotune.h"
+#include "sequence_encoder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+
+#if RWTH_PYTHON_IF
+namespace autotune{
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  SearchSpace::SearchSpace()
+    : binIds{binarization::BinarizationId::BI, binarization::BinarizationId::TU, binarization::BinarizationId::EGk},
+      ctxModelIds{contextSelector::ContextModelId::BAC, contextSelector::ContextModelId::BINPOSITION,
+        contextSelector::ContextModelId::BINSORDERN, contextSelector::ContextModelId::SYMBOLORDERN},
+      orders{1, 2}, restPos{4, 8}, symbolMax{4, 16}, k{0, 1, 2}, cutoffs{8}, bypass(true), maxSymbolTU(1 << 8)
+  {}
+
+  std::vector<CodingConfig> SearchSpace::getCandidates(const uint64_t maxSymbol) const {
+    const unsigned int numBins = floorLog2(maxSymbol | 1) + 1;
+    const bool fitsMaxSymbol32 = maxSymbol <= UINT32_MAX;  // maxSymbol as numMaxBins of TU, TB and EGk
+    const unsigned int maxSymbol32 = static_cast<unsigned int>(maxSymbol);
+
+    // Binarization parameters per binarization
+    std::vector<std::pair<binarization::BinarizationId, std::vector<unsigned int>>> binarizations;
+    for (const auto binId : binIds) {
+      switch (binId) {
+        case binarization::BinarizationId::BI:
+          binarizations.emplace_back(binId, std::vector<unsigned int>{numBins});
+          break;
+        case binarization::BinarizationId::TU:
+        case binarization::BinarizationId::TB:
+          if (fitsMaxSymbol32 && maxSymbol <= maxSymbolTU) {
+            binarizations.emplace_back(binId, std::vector<unsigned int>{maxSymbol32});
+          }
+          break;
+        case binarization::BinarizationId::EGk:
+          if (fitsMaxSymbol32) {
+            for (const unsigned int kEGk : k) {
+              binarizations.emplace_back(binId, std::vector<unsigned int>{maxSymbol32, kEGk});
+            }
+          }
+          break;
+        case binarization::BinarizationId::UEGk:
+          for (const unsigned int cutoff : cutoffs) {
+            for (const unsigned int kEGk : k) {
+              binarizations.emplace_back(binId, std::vector<unsigned int>{cutoff, kEGk});
+            }
+          }
+          break;
+        case binarization::BinarizationId::RICE:
+          for (const unsigned int cutoff : cutoffs) {
+            for (const unsigned int riceParam : k) {
+              binarizations.emplace_back(binId,
+                std::vector<unsigned int>{0, 0, riceParam, cutoff, std::max(15u, numBins)});
+            }
+          }
+          break;
+        default:
+          throw std::runtime_error("getCandidates: Unsupported binarization ID");
+      }
+    }
+
+    std::vector<CodingConfig> candidates;
+    auto addCandidate = [&candidates](const binarization::BinarizationId binId,
+      const contextSelector::ContextModelId ctxModelId, const std::vector<unsigned int>& binParams,
+      const std::vector<unsigned int>& ctxParams) {
+      try {
+        candidates.emplace_back(binId, ctxModelId, binParams, ctxParams);
+      } catch (const std::runtime_error&) {
+        // invalid combination
+      }
+    };
+    for (const auto& b : binarizations) {
+      if (bypass) {
+        try {
+          candidates.emplace_back(b.first, b.second);
+        } catch (const std::runtime_error&) {
+        }
+      }
+      for (const auto ctxModelId : ctxModelIds) {
+        const bool useOrder = ctxModelId == contextSelector::ContextModelId::BINSORDERN ||
+          ctxModelId == contextSelector::ContextModelId::SYMBOLORDERN;
+        for (const unsigned int order : useOrder ? orders : std::vector<unsigned int>{1}) {
+          for (const unsigned int r : restPos) {
+            if (ctxModelId == contextSelector::ContextModelId::SYMBOLORDERN) {
+              for (const unsigned int s : symbolMax) {
+                addCandidate(b.first, ctxModelId, b.second, {order, r, 0, s});
+              }
+            } else {
+              addCandidate(b.first, ctxModelId, b.second, {order, r, 0});
+            }
+          }
+        }
+      }
+    }
+    return candidates;
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  std::vector<Result> autotune(const uint64_t * symbols, const unsigned int numSymbols,
+    const std::vector<CodingConfig>& candidates, unsigned int numThreads, const double p1Init, const uint8_t shiftIdx) {
+    std::vector<Result> results;
+    results.reserve(candidates.size());
+    for (const auto& config : candidates) {
+      results.push_back(Result{config, 0.0, 0.0});
+    }
+
+    std::atomic<size_t> next(0);
+    auto evaluateCandidates = [&]() {
+      for (size_t c = next++; c < results.size(); c = next++) {
+        Result& result = results[c];
+        const auto t0 = std::chrono::steady_clock::now();
+        cabacSimpleSequenceEncoder encoder;
+        encoder.initCtx(std::max(1u, result.config.ctxOffset + result.config.numContexts), p1Init, shiftIdx);
+        encoder.setBitEstimation(true);
+        encoder.start();
+        encoder.resetBits();
+        if (result.config.bypass) {
+          encoder.encodeSymbolsBypass(symbols, numSymbols, result.config);
+        } else {
+          encoder.encodeSymbols(symbols, numSymbols, result.config);
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(t1 - t0).count();
+        result.bitsPerSymbol = numSymbols ?
+          static_cast<double>(encoder.getEstFracBits()) / (1 << SCALE_BITS) / numSymbols : 0.0;
+        result.symbolsPerSecond = seconds > 0 ? numSymbols / seconds : 0.0;
+      }
+    };
+
+    // Exceptions of the worker threads (e.g. symbols exceeding the binarization of a candidate) are passed on to the
+    // caller after all threads are joined
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto evaluate = [&]() {
+      try {
+        evaluateCandidates();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error = std::current_exception();
+        next = results.size();
+      }
+    };
+
+    if (numThreads == 0) {
+      numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(numThreads, candidates.size())));
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < numThreads; t++) {
+      threads.emplace_back(evaluate);
+    }
+    evaluate();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const Result& a, const Result& b) {
+      return a.bitsPerSymbol < b.bitsPerSymbol;
+    });
+    return results;
+  }
+
+  std::vector<Result> autotune(const uint64_t * symbols, const unsigned int numSymbols,
+    const SearchSpace& searchSpace, const unsigned int numThreads) {
+    const uint64_t maxSymbol = numSymbols ? *std::max_element(symbols, symbols + numSymbols) : 0;
+    return autotune(symbols, numSymbols, searchSpace.getCandidates(maxSymbol), numThreads);
+  }
+
+};  // namespace autotune
+
+#endif  // RWTH_PYTHON_IF
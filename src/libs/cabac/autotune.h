@@ -0,0 +1,59 @@
+#ifndef __RWTH_AUTOTUNE_H__
+#define __RWTH_AUTOTUNE_H__
+
+#include "CommonDef.h"
+#include <cstdint>
+#include <vector>
+
+#if RWTH_PYTHON_IF
+#include "coding_config.h"
+
+namespace autotune{
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Automatic choice of the binarization and context model of a sequence of symbols.
+    // Each candidate configuration is evaluated in the bit estimation mode of the encoder (see
+    // BinEncoderBase::setBitEstimation), i.e. with the binarization, context selection and probability adaptation of
+    // encodeSymbols, but without arithmetic coding and bitstream writing. The candidates are distributed over threads.
+
+    // Grid of candidate configurations. Binarization parameters are derived from the largest symbol:
+    // BI: {numBins}, TU/TB: {maxSymbol}, EGk: {maxSymbol, k}, UEGk: {cutoff, k}, RICE: {0, 0, k, cutoff, max(15, numBins)}.
+    // TU and TB are only candidates for maxSymbol <= maxSymbolTU, since TU codes up to maxSymbol bins per symbol.
+    // Binarizations which cannot represent maxSymbol (TU, TB and EGk for maxSymbol > UINT32_MAX) are skipped.
+    // Context parameters: {order, restPos, 0, symbolMax}, where order and symbolMax only vary for the context models
+    // which use them. Candidates rejected by CodingConfig (e.g. RICE with BINSORDERN) are skipped.
+    struct SearchSpace {
+        SearchSpace();
+
+        std::vector<binarization::BinarizationId> binIds;
+        std::vector<contextSelector::ContextModelId> ctxModelIds;  // base context models, without symbol position
+        std::vector<unsigned int> orders;
+        std::vector<unsigned int> restPos;
+        std::vector<unsigned int> symbolMax;
+        std::vector<unsigned int> k;  // EGk/UEGk: k, RICE: Rice parameter
+        std::vector<unsigned int> cutoffs;  // UEGk, RICE
+        bool bypass;  // additionally, bypass coding per binarization and k
+        uint64_t maxSymbolTU;  // default: 256
+
+        std::vector<CodingConfig> getCandidates(const uint64_t maxSymbol) const;
+    };
+
+    struct Result {
+        CodingConfig config;
+        double bitsPerSymbol;  // estimated
+        double symbolsPerSecond;  // measured throughput of the estimation (binarization, context modeling, adaptation)
+    };
+
+    // Candidates ranked by estimated bits per symbol. Contexts are initialized with (p1Init, shiftIdx) as in initCtx.
+    // Bypass candidates (config.bypass) are evaluated and coded with encodeSymbolsBypass, the others with encodeSymbols.
+    // numThreads = 0: hardware concurrency
+    std::vector<Result> autotune(const uint64_t * symbols, const unsigned int numSymbols,
+        const std::vector<CodingConfig>& candidates, unsigned int numThreads = 0, const double p1Init = 0.5,
+        const uint8_t shiftIdx = 8);
+    std::vector<Result> autotune(const uint64_t * symbols, const unsigned int numSymbols,
+        const SearchSpace& searchSpace, const unsigned int numThreads = 0);
+
+};  // namespace autotune
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_AUTOTUNE_H__
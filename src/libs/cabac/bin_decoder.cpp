@@ -135,21 +135,15 @@ unsigned BinDecoderBase::decodeBinsEP( unsigned numBins )
   }
   unsigned remBins = numBins;
   unsigned bins    = 0;
+  // m_Value < m_Range << ( 7 + n ) before reading n bins, so the n bins are the quotient m_Value / ( m_Range << 7 )
+  const unsigned scaledRange = m_Range << 7;
   while(   remBins > 8 )
   {
     m_Value     = ( m_Value << 8 ) + ( m_Bitstream->readByte() << ( 8 + m_bitsNeeded ) );
-    unsigned SR =   m_Range << 15;
-    for( int i = 0; i < 8; i++ )
-    {
-      bins += bins;
-      SR  >>= 1;
-      if( m_Value >= SR )
-      {
-        bins    ++;
-        m_Value -= SR;
-      }
-    }
-    remBins -= 8;
+    unsigned q  = m_Value / scaledRange;
+    bins        = ( bins << 8 ) + q;
+    m_Value    -= q * scaledRange;
+    remBins    -= 8;
   }
   m_bitsNeeded   += remBins;
   m_Value       <<= remBins;
@@ -158,17 +152,9 @@ unsigned BinDecoderBase::decodeBinsEP( unsigned numBins )
     m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
     m_bitsNeeded -= 8;
   }
-  unsigned SR = m_Range << ( remBins + 7 );
-  for ( int i = 0; i < remBins; i++ )
-  {
-    bins += bins;
-    SR  >>= 1;
-    if( m_Value >= SR )
-    {
-      bins    ++;
-      m_Value -= SR;
-    }
-  }
+  unsigned q  = m_Value / scaledRange;
+  bins        = ( bins << remBins ) + q;
+  m_Value    -= q * scaledRange;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::IncrementStatisticEP( *ptype, numBins, int(bins) );
 #endif
@@ -181,19 +167,56 @@ unsigned BinDecoderBase::decodeBinsEP( unsigned numBins )
   return bins;
 }
 
-unsigned BinDecoderBase::decodeRemAbsEP(unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange)
+// Same as decodeBinsEP for up to 64 bins, read in chunks of 32 bins
+uint64_t BinDecoderBase::decodeBinsEP64( unsigned numBins )
 {
-  unsigned prefix = 0;
+  uint64_t bins = 0;
+  while( numBins > 32 )
   {
-    const unsigned  maxPrefix = 32 - maxLog2TrDynamicRange;
-    unsigned        codeWord = 0;
-    do
+    numBins -= 32;
+    bins     = ( bins << 32 ) | decodeBinsEP( 32 );
+  }
+  return ( bins << numBins ) | decodeBinsEP( numBins );
+}
+
+// Decodes a run of bypass bins equal to 1, terminated by a 0 bin or after maxNumOnes bins, and returns its length.
+// The bins of a window of up to 16 bins are computed at once, without reading them, as the quotient of the value
+// register (extended by the next bitstream bytes) and the range. Only the leading '1's and the terminating '0' are
+// then actually read.
+unsigned BinDecoderBase::decodeOnesRunEP( unsigned maxNumOnes )
+{
+  // Short runs are most frequent, decode the first bin directly
+  if( !maxNumOnes || !decodeBinEP() )
+  {
+    return 0;
+  }
+  unsigned numOnes = 1;
+  while( numOnes < maxNumOnes )
+  {
+    const unsigned windowSize = std::min<unsigned>( maxNumOnes - numOnes, 16 );
+
+    // Bytes enter the value register after -m_bitsNeeded, -m_bitsNeeded+8 and -m_bitsNeeded+16 bins
+    const uint64_t nextBytes = ( m_Bitstream->peekByte( 0 ) << 16 ) | ( m_Bitstream->peekByte( 1 ) << 8 ) | m_Bitstream->peekByte( 2 );
+    const uint64_t value     = ( uint64_t( m_Value ) << windowSize ) + ( ( nextBytes << windowSize ) >> ( 16 - m_bitsNeeded ) );
+    const unsigned bins      = unsigned( value / ( m_Range << 7 ) );
+    const unsigned zeros     = ~bins & ( ( 1u << windowSize ) - 1 );
+    if( !zeros )
     {
-      prefix++;
-      codeWord = decodeBinEP();
-    } while (codeWord && prefix < maxPrefix);
-    prefix -= 1 - codeWord;
+      decodeBinsEP( windowSize );
+      numOnes += windowSize;
+      continue;
+    }
+    const unsigned numLeadingOnes = windowSize - 1 - floorLog2( zeros );
+    decodeBinsEP( numLeadingOnes + 1 );
+    return numOnes + numLeadingOnes;
   }
+  return numOnes;
+}
+
+unsigned BinDecoderBase::decodeRemAbsEP(unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange)
+{
+  // Unary prefix of at most 32 - maxLog2TrDynamicRange '1's
+  const unsigned prefix = decodeOnesRunEP( 32 - maxLog2TrDynamicRange );
 
   unsigned length = goRicePar, offset;
   if (prefix < cutoff)
@@ -211,6 +234,34 @@ unsigned BinDecoderBase::decodeRemAbsEP(unsigned goRicePar, unsigned cutoff, int
 }
 
 
+// Escape part of decodeRemAbsEP, after the cutoff leading '1's of the prefix have been decoded
+unsigned BinDecoderBase::decodeRemAbsEscapeEP(unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange)
+{
+  const unsigned maxPrefixLength = 32 - cutoff - maxLog2TrDynamicRange;
+  const unsigned prefix = decodeOnesRunEP( maxPrefixLength );
+  const unsigned offset = ((1 << prefix) + cutoff - 1) << goRicePar;
+  const unsigned length = goRicePar + (prefix == maxPrefixLength ? maxLog2TrDynamicRange - goRicePar : prefix);
+  return offset + decodeBinsEP(length);
+}
+
+// Decodes numSymbols symbols with decodeRemAbsEP, with a fixed Rice parameter
+void BinDecoderBase::decodeRemAbsEPArray( uint64_t* symbols, unsigned numSymbols, unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange )
+{
+  for( unsigned i = 0; i < numSymbols; i++ )
+  {
+    symbols[i] = decodeRemAbsEP( goRicePar, cutoff, maxLog2TrDynamicRange );
+  }
+}
+
+// Same as above, with Rice parameter goRicePars[i] for symbol i
+void BinDecoderBase::decodeRemAbsEPArray( uint64_t* symbols, unsigned numSymbols, const unsigned* goRicePars, unsigned cutoff, int maxLog2TrDynamicRange )
+{
+  for( unsigned i = 0; i < numSymbols; i++ )
+  {
+    symbols[i] = decodeRemAbsEP( goRicePars[i], cutoff, maxLog2TrDynamicRange );
+  }
+}
+
 unsigned BinDecoderBase::decodeBinTrm()
 {
   m_Range    -= 2;
@@ -297,6 +348,48 @@ unsigned BinDecoderBase::decodeAlignedBinsEP( unsigned numBins )
 }
 
 
+// Aligns the arithmetic decoder and reads numSymbols fixed-length symbols of numBins bins each,
+// see BinEncoderBase::encodeAlignedBinsEPArray. Whole bytes are taken from m_Value into a 64-bit
+// word; only the trailing bins of the sequence that do not fill a byte go through decodeAlignedBinsEP.
+void BinDecoderBase::decodeAlignedBinsEPArray( uint64_t* symbols, unsigned numSymbols, unsigned numBins )
+{
+  CHECK( numBins > 64, "Number of bins exceeds '64'" );
+  align();
+  uint64_t numBytes = ( uint64_t( numSymbols ) * numBins ) >> 3;
+  uint64_t acc      = 0;  // decoded bins not yet assigned to a symbol, LSB-aligned
+  unsigned accBins  = 0;
+  for( unsigned i = 0; i < numSymbols; i++ )
+  {
+    // pop at most 32 bins at a time, so that acc never holds more than 39 bins
+    uint64_t symbol  = 0;
+    unsigned remBins = numBins;
+    while( remBins > 0 )
+    {
+      unsigned binsToPop = std::min<unsigned>( remBins, 32 );
+      while( accBins < binsToPop && numBytes > 0 )
+      {
+        // m_Value = |0|V|V|V|V|V|V|V|V|B|B|B|B|B|B|B|, and m_bitsNeeded + 8 >= 0 always holds
+        acc           = ( acc << 8 ) | ( ( m_Value >> 7 ) & 0xff );
+        accBins      += 8;
+        m_Value       = ( ( m_Value << 8 ) & 0x7FFF ) | ( m_Bitstream->readByte() << ( m_bitsNeeded + 8 ) );
+        numBytes--;
+      }
+      if( accBins < binsToPop )
+      {
+        // last symbol of the sequence
+        unsigned tailBins = binsToPop - accBins;
+        acc               = ( acc << tailBins ) | decodeAlignedBinsEP( tailBins );
+        accBins          += tailBins;
+      }
+      accBins -= binsToPop;
+      remBins -= binsToPop;
+      symbol   = ( symbol << binsToPop ) | ( ( acc >> accBins ) & ( ( uint64_t( 1 ) << binsToPop ) - 1 ) );
+    }
+    symbols[i] = symbol;
+  }
+}
+
+
 #if RWTH_PYTHON_IF
 template <class BinProbModel>
 TBinDecoder<BinProbModel>::TBinDecoder()
@@ -311,59 +404,4 @@ TBinDecoder<BinProbModel>::TBinDecoder()
 {}
 #endif
 
-template <class BinProbModel>
-unsigned TBinDecoder<BinProbModel>::decodeBin( unsigned ctxId )
-{
-  BinProbModel& rcProbModel = m_Ctx[ctxId];
-  unsigned      bin         = rcProbModel.mps();
-  uint32_t      LPS         = rcProbModel.getLPS( m_Range );
-
-  // DTRACE( g_trace_ctx, D_CABAC, "%d" " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  " , DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), ctxId, m_Range, m_Range-LPS, LPS, ( unsigned int )( rcProbModel.state() ), m_Value < ( ( m_Range - LPS ) << 7 ) );
-  //DTRACE( g_trace_ctx, D_CABAC, " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  ", DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, m_Range - LPS, LPS, (unsigned int)( rcProbModel.state() ), m_Value < ( ( m_Range - LPS ) << 7 ) );
-
-  m_Range   -=  LPS;
-  uint32_t      SR          = m_Range << 7;
-  if( m_Value < SR )
-  {
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-    CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, m_Range, int( bin ) );
-#endif
-    // MPS path
-    if( m_Range < 256 )
-    {
-      int numBits   = rcProbModel.getRenormBitsRange( m_Range );
-      m_Range     <<= numBits;
-      m_Value     <<= numBits;
-      m_bitsNeeded += numBits;
-      if( m_bitsNeeded >= 0 )
-      {
-        m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
-        m_bitsNeeded -= 8;
-      }
-    }
-  }
-  else
-  {
-    bin = 1 - bin;
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-    CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, LPS, int( bin ) );
-#endif
-    // LPS path
-    int numBits   = rcProbModel.getRenormBitsLPS( LPS );
-    m_Value      -= SR;
-    m_Value       = m_Value << numBits;
-    m_Range       = LPS     << numBits;
-    m_bitsNeeded += numBits;
-    if( m_bitsNeeded >= 0 )
-    {
-      m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
-      m_bitsNeeded -= 8;
-    }
-  }
-  rcProbModel.update( bin );
-  //DTRACE_DECR_COUNTER( g_trace_ctx, D_CABAC );
-  //DTRACE_WITHOUT_COUNT( g_trace_ctx, D_CABAC, "  -  " "%d" "\n", bin );
-  return  bin;
-}
-
 template class TBinDecoder<BinProbModel_Std>;
@@ -76,9 +76,15 @@ public:
 public:
   unsigned          decodeBinEP         ();
   unsigned          decodeBinsEP        ( unsigned numBins  );
+  uint64_t          decodeBinsEP64      ( unsigned numBins  );
+  unsigned          decodeOnesRunEP     ( unsigned maxNumOnes );
   unsigned          decodeRemAbsEP      ( unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange );
+  unsigned          decodeRemAbsEscapeEP( unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange );
+  void              decodeRemAbsEPArray ( uint64_t* symbols, unsigned numSymbols, unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange );
+  void              decodeRemAbsEPArray ( uint64_t* symbols, unsigned numSymbols, const unsigned* goRicePars, unsigned cutoff, int maxLog2TrDynamicRange );
   unsigned          decodeBinTrm        ();
   void              align               ();
+  void              decodeAlignedBinsEPArray( uint64_t* symbols, unsigned numSymbols, unsigned numBins );
   unsigned          getNumBitsRead      () { return m_Bitstream->getNumBitsRead() + m_bitsNeeded; }
 private:
   unsigned          decodeAlignedBinsEP ( unsigned numBins  );
@@ -98,7 +104,9 @@ class TBinDecoder : public BinDecoderBase
 public:
   TBinDecoder ();
   ~TBinDecoder() {}
-  unsigned decodeBin ( unsigned ctxId );
+  unsigned decodeBin ( unsigned ctxId ) final;
+  uint64_t decodeMPSRun( unsigned ctxId, uint64_t maxRun );
+  unsigned getMps    ( unsigned ctxId ) const { return m_Ctx[ctxId].mps(); }
 private:
 #if RWTH_PYTHON_IF
   friend class cabacDecoder;
@@ -108,6 +116,109 @@ private:
 #endif
 };
 
+// Defined in the header, such that the context-coded bin path inlines into the symbol coding loops
+template <class BinProbModel>
+inline unsigned TBinDecoder<BinProbModel>::decodeBin( unsigned ctxId )
+{
+  BinProbModel& rcProbModel = m_Ctx[ctxId];
+  unsigned      bin         = rcProbModel.mps();
+  uint32_t      LPS         = rcProbModel.getLPS( m_Range );
+
+  // DTRACE( g_trace_ctx, D_CABAC, "%d" " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  " , DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), ctxId, m_Range, m_Range-LPS, LPS, ( unsigned int )( rcProbModel.state() ), m_Value < ( ( m_Range - LPS ) << 7 ) );
+  //DTRACE( g_trace_ctx, D_CABAC, " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  ", DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, m_Range - LPS, LPS, (unsigned int)( rcProbModel.state() ), m_Value < ( ( m_Range - LPS ) << 7 ) );
+
+  m_Range   -=  LPS;
+  uint32_t      SR          = m_Range << 7;
+  if( m_Value < SR )
+  {
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, m_Range, int( bin ) );
+#endif
+    // MPS path
+    if( m_Range < 256 )
+    {
+      int numBits   = rcProbModel.getRenormBitsRange( m_Range );
+      m_Range     <<= numBits;
+      m_Value     <<= numBits;
+      m_bitsNeeded += numBits;
+      if( m_bitsNeeded >= 0 )
+      {
+        m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
+        m_bitsNeeded -= 8;
+      }
+    }
+  }
+  else
+  {
+    bin = 1 - bin;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, LPS, int( bin ) );
+#endif
+    // LPS path
+    int numBits   = rcProbModel.getRenormBitsLPS( LPS );
+    m_Value      -= SR;
+    m_Value       = m_Value << numBits;
+    m_Range       = LPS     << numBits;
+    m_bitsNeeded += numBits;
+    if( m_bitsNeeded >= 0 )
+    {
+      m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
+      m_bitsNeeded -= 8;
+    }
+  }
+  rcProbModel.update( bin );
+  //DTRACE_DECR_COUNTER( g_trace_ctx, D_CABAC );
+  //DTRACE_WITHOUT_COUNT( g_trace_ctx, D_CABAC, "  -  " "%d" "\n", bin );
+  return  bin;
+}
+
+// Run mode: decodes bins of context ctxId, as long as they equal the MPS (at most maxRun), and returns their number.
+// The LPS ending the run is not consumed, i.e. it is returned by the next decodeBin call. Bit-exact with
+// TBinEncoder::encodeMPSRun and with decoding bin by bin. As in the encoder, the probability update is skipped, once
+// the state has converged.
+template <class BinProbModel>
+inline uint64_t TBinDecoder<BinProbModel>::decodeMPSRun( unsigned ctxId, uint64_t maxRun )
+{
+  BinProbModel& rcProbModel = m_Ctx[ctxId];
+  const unsigned mps        = rcProbModel.mps();
+  uint32_t      range       = m_Range;
+  uint32_t      value       = m_Value;
+  int32_t       bitsNeeded  = m_bitsNeeded;
+  bool          converged   = false;
+  uint64_t      run         = 0;
+  for( ; run < maxRun; run++ )
+  {
+    const uint32_t rangeMPS = range - rcProbModel.getLPS( range );
+    if( value >= ( rangeMPS << 7 ) )
+    {
+      break;  // LPS
+    }
+    range = rangeMPS;
+    if( range < 256 )
+    {
+      int numBits   = rcProbModel.getRenormBitsRange( range );
+      range       <<= numBits;
+      value       <<= numBits;
+      bitsNeeded   += numBits;
+      if( bitsNeeded >= 0 )
+      {
+        value      += m_Bitstream->readByte() << bitsNeeded;
+        bitsNeeded -= 8;
+      }
+    }
+    if( !converged )
+    {
+      const uint16_t state = rcProbModel.getState();
+      rcProbModel.update( mps );
+      converged = rcProbModel.getState() == state;
+    }
+  }
+  m_Range      = range;
+  m_Value      = value;
+  m_bitsNeeded = bitsNeeded;
+  return run;
+}
+
 typedef TBinDecoder<BinProbModel_Std>   BinDecoder_Std;
 
 #if RWTH_PYTHON_IF
@@ -131,6 +242,35 @@ public:
       m_Ctx[i].initFromP1AndShiftIdx(pInit, shiftInit);
     }
   }
+
+  // Frozen contexts keep their probability, see BinProbModel_Std::freeze. Freezing all contexts at the same point on
+  // the encoder and decoder side, e.g. after the first N symbols, keeps both in sync.
+  void initCtx(const FrozenContexts& frozenCtx) {
+    m_Ctx = frozenCtx.getContexts();
+  }
+
+  void freezeCtx() {
+    for (auto& probModel : m_Ctx) {
+      probModel.freeze();
+    }
+  }
+
+  void freezeCtx(const std::vector<unsigned int>& ctxIds) {
+    for (auto ctxId : ctxIds) {
+      m_Ctx.at(ctxId).freeze();
+    }
+  }
+
+  bool isCtxFrozen(unsigned ctxId) const { return m_Ctx.at(ctxId).isFrozen(); }
+
+  // Current contexts as frozen set, e.g. at the end of a training phase
+  FrozenContexts getFrozenContexts() const { return FrozenContexts(m_Ctx); }
+
+  // Context states for a warm start of the next stream, see exportContexts in contexts.h
+  std::vector<uint16_t> exportContexts() const { return ::exportContexts(m_Ctx); }
+  void importContexts(const std::vector<uint16_t>& words) {
+    m_Ctx = ::importContexts(words);
+  }
   
 }; // class cabacDecoder
 #endif  // RWTH_PYTHON_IF
\ No newline at end of file
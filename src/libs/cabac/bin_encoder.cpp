@@ -66,6 +66,8 @@ uint32_t BinCounter::getAll() const
   }
   return count;
 }
+#else
+const std::size_t BinStore::defaultMaxNumBins;
 #endif
 
 #if RWTH_PYTHON_IF
@@ -77,6 +79,9 @@ BinEncoderBase::BinEncoderBase( const BinProbModel* dummy )
   , m_bufferedByte    ( 0 )
   , m_numBufferedBytes( 0 )
   , m_bitsLeft        ( 0 )
+  , m_binObserved     ( false )
+  , m_bitEstimation   ( false )
+  , m_estFracBits     ( 0 )
 {}
 #else
 template <class BinProbModel>
@@ -110,8 +115,8 @@ void BinEncoderBase::start()
   m_bitsLeft          = 23;
 #if !RWTH_PYTHON_IF
   BinCounter::reset();
-  m_BinStore. reset();
 #endif
+  m_BinStore. reset();
 }
 
 void BinEncoderBase::finish()
@@ -166,11 +171,20 @@ void BinEncoderBase::resetBits()
   m_bitsLeft          = 23;
 #if !RWTH_PYTHON_IF
   BinCounter::reset();
+#else
+  m_estFracBits       = 0;
 #endif
 }
 
 void BinEncoderBase::encodeBinEP( unsigned bin )
 {
+#if RWTH_PYTHON_IF
+  if( m_bitEstimation )
+  {
+    m_estFracBits += BinProbModelBase::estFracBitsEP();
+    return;
+  }
+#endif
   // DTRACE( g_trace_ctx, D_CABAC, "%d" "  " "%d" "  EP=%d \n", DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, bin );
 
 #if !RWTH_PYTHON_IF
@@ -190,6 +204,13 @@ void BinEncoderBase::encodeBinEP( unsigned bin )
 
 void BinEncoderBase::encodeBinsEP( unsigned bins, unsigned numBins )
 {
+#if RWTH_PYTHON_IF
+  if( m_bitEstimation )
+  {
+    m_estFracBits += BinProbModelBase::estFracBitsEP( numBins );
+    return;
+  }
+#endif
   for(int i = 0; i < numBins; i++)
   {
     // DTRACE( g_trace_ctx, D_CABAC, "%d" "  " "%d" "  EP=%d \n", DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, ( bins >> ( numBins - 1 - i ) ) & 1 );
@@ -225,6 +246,17 @@ void BinEncoderBase::encodeBinsEP( unsigned bins, unsigned numBins )
   }
 }
 
+// Same as encodeBinsEP for up to 64 bins, written in chunks of 32 bins. Bins beyond the 64 bits of bins are zero.
+void BinEncoderBase::encodeBinsEP64( uint64_t bins, unsigned numBins )
+{
+  while( numBins > 32 )
+  {
+    numBins -= 32;
+    encodeBinsEP( numBins < 64 ? unsigned( bins >> numBins ) : 0, 32 );
+  }
+  encodeBinsEP( numBins < 32 ? unsigned( bins ) & ( ( 1u << numBins ) - 1 ) : unsigned( bins ), numBins );
+}
+
 void BinEncoderBase::encodeRemAbsEP(unsigned bins, unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange)
 {
   const unsigned threshold = cutoff << goRicePar;
@@ -237,34 +269,78 @@ void BinEncoderBase::encodeRemAbsEP(unsigned bins, unsigned goRicePar, unsigned
   }
   else
   {
-    const unsigned  maxPrefixLength = 32 - cutoff - maxLog2TrDynamicRange;
-    unsigned        prefixLength = 0;
-    unsigned        codeValue = (bins >> goRicePar) - cutoff;
-    unsigned        suffixLength;
-    if (codeValue >= ((1 << maxPrefixLength) - 1))
-    {
-      prefixLength = maxPrefixLength;
-      suffixLength = maxLog2TrDynamicRange;
-    }
-    else
-    {
-      while (codeValue > ((2 << prefixLength) - 2))
-      {
-        prefixLength++;
-      }
-      suffixLength = prefixLength + goRicePar + 1; //+1 for the separator bit
-    }
-    const unsigned totalPrefixLength = prefixLength + cutoff;
-    const unsigned bitMask = (1 << goRicePar) - 1;
-    const unsigned prefix = (1 << totalPrefixLength) - 1;
-    const unsigned suffix = ((codeValue - ((1 << prefixLength) - 1)) << goRicePar) | (bins & bitMask);
-    encodeBinsEP(prefix, totalPrefixLength); //prefix
-    encodeBinsEP(suffix, suffixLength); //separator, suffix, and rParam bits
+    encodeRemAbsEscapeEP(bins, goRicePar, cutoff, maxLog2TrDynamicRange, cutoff);
+  }
+}
+
+// Escape part of encodeRemAbsEP for bins >= cutoff << goRicePar. Only numCutoffBins of the cutoff leading '1's
+// are written, such that the others can be coded separately (e.g. context-coded, see cabacSymbolEncoder::encodeBinsRICE)
+void BinEncoderBase::encodeRemAbsEscapeEP(unsigned bins, unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange,
+                                          unsigned numCutoffBins)
+{
+  const unsigned  maxPrefixLength = 32 - cutoff - maxLog2TrDynamicRange;
+  unsigned        prefixLength = 0;
+  unsigned        codeValue = (bins >> goRicePar) - cutoff;
+  unsigned        suffixLength;
+  if (codeValue >= ((1 << maxPrefixLength) - 1))
+  {
+    prefixLength = maxPrefixLength;
+    suffixLength = maxLog2TrDynamicRange;
+  }
+  else
+  {
+    // Smallest prefixLength with codeValue <= (2 << prefixLength) - 2
+    prefixLength = floorLog2( uint64_t( codeValue ) + 1 );
+    suffixLength = prefixLength + goRicePar + 1; //+1 for the separator bit
+  }
+  const unsigned totalPrefixLength = prefixLength + numCutoffBins;
+  const unsigned bitMask = (1 << goRicePar) - 1;
+  const unsigned prefix = (1 << totalPrefixLength) - 1;
+  const unsigned suffix = ((codeValue - ((1 << prefixLength) - 1)) << goRicePar) | (bins & bitMask);
+  encodeBinsEP(prefix, totalPrefixLength); //prefix
+  encodeBinsEP(suffix, suffixLength); //separator, suffix, and rParam bits
+}
+
+// Largest symbol of encodeRemAbsEPArray, see getMaxRemAbsEP
+static uint64_t getMaxRemAbsEPArray( unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange )
+{
+  CHECK( maxLog2TrDynamicRange < 0 || cutoff + maxLog2TrDynamicRange > 32 || goRicePar > unsigned( maxLog2TrDynamicRange ),
+         "Requires cutoff + maxLog2TrDynamicRange <= 32 and goRicePar <= maxLog2TrDynamicRange" );
+  return getMaxRemAbsEP( goRicePar, cutoff, maxLog2TrDynamicRange );
+}
+
+// Codes numSymbols symbols with encodeRemAbsEP, with a fixed Rice parameter. Symbols beyond the range of the escape
+// (getMaxRemAbsEP) are rejected instead of truncated.
+void BinEncoderBase::encodeRemAbsEPArray( const uint64_t* symbols, unsigned numSymbols, unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange )
+{
+  const uint64_t maxSymbol = getMaxRemAbsEPArray( goRicePar, cutoff, maxLog2TrDynamicRange );
+  for( unsigned i = 0; i < numSymbols; i++ )
+  {
+    CHECK( symbols[i] > maxSymbol, "Symbol exceeds the range of encodeRemAbsEP" );
+    encodeRemAbsEP( unsigned( symbols[i] ), goRicePar, cutoff, maxLog2TrDynamicRange );
+  }
+}
+
+// Same as above, with Rice parameter goRicePars[i] for symbol i
+void BinEncoderBase::encodeRemAbsEPArray( const uint64_t* symbols, unsigned numSymbols, const unsigned* goRicePars, unsigned cutoff, int maxLog2TrDynamicRange )
+{
+  for( unsigned i = 0; i < numSymbols; i++ )
+  {
+    CHECK( symbols[i] > getMaxRemAbsEPArray( goRicePars[i], cutoff, maxLog2TrDynamicRange ),
+           "Symbol exceeds the range of encodeRemAbsEP" );
+    encodeRemAbsEP( unsigned( symbols[i] ), goRicePars[i], cutoff, maxLog2TrDynamicRange );
   }
 }
 
 void BinEncoderBase::encodeBinTrm( unsigned bin )
 {
+#if RWTH_PYTHON_IF
+  if( m_bitEstimation )
+  {
+    m_estFracBits += BinProbModel_Std::estFracBitsTrm( bin );
+    return;
+  }
+#endif
 #if !RWTH_PYTHON_IF
   BinCounter::addTrm();
 #endif
@@ -332,6 +408,51 @@ void BinEncoderBase::encodeAlignedBinsEP( unsigned bins, unsigned numBins )
   }
 }
 
+// Aligns the arithmetic coder and writes numSymbols fixed-length symbols of numBins bins each.
+// With range 256 every bypass bin is a plain bit of m_Low, so the symbols are packed into a
+// 64-bit word and handed to the coder byte by byte. The result is identical to align() followed
+// by encodeBinsEP64( symbols[i], numBins ) for all i.
+void BinEncoderBase::encodeAlignedBinsEPArray( const uint64_t* symbols, unsigned numSymbols, unsigned numBins )
+{
+#if RWTH_PYTHON_IF
+  if( m_bitEstimation )
+  {
+    m_estFracBits += ( uint64_t( numSymbols ) * numBins ) << SCALE_BITS;
+    return;
+  }
+#endif
+  CHECK( numBins > 64, "Number of bins exceeds '64'" );
+  align();
+  uint64_t acc      = 0;  // pending bins, LSB-aligned
+  unsigned accBins  = 0;
+  for( unsigned i = 0; i < numSymbols; i++ )
+  {
+    // push at most 32 bins at a time, so that acc never holds more than 39 bins
+    unsigned remBins = numBins;
+    while( remBins > 0 )
+    {
+      unsigned binsToPush = std::min<unsigned>( remBins, 32 );
+      remBins            -= binsToPush;
+      acc                 = ( acc << binsToPush ) | ( ( symbols[i] >> remBins ) & ( ( uint64_t( 1 ) << binsToPush ) - 1 ) );
+      accBins            += binsToPush;
+      while( accBins >= 8 )
+      {
+        accBins    -= 8;
+        m_Low       = ( m_Low << 8 ) + ( unsigned( ( acc >> accBins ) & 0xff ) << 8 ); //range is known to be 256
+        m_bitsLeft -= 8;
+        if( m_bitsLeft < 12 )
+        {
+          writeOut();
+        }
+      }
+    }
+  }
+  if( accBins > 0 )
+  {
+    encodeAlignedBinsEP( unsigned( acc & ( ( 1u << accBins ) - 1 ) ), accBins );
+  }
+}
+
 void BinEncoderBase::writeOut()
 {
   unsigned leadByte = m_Low >> ( 24 - m_bitsLeft );
@@ -348,11 +469,11 @@ void BinEncoderBase::writeOut()
       unsigned carry  = leadByte >> 8;
       unsigned byte   = m_bufferedByte + carry;
       m_bufferedByte  = leadByte & 0xff;
-      m_Bitstream->write( byte, 8 );
+      m_Bitstream->writeByte( byte );
       byte            = ( 0xff + carry ) & 0xff;
       while( m_numBufferedBytes > 1 )
       {
-        m_Bitstream->write( byte, 8 );
+        m_Bitstream->writeByte( byte );
         m_numBufferedBytes--;
       }
     }
@@ -379,51 +500,3 @@ TBinEncoder<BinProbModel>::TBinEncoder()
 {}
 #endif
 
-template <class BinProbModel>
-void TBinEncoder<BinProbModel>::encodeBin( unsigned bin, unsigned ctxId )
-{
-#if !RWTH_PYTHON_IF
-  BinCounter::addCtx( ctxId );
-#endif
-  BinProbModel& rcProbModel = m_Ctx[ctxId];
-  uint32_t      LPS         = rcProbModel.getLPS( m_Range );
-
-#if RWTH_ENABLE_TRACING
-  m_pAndMpsTrace[ctxId].push_back(std::make_pair(rcProbModel.getState() >> 1, rcProbModel.mps()));
-#endif
-
-  // DTRACE( g_trace_ctx, D_CABAC, "%d" " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  " "  -  " "%d" "\n", DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), ctxId, m_Range, m_Range - LPS, LPS, ( unsigned int ) ( rcProbModel.state() ), bin == rcProbModel.mps(), bin );
-
-  m_Range   -=  LPS;
-  if( bin != rcProbModel.mps() )
-  {
-    int numBits   = rcProbModel.getRenormBitsLPS( LPS );
-    m_bitsLeft   -= numBits;
-    m_Low        += m_Range;
-    m_Low         = m_Low << numBits;
-    m_Range       = LPS   << numBits;
-    if( m_bitsLeft < 12 )
-    {
-      writeOut();
-    }
-  }
-  else
-  {
-    if( m_Range < 256 )
-    {
-      int numBits   = rcProbModel.getRenormBitsRange( m_Range );
-      m_bitsLeft   -= numBits;
-      m_Low       <<= numBits;
-      m_Range     <<= numBits;
-      if( m_bitsLeft < 12 )
-      {
-        writeOut();
-      }
-    }
-  }
-  rcProbModel.update( bin );
-#if !RWTH_PYTHON_IF
-  BinEncoderBase::m_BinStore.addBin( bin, ctxId );
-#endif
-}
-
@@ -41,6 +41,7 @@
 #include <vector>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 
 
@@ -97,6 +98,51 @@ private:
   bool                              m_allocated;
   std::vector< std::vector<bool> >  m_binBuffer;
 };
+#else
+// Records the context-coded bins per context (up to getMaxNumBins() each), e.g. to train context initializations, see
+// contextTraining::recordBins. The contexts are allocated on demand, bypass bins are not recorded.
+class BinStore
+{
+public:
+  BinStore () : m_inUse(false), m_maxNumBins(defaultMaxNumBins)  {}
+  ~BinStore()                   {}
+
+  void  reset   ()
+  {
+    for( auto& binBuffer : m_binBuffer )
+    {
+      binBuffer.clear();
+    }
+  }
+  void  addBin  ( unsigned bin, unsigned ctxId )
+  {
+    if( m_inUse )
+    {
+      if( ctxId >= m_binBuffer.size() )
+      {
+        m_binBuffer.resize( ctxId + 1 );
+      }
+      std::vector<uint8_t>& binBuffer = m_binBuffer[ctxId];
+      if( binBuffer.size() < m_maxNumBins )
+      {
+        binBuffer.push_back( static_cast<uint8_t>( bin ) );
+      }
+    }
+  }
+
+  void                        setUse          ( bool useStore )         { m_inUse = useStore; }
+  bool                        inUse           ()                  const { return m_inUse; }
+  unsigned                    getNumContexts  ()                  const { return (unsigned)m_binBuffer.size(); }
+  const std::vector<uint8_t>& getBinVector    ( unsigned ctxId )  const { return m_binBuffer[ctxId]; }
+  void                        setMaxNumBins   ( std::size_t n )         { m_maxNumBins = n; }
+  std::size_t                 getMaxNumBins   ()                  const { return m_maxNumBins; }
+
+  static const std::size_t          defaultMaxNumBins = 100000;
+private:
+  bool                              m_inUse;
+  std::size_t                       m_maxNumBins;
+  std::vector<std::vector<uint8_t>> m_binBuffer;
+};
 #endif
 
 #if !RWTH_PYTHON_IF
@@ -190,19 +236,47 @@ public:
   void      reset   ( int qp, int initId );
 public:
   void      resetBits           ();
+#if RWTH_PYTHON_IF
+  // Bit estimation mode: bins are not coded, but their estimated bits (in 1 << SCALE_BITS units, from the
+  // m_binFracBits tables of the contexts) are accumulated, e.g. for fast configuration search. resetBits() resets
+  // the estimate.
+  void      setBitEstimation    ( bool b )                  { m_bitEstimation = b; m_binObserved = b || m_BinStore.inUse(); }
+  bool      isBitEstimation     ()                    const { return m_bitEstimation; }
+  uint64_t  getEstFracBits      ()                    const { return m_estFracBits; }
+#else
   uint64_t  getEstFracBits      ()                    const { THROW( "not supported" ); return 0; }
+#endif
 #if !RWTH_PYTHON_IF
   unsigned  getNumBins          ( unsigned ctxId )    const { return BinCounter::getCtx(ctxId); }
 #endif
 public:
   void      encodeBinEP         ( unsigned bin                      );
   void      encodeBinsEP        ( unsigned bins,  unsigned numBins  );
+  void      encodeBinsEP64      ( uint64_t bins,  unsigned numBins  );
   void      encodeRemAbsEP      ( unsigned bins,
                                   unsigned goRicePar,
                                   unsigned cutoff,
                                   int      maxLog2TrDynamicRange    );
+  void      encodeRemAbsEscapeEP( unsigned bins,
+                                  unsigned goRicePar,
+                                  unsigned cutoff,
+                                  int      maxLog2TrDynamicRange,
+                                  unsigned numCutoffBins            );
+  void      encodeRemAbsEPArray ( const uint64_t* symbols,
+                                  unsigned numSymbols,
+                                  unsigned goRicePar,
+                                  unsigned cutoff,
+                                  int      maxLog2TrDynamicRange    );
+  void      encodeRemAbsEPArray ( const uint64_t* symbols,
+                                  unsigned numSymbols,
+                                  const unsigned* goRicePars,
+                                  unsigned cutoff,
+                                  int      maxLog2TrDynamicRange    );
   void      encodeBinTrm        ( unsigned bin                      );
   void      align               ();
+  void      encodeAlignedBinsEPArray( const uint64_t* symbols,
+                                      unsigned numSymbols,
+                                      unsigned numBins              );
   unsigned  getNumWrittenBits   () { return ( m_Bitstream->getNumberOfWrittenBits() + 8 * m_numBufferedBytes + 23 - m_bitsLeft ); }
 public:
 #if !RWTH_PYTHON_IF
@@ -219,8 +293,11 @@ protected:
   uint32_t                m_bufferedByte;
   int32_t                 m_numBufferedBytes;
   int32_t                 m_bitsLeft;
-#if !RWTH_PYTHON_IF
   BinStore                m_BinStore;
+#if RWTH_PYTHON_IF
+  bool                    m_binObserved;    // bin storage or bit estimation, see TBinEncoder::encodeBinObserved
+  bool                    m_bitEstimation;
+  uint64_t                m_estFracBits;
 #endif
 #if RWTH_ENABLE_TRACING
  protected:
@@ -238,14 +315,24 @@ public:
   TBinEncoder ();
   ~TBinEncoder() {}
   void  encodeBin   ( unsigned bin, unsigned ctxId );
+  void  encodeMPSRun( unsigned ctxId, uint64_t runLength );
+  unsigned getMps   ( unsigned ctxId )          const   { return m_Ctx[ctxId].mps(); }
 public:
-#if !RWTH_PYTHON_IF
+#if RWTH_PYTHON_IF
+  void            setBinStorage     ( bool b )          { m_BinStore.setUse(b); m_binObserved = b || m_bitEstimation; }
+  void            setBinStorage     ( bool b, std::size_t maxNumBins )  { m_BinStore.setMaxNumBins(maxNumBins); setBinStorage(b); }
+#else
   void            setBinStorage     ( bool b )          { m_BinStore.setUse(b); }
+#endif
   const BinStore* getBinStore       ()          const   { return &m_BinStore; }
+#if !RWTH_PYTHON_IF
   BinEncIf*       getTestBinEncoder ()          const;
 #endif
 private:
+  void  xEncodeBin  ( unsigned bin, unsigned ctxId );
 #if RWTH_PYTHON_IF
+  void  encodeBinObserved  ( unsigned bin, unsigned ctxId );
+  void  encodeMPSRunNoStore( unsigned ctxId, uint64_t runLength );
   friend class cabacEncoder;
   friend class cabacTraceEncoder;
   std::vector<BinProbModel> m_Ctx;
@@ -254,6 +341,157 @@ private:
 #endif
 };
 
+// Defined in the header, such that the context-coded bin path inlines into the symbol coding loops
+template <class BinProbModel>
+inline void TBinEncoder<BinProbModel>::encodeBin( unsigned bin, unsigned ctxId )
+{
+#if RWTH_PYTHON_IF
+  if( m_binObserved )
+  {
+    encodeBinObserved( bin, ctxId );
+    return;
+  }
+#else
+  BinCounter::addCtx( ctxId );
+#endif
+  xEncodeBin( bin, ctxId );
+#if !RWTH_PYTHON_IF
+  BinEncoderBase::m_BinStore.addBin( bin, ctxId );
+#endif
+}
+
+#if RWTH_PYTHON_IF
+// Slow path of encodeBin with bin storage or bit estimation
+template <class BinProbModel>
+void TBinEncoder<BinProbModel>::encodeBinObserved( unsigned bin, unsigned ctxId )
+{
+  BinEncoderBase::m_BinStore.addBin( bin, ctxId );
+  if( m_bitEstimation )
+  {
+    m_Ctx[ctxId].estFracBitsUpdate( bin, m_estFracBits );
+    return;
+  }
+  xEncodeBin( bin, ctxId );
+}
+#endif
+
+template <class BinProbModel>
+inline void TBinEncoder<BinProbModel>::xEncodeBin( unsigned bin, unsigned ctxId )
+{
+  BinProbModel& rcProbModel = m_Ctx[ctxId];
+  uint32_t      LPS         = rcProbModel.getLPS( m_Range );
+
+#if RWTH_ENABLE_TRACING
+  m_pAndMpsTrace[ctxId].push_back(std::make_pair(rcProbModel.getState() >> 1, rcProbModel.mps()));
+#endif
+
+  // DTRACE( g_trace_ctx, D_CABAC, "%d" " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  " "  -  " "%d" "\n", DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), ctxId, m_Range, m_Range - LPS, LPS, ( unsigned int ) ( rcProbModel.state() ), bin == rcProbModel.mps(), bin );
+
+  m_Range   -=  LPS;
+  if( bin != rcProbModel.mps() )
+  {
+    int numBits   = rcProbModel.getRenormBitsLPS( LPS );
+    m_bitsLeft   -= numBits;
+    m_Low        += m_Range;
+    m_Low         = m_Low << numBits;
+    m_Range       = LPS   << numBits;
+    if( m_bitsLeft < 12 )
+    {
+      writeOut();
+    }
+  }
+  else
+  {
+    if( m_Range < 256 )
+    {
+      int numBits   = rcProbModel.getRenormBitsRange( m_Range );
+      m_bitsLeft   -= numBits;
+      m_Low       <<= numBits;
+      m_Range     <<= numBits;
+      if( m_bitsLeft < 12 )
+      {
+        writeOut();
+      }
+    }
+  }
+  rcProbModel.update( bin );
+}
+
+// Run mode: encodes runLength bins equal to the current MPS of context ctxId, bit-exact with as many encodeBin calls.
+// Coding the MPS never flips the MPS, such that the bin comparison and LPS path are dropped. Both estimates move
+// towards the MPS, i.e. the state is at its fixed point as soon as an update does not change it. From then on, the
+// probability update is skipped and m_Low is only shifted, once per written byte. With tracing, bin storage or bit
+// estimation, the bins are coded one by one.
+template <class BinProbModel>
+inline void TBinEncoder<BinProbModel>::encodeMPSRun( unsigned ctxId, uint64_t runLength )
+{
+#if RWTH_PYTHON_IF && !RWTH_ENABLE_TRACING
+  if( !m_binObserved )
+  {
+    encodeMPSRunNoStore( ctxId, runLength );
+    return;
+  }
+#endif
+  const unsigned mps = m_Ctx[ctxId].mps();
+  for( uint64_t i = 0; i < runLength; i++ )
+  {
+    encodeBin( mps, ctxId );
+  }
+}
+
+#if RWTH_PYTHON_IF
+template <class BinProbModel>
+inline void TBinEncoder<BinProbModel>::encodeMPSRunNoStore( unsigned ctxId, uint64_t runLength )
+{
+  BinProbModel& rcProbModel = m_Ctx[ctxId];
+  const unsigned mps        = rcProbModel.mps();
+  uint64_t      i           = 0;
+  bool          converged   = false;
+  for( ; i < runLength && !converged; i++ )
+  {
+    m_Range -= rcProbModel.getLPS( m_Range );
+    if( m_Range < 256 )
+    {
+      int numBits   = rcProbModel.getRenormBitsRange( m_Range );
+      m_bitsLeft   -= numBits;
+      m_Low       <<= numBits;
+      m_Range     <<= numBits;
+      if( m_bitsLeft < 12 )
+      {
+        writeOut();
+      }
+    }
+    const uint16_t state = rcProbModel.getState();
+    rcProbModel.update( mps );
+    converged = rcProbModel.getState() == state;
+  }
+
+  const BinProbModel probModel = rcProbModel;
+  uint32_t range   = m_Range;
+  int      numBits = 0;  // renormalization bits not yet shifted into m_Low
+  for( ; i < runLength; i++ )
+  {
+    range -= probModel.getLPS( range );
+    if( range < 256 )
+    {
+      int renormBits = probModel.getRenormBitsRange( range );
+      range        <<= renormBits;
+      numBits       += renormBits;
+      if( m_bitsLeft - numBits < 12 )
+      {
+        m_bitsLeft -= numBits;
+        m_Low     <<= numBits;
+        numBits     = 0;
+        writeOut();
+      }
+    }
+  }
+  m_bitsLeft -= numBits;
+  m_Low     <<= numBits;
+  m_Range     = range;
+}
+#endif
+
 typedef TBinEncoder  <BinProbModel_Std>   BinEncoder_Std;
 
 template class TBinEncoder<BinProbModel_Std>;
@@ -285,6 +523,66 @@ public:
 #endif
   }
 
+  // Frozen contexts keep their probability, see BinProbModel_Std::freeze. Freezing all contexts at the same point on
+  // the encoder and decoder side, e.g. after the first N symbols, keeps both in sync.
+  void initCtx(const FrozenContexts& frozenCtx) {
+    m_Ctx = frozenCtx.getContexts();
+#if RWTH_ENABLE_TRACING
+    m_pAndMpsTrace.resize(frozenCtx.size());
+#endif
+  }
+
+  void freezeCtx() {
+    for (auto& probModel : m_Ctx) {
+      probModel.freeze();
+    }
+  }
+
+  void freezeCtx(const std::vector<unsigned int>& ctxIds) {
+    for (auto ctxId : ctxIds) {
+      m_Ctx.at(ctxId).freeze();
+    }
+  }
+
+  bool isCtxFrozen(unsigned ctxId) const { return m_Ctx.at(ctxId).isFrozen(); }
+
+  // Current contexts as frozen set, e.g. at the end of a training phase
+  FrozenContexts getFrozenContexts() const { return FrozenContexts(m_Ctx); }
+
+  // Context states for a warm start of the next stream, see exportContexts in contexts.h
+  std::vector<uint16_t> exportContexts() const { return ::exportContexts(m_Ctx); }
+  void importContexts(const std::vector<uint16_t>& words) {
+    m_Ctx = ::importContexts(words);
+#if RWTH_ENABLE_TRACING
+    m_pAndMpsTrace.resize(m_Ctx.size());
+#endif
+  }
+
+  // Estimated bits of coding bin with context ctxId, without updating the context
+  uint32_t estCtxFracBits(unsigned ctxId, unsigned bin) const { return m_Ctx[ctxId].estFracBits(bin); }
+
+  // Estimated bits (in 1 << SCALE_BITS units) of a trial coding pass encodeFn in the bit estimation mode. The trial
+  // changes neither the bitstream, nor the bin storage, nor the running bit estimate, and the contexts
+  // [ctxBegin, ctxEnd) are restored afterwards. encodeFn must not use other contexts.
+  template <typename EncodeFn>
+  uint64_t estimateTrialFracBits(unsigned ctxBegin, unsigned ctxEnd, EncodeFn encodeFn) {
+    m_ctxTrial.assign(m_Ctx.begin() + ctxBegin, m_Ctx.begin() + ctxEnd);
+    const bool bitEstimation = m_bitEstimation;
+    const bool binStorage = m_BinStore.inUse();
+    const uint64_t estFracBits = m_estFracBits;
+    m_BinStore.setUse(false);
+    setBitEstimation(true);
+
+    encodeFn();
+    const uint64_t trialFracBits = m_estFracBits - estFracBits;
+
+    m_BinStore.setUse(binStorage);
+    setBitEstimation(bitEstimation);
+    m_estFracBits = estFracBits;
+    std::copy(m_ctxTrial.begin(), m_ctxTrial.end(), m_Ctx.begin() + ctxBegin);
+    return trialFracBits;
+  }
+
   void writeByteAlignment() { m_Bitstream->writeByteAlignment(); }
 
   std::vector<uint8_t> getBitstream() {
@@ -302,6 +600,9 @@ public:
     return m_pAndMpsTrace;
   }
 #endif
+
+private:
+  std::vector<BinProbModel_Std> m_ctxTrial;  // contexts saved by estimateTrialFracBits
 #endif
 }; // class cabacEncoder 
 
@@ -320,6 +621,13 @@ class cabacTraceEncoder : public cabacEncoder{
       m_pAndMpsTrace[ctxId].push_back(std::make_pair(rcProbModel.getState() >> 1, rcProbModel.mps())); // YOLO
       cabacEncoder::encodeBin(bin, ctxId);
     }
+    void encodeMPSRun(unsigned ctxId, uint64_t runLength)  // bin by bin, such that each bin is traced
+    {
+      const unsigned mps = getMps(ctxId);
+      for (uint64_t i = 0; i < runLength; i++) {
+        encodeBin(mps, ctxId);
+      }
+    }
 
     std::vector<std::list<std::pair<uint16_t, uint8_t>>> getTrace() {
       return m_pAndMpsTrace;
@@ -2,6 +2,7 @@
 #define __RWTH_BINARIZATION_H__
 
 #include "contexts.h"
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 #include <tuple>
@@ -17,7 +18,103 @@ namespace binarization{
         TU = 1,
         EGk = 2,
         NA = 3,
-        RICE = 4
+        RICE = 4,
+        TB = 5,
+        UEGk = 6
+    };
+
+    // Number of leading zeros in the EGk prefix of symbol, i.e. floor(log2(symbol + 2^k)) - k.
+    // Valid for the full 64-bit range: EG0 of 2^64-1 has 64 leading zeros.
+    inline unsigned int getNumLeadZerosEGk(const uint64_t symbol, const unsigned int k) {
+        const uint64_t value = symbol >> k;  // floor((symbol + 2^k) / 2^k) - 1
+        return value == UINT64_MAX ? 64 : floorLog2(value + 1);
+    }
+
+    // Coding of signed symbols
+    enum class SignMode : uint8_t {
+        ZIGZAG = 0,  // 0, -1, 1, -2, 2, ... are coded as 0, 1, 2, 3, 4, ...
+        SIGNBYPASS = 1,  // magnitude, followed by a bypass-coded sign bin for non-zero magnitudes
+        SIGNCONTEXT = 2  // magnitude, followed by a context-coded sign bin for non-zero magnitudes
+    };
+
+    // Unsigned value that is binarized for signed value: zigzag-mapped value or magnitude
+    inline uint64_t getUnsignedValue(const int64_t value, const SignMode signMode) {
+        const uint64_t u = static_cast<uint64_t>(value);
+        if (signMode == SignMode::ZIGZAG) {
+            return (u << 1) ^ (value < 0 ? UINT64_MAX : 0);
+        }
+        return value < 0 ? 0 - u : u;
+    }
+
+    // Inverse of getUnsignedValue, negative is ignored with ZIGZAG
+    inline int64_t getSignedValue(const uint64_t u, const bool negative, const SignMode signMode) {
+        if (signMode == SignMode::ZIGZAG) {
+            return static_cast<int64_t>((u >> 1) ^ (0 - (u & 1)));
+        }
+        return static_cast<int64_t>(negative ? 0 - u : u);
+    }
+
+    // Sign class of a previous symbol for the selection of the sign context: 0 zero, 1 positive, 2 negative
+    inline unsigned int getSignClass(const int64_t value) {
+        return (value > 0) + 2 * (value < 0);
+    }
+
+    // Truncated binary (TB) code of symbols in [0, cMax]: with n = cMax + 1, k = floor(log2(n)) and u = 2^(k+1) - n,
+    // symbols below u are coded with k bins, all others as symbol + u with k+1 bins
+    struct TruncatedBinary {
+        explicit TruncatedBinary(const unsigned int cMax)
+            : k(floorLog2(uint64_t(cMax) + 1)), u((uint64_t(2) << k) - (uint64_t(cMax) + 1)) {}
+
+        unsigned int getNumBins(const uint64_t symbol) const { return symbol < u ? k : k + 1; }
+        uint64_t getCodeword(const uint64_t symbol) const { return symbol < u ? symbol : symbol + u; }
+        // Number of bins of the longest codeword (k for a power-of-two alphabet)
+        unsigned int getNumMaxBins() const { return u == (uint64_t(1) << k) ? k : k + 1; }
+        // Codeword, left-aligned to getNumMaxBins() bins, such that bins at the same position n line up
+        uint64_t getAlignedCodeword(const uint64_t symbol) const {
+            return getCodeword(symbol) << (getNumMaxBins() - getNumBins(symbol));
+        }
+
+        unsigned int k;
+        uint64_t u;
+    };
+
+    // Rice parameter adaptation from running statistics of the coded symbols, as with
+    // persistent_rice_adaptation_enabled_flag in HEVC RExt. The Rice parameter of each statistics set is StatCoeff / 4.
+    // The set of a symbol is selected by the magnitude of the previous symbol, such that the Rice parameter follows
+    // local changes of the symbol magnitudes.
+    class RiceParamAdaptation {
+    public:
+        RiceParamAdaptation(const unsigned int riceParamInit, const unsigned int riceParamMax)
+            : m_statCoeffMax(4 * std::min(riceParamMax, 31u) + 3)
+        {
+            for (unsigned int s = 0; s < RExt__GOLOMB_RICE_ADAPTATION_STATISTICS_SETS; s++) {
+                m_statCoeff[s] = std::min(4 * riceParamInit, m_statCoeffMax);
+            }
+        }
+
+        // Statistics set for a symbol following symbolPrev: 0, 1, 2..3, >=4
+        static unsigned int getSet(const uint64_t symbolPrev) {
+            return symbolPrev == 0 ? 0 : std::min<unsigned int>(floorLog2(symbolPrev) + 1,
+                RExt__GOLOMB_RICE_ADAPTATION_STATISTICS_SETS - 1);
+        }
+
+        unsigned int getRiceParam(const unsigned int set) const {
+            return m_statCoeff[set] / 4;
+        }
+
+        // Update with a coded symbol, see HEVC RExt
+        void update(const unsigned int set, const uint64_t symbol) {
+            const unsigned int riceParam = m_statCoeff[set] / 4;
+            if (symbol >= (uint64_t(3) << riceParam)) {
+                m_statCoeff[set] = std::min(m_statCoeff[set] + 1, m_statCoeffMax);
+            } else if (2 * symbol < (uint64_t(1) << riceParam) && m_statCoeff[set] > 0) {
+                m_statCoeff[set]--;
+            }
+        }
+
+    private:
+        unsigned int m_statCoeff[RExt__GOLOMB_RICE_ADAPTATION_STATISTICS_SETS];
+        unsigned int m_statCoeffMax;
     };
 
 };
@@ -14,6 +14,12 @@ namespace py = pybind11;
 
 void init_pybind_cabac(py::module &m) {
 
+    // Frozen contexts, shared by several encoders/decoders
+    py::class_<FrozenContexts>(m, "FrozenContexts")
+        .def(py::init<const std::vector<std::tuple<double, uint8_t>>&>(), py::arg("initCtx"),
+            "Frozen contexts with probabilities and shift idxs.")
+        .def("__len__", &FrozenContexts::size);
+
     // Encoder
     py::class_<cabacEncoder>(m, "cabacEncoder")
         .def(py::init<>())
@@ -22,17 +28,61 @@ void init_pybind_cabac(py::module &m) {
         .def("encodeBinEP", &cabacEncoder::encodeBinEP)
         .def("encodeBinsEP", &cabacEncoder::encodeBinsEP)
         .def("encodeRemAbsEP", &cabacEncoder::encodeRemAbsEP)
+        .def("encodeRemAbsEPArray", [](cabacEncoder &self, const py::array_t<uint64_t> &symbols,
+            unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            self.encodeRemAbsEPArray(ptr, buf.size, goRicePar, cutoff, maxLog2TrDynamicRange);
+        }, "Encode all symbols with encodeRemAbsEP and a fixed Rice parameter",
+            py::arg("symbols"), py::arg("goRicePar"), py::arg("cutoff"), py::arg("maxLog2TrDynamicRange"))
+        .def("encodeRemAbsEPArray", [](cabacEncoder &self, const py::array_t<uint64_t> &symbols,
+            const py::array_t<unsigned int> &goRicePars, unsigned cutoff, int maxLog2TrDynamicRange
+        ) {
+            auto buf = symbols.request();
+            auto bufRicePars = goRicePars.request();
+            if (bufRicePars.size != buf.size) {
+                throw std::runtime_error("encodeRemAbsEPArray: goRicePars must have one entry per symbol");
+            }
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            unsigned int *ricePars = static_cast<unsigned int *>(bufRicePars.ptr);
+            self.encodeRemAbsEPArray(ptr, buf.size, ricePars, cutoff, maxLog2TrDynamicRange);
+        }, "Encode all symbols with encodeRemAbsEP and Rice parameter goRicePars[i] for symbol i",
+            py::arg("symbols"), py::arg("goRicePars"), py::arg("cutoff"), py::arg("maxLog2TrDynamicRange"))
         .def("encodeBin", &cabacEncoder::encodeBin)
+        .def("encodeMPSRun", &cabacEncoder::encodeMPSRun, "Encode runLength bins equal to the MPS of context ctxId",
+            py::arg("ctxId"), py::arg("runLength"))
+        .def("getMps", &cabacEncoder::getMps)
         .def("encodeBinTrm", &cabacEncoder::encodeBinTrm)
         .def("getBitstream", &cabacEncoder::getBitstream)
         .def("getNumWrittenBits", &cabacEncoder::getNumWrittenBits)
+        .def("setBitEstimation", &cabacEncoder::setBitEstimation,
+            "Estimate the bits (getEstFracBits) instead of writing a bitstream", py::arg("bitEstimation"))
+        .def("isBitEstimation", &cabacEncoder::isBitEstimation)
+        .def("getEstFracBits", &cabacEncoder::getEstFracBits, "Estimated bits in 1 << 15 units since resetBits")
         .def("writeByteAlignment", &cabacEncoder::writeByteAlignment)
         .def("initCtx", static_cast<void (cabacEncoder::*)(std::vector<std::tuple<double, uint8_t>>)>(&cabacEncoder::initCtx), 
             "Initialize contexts with probabilities and shift idxs."
         )
         .def("initCtx", static_cast<void (cabacEncoder::*)(unsigned, double, uint8_t)>(&cabacEncoder::initCtx),
             "Initialize all contexts to same probability and shift idx."
-        );
+        )
+        .def("initCtx", static_cast<void (cabacEncoder::*)(const FrozenContexts&)>(&cabacEncoder::initCtx),
+            "Initialize contexts from a set of frozen contexts."
+        )
+        .def("freezeCtx", static_cast<void (cabacEncoder::*)()>(&cabacEncoder::freezeCtx), "Freeze all contexts.")
+        .def("freezeCtx", static_cast<void (cabacEncoder::*)(const std::vector<unsigned int>&)>(&cabacEncoder::freezeCtx),
+            "Freeze the contexts ctxIds.", py::arg("ctxIds"))
+        .def("isCtxFrozen", &cabacEncoder::isCtxFrozen)
+        .def("getFrozenContexts", &cabacEncoder::getFrozenContexts)
+        .def("exportContexts", [](const cabacEncoder &self) {
+            const std::vector<uint16_t> words = self.exportContexts();
+            return py::array_t<uint16_t>(words.size(), words.data());
+        }, "Context states as uint16 array (3 words per context)")
+        .def("importContexts", [](cabacEncoder &self, const py::array_t<uint16_t, py::array::c_style | py::array::forcecast> &words) {
+            const uint16_t *ptr = words.data();
+            self.importContexts(std::vector<uint16_t>(ptr, ptr + words.size()));
+        }, "Restore context states from exportContexts", py::arg("words"));
     
     // ---------------------------------------------------------------------------------------------------------------------
     // Decoder
@@ -43,7 +93,33 @@ void init_pybind_cabac(py::module &m) {
         .def("decodeBinEP", &cabacDecoder::decodeBinEP)
         .def("decodeBinsEP", &cabacDecoder::decodeBinsEP)
         .def("decodeRemAbsEP", &cabacDecoder::decodeRemAbsEP)
+        .def("decodeRemAbsEPArray", [](cabacDecoder &self, unsigned int numSymbols,
+            unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+            py::buffer_info buf = symbols.request();
+            uint64_t *symbols_ptr = static_cast<uint64_t *>(buf.ptr);
+            self.decodeRemAbsEPArray(symbols_ptr, numSymbols, goRicePar, cutoff, maxLog2TrDynamicRange);
+            return symbols;
+        }, "Decode numSymbols symbols with decodeRemAbsEP and a fixed Rice parameter",
+            py::arg("numSymbols"), py::arg("goRicePar"), py::arg("cutoff"), py::arg("maxLog2TrDynamicRange"))
+        .def("decodeRemAbsEPArray", [](cabacDecoder &self, const py::array_t<unsigned int> &goRicePars,
+            unsigned cutoff, int maxLog2TrDynamicRange
+        ) {
+            auto bufRicePars = goRicePars.request();
+            unsigned int *ricePars = static_cast<unsigned int *>(bufRicePars.ptr);
+            auto symbols = py::array_t<uint64_t>(bufRicePars.size);
+            py::buffer_info buf = symbols.request();
+            uint64_t *symbols_ptr = static_cast<uint64_t *>(buf.ptr);
+            self.decodeRemAbsEPArray(symbols_ptr, bufRicePars.size, ricePars, cutoff, maxLog2TrDynamicRange);
+            return symbols;
+        }, "Decode one symbol per entry of goRicePars with decodeRemAbsEP and Rice parameter goRicePars[i]",
+            py::arg("goRicePars"), py::arg("cutoff"), py::arg("maxLog2TrDynamicRange"))
         .def("decodeBin", &cabacDecoder::decodeBin)
+        .def("decodeMPSRun", &cabacDecoder::decodeMPSRun,
+            "Decode bins equal to the MPS of context ctxId (at most maxRun) and return their number",
+            py::arg("ctxId"), py::arg("maxRun"))
+        .def("getMps", &cabacDecoder::getMps)
         .def("decodeBinTrm", &cabacDecoder::decodeBinTrm)
         .def("getNumBitsRead", &cabacDecoder::getNumBitsRead)
         .def("initCtx", static_cast<void (cabacDecoder::*)(std::vector<std::tuple<double, uint8_t>>)>(&cabacDecoder::initCtx),
@@ -51,13 +127,30 @@ void init_pybind_cabac(py::module &m) {
         )
         .def("initCtx", static_cast<void (cabacDecoder::*)(unsigned, double, uint8_t)>(&cabacDecoder::initCtx),
             "Initialize all contexts to same probability and shift idx."
-        );
+        )
+        .def("initCtx", static_cast<void (cabacDecoder::*)(const FrozenContexts&)>(&cabacDecoder::initCtx),
+            "Initialize contexts from a set of frozen contexts."
+        )
+        .def("freezeCtx", static_cast<void (cabacDecoder::*)()>(&cabacDecoder::freezeCtx), "Freeze all contexts.")
+        .def("freezeCtx", static_cast<void (cabacDecoder::*)(const std::vector<unsigned int>&)>(&cabacDecoder::freezeCtx),
+            "Freeze the contexts ctxIds.", py::arg("ctxIds"))
+        .def("isCtxFrozen", &cabacDecoder::isCtxFrozen)
+        .def("getFrozenContexts", &cabacDecoder::getFrozenContexts)
+        .def("exportContexts", [](const cabacDecoder &self) {
+            const std::vector<uint16_t> words = self.exportContexts();
+            return py::array_t<uint16_t>(words.size(), words.data());
+        }, "Context states as uint16 array (3 words per context)")
+        .def("importContexts", [](cabacDecoder &self, const py::array_t<uint16_t, py::array::c_style | py::array::forcecast> &words) {
+            const uint16_t *ptr = words.data();
+            self.importContexts(std::vector<uint16_t>(ptr, ptr + words.size()));
+        }, "Restore context states from exportContexts", py::arg("words"));
 
     // ---------------------------------------------------------------------------------------------------------------------
     // Encoder with trace enabled
     py::class_<cabacTraceEncoder, cabacEncoder>(m, "cabacTraceEncoder")
         .def(py::init<>())
         .def("encodeBin", &cabacTraceEncoder::encodeBin) // overloaded with tracing enabled
+        .def("encodeMPSRun", &cabacTraceEncoder::encodeMPSRun)
         .def("getTrace", &cabacTraceEncoder::getTrace)
         .def("initCtx", static_cast<void (cabacTraceEncoder::*)(std::vector<std::tuple<double, uint8_t>>)>(&cabacTraceEncoder::initCtx),
             "Initialize contexts with probabilities and shift idxs."
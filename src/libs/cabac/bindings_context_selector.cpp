@@ -11,6 +11,7 @@
 #include "CommonDef.h"
 #include "binarization.h"
 #include "context_selector.h"
+#include "coding_config.h"
 
 namespace py = pybind11;
 
@@ -113,7 +114,14 @@ void init_pybind_context_selector(py::module &m) {
         .value("TU", binarization::BinarizationId::TU)
         .value("EGk", binarization::BinarizationId::EGk)
         .value("NA", binarization::BinarizationId::NA)
-        .value("RICE", binarization::BinarizationId::RICE);
+        .value("RICE", binarization::BinarizationId::RICE)
+        .value("TB", binarization::BinarizationId::TB)
+        .value("UEGk", binarization::BinarizationId::UEGk);
+
+    py::enum_<binarization::SignMode>(m, "SignMode")
+        .value("ZIGZAG", binarization::SignMode::ZIGZAG)
+        .value("SIGNBYPASS", binarization::SignMode::SIGNBYPASS)
+        .value("SIGNCONTEXT", binarization::SignMode::SIGNCONTEXT);
 
     py::enum_<contextSelector::ContextModelId>(m, "ContextModelId")
         .value("BAC", contextSelector::ContextModelId::BAC)
@@ -125,4 +133,33 @@ void init_pybind_context_selector(py::module &m) {
         .value("BINSORDERNSYMBOLPOSITION", contextSelector::ContextModelId::BINSORDERNSYMBOLPOSITION)
         .value("SYMBOLORDERNSYMBOLPOSITION", contextSelector::ContextModelId::SYMBOLORDERNSYMBOLPOSITION);
 
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Coding configuration, validated once and reusable for several encodeSymbols/decodeSymbols calls
+    py::class_<CodingConfig>(m, "CodingConfig")
+        .def(py::init<binarization::BinarizationId, contextSelector::ContextModelId,
+            const std::vector<unsigned int>&, const std::vector<unsigned int>&>(),
+            py::arg("binId"), py::arg("ctxModelId"), py::arg("binParams"), py::arg("ctxParams"))
+        .def(py::init<binarization::BinarizationId, const std::vector<unsigned int>&>(),
+            py::arg("binId"), py::arg("binParams"))
+        .def_readonly("binId", &CodingConfig::binId)
+        .def_readonly("ctxModelId", &CodingConfig::ctxModelId)
+        .def_readonly("binParams", &CodingConfig::binParams)
+        .def_readonly("ctxParams", &CodingConfig::ctxParams)
+        .def_readonly("bypass", &CodingConfig::bypass)
+        .def_readonly("numMaxPrefixBins", &CodingConfig::numMaxPrefixBins)
+        .def_readonly("maxSymbolRICE", &CodingConfig::maxSymbolRICE)
+        .def_readonly("numContexts", &CodingConfig::numContexts)
+        .def("getSymbolPositionContextOffset", &CodingConfig::getSymbolPositionContextOffset, py::arg("d"))
+        .def_readonly_static("numSignContexts", &CodingConfig::numSignContexts)
+        .def("getSignContextId", &CodingConfig::getSignContextId, py::arg("signClassPrev"));
+
+    // Candidate configurations for per-block switching, see encodeSymbolsBlockSwitching
+    py::class_<BlockSwitchingConfig>(m, "BlockSwitchingConfig")
+        .def(py::init<const std::vector<CodingConfig>&, unsigned int>(), py::arg("candidates"), py::arg("blockSize"))
+        .def_readonly("candidates", &BlockSwitchingConfig::candidates)
+        .def_readonly("blockSize", &BlockSwitchingConfig::blockSize)
+        .def_readonly("ctxIdSelect", &BlockSwitchingConfig::ctxIdSelect)
+        .def_readonly("numContexts", &BlockSwitchingConfig::numContexts)
+        .def_readonly_static("maxNumCandidates", &BlockSwitchingConfig::maxNumCandidates);
+
 }  // init_pybind_context_selector
\ No newline at end of file
@@ -11,10 +11,70 @@
 #include "CommonDef.h"
 #include "binarization.h"
 #include "context_selector.h"
+#include "coding_config.h"
+#include "prediction.h"
+#include "remapping.h"
+#include "transform.h"
+#include "multi_symbol_coder.h"
+#include "rans_coder.h"
+#include "context_training.h"
+#include "autotune.h"
 
 namespace py = pybind11;
 
+// Signed symbols are passed with their own integer type (int8 ... int64), such that no conversion pass is needed.
+// Unsigned symbols (uint8 ... uint64) are coded as signed symbols of the same width (TArray is the unsigned type,
+// T the signed one), which is lossless and, with a predictor, gives the same residuals (see prediction::Predictor).
+template <typename TArray, typename T>
+static void encodeSymbolsSignedTyped(cabacSimpleSequenceEncoder &self, const py::array &symbols,
+    const CodingConfig &config, binarization::SignMode signMode, const prediction::Predictor &predictor
+) {
+    auto symbolsContiguous = py::array_t<TArray, py::array::c_style>::ensure(symbols);
+    if (!symbolsContiguous) {
+        throw std::runtime_error("encodeSymbolsSigned: Conversion of symbols failed");
+    }
+    auto buf = symbolsContiguous.request();
+    self.encodeSymbolsSigned(static_cast<const T *>(buf.ptr), buf.size, config, signMode, predictor);
+}
+
+template <typename TArray, typename T>
+static py::array decodeSymbolsSignedTyped(cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+    const CodingConfig &config, binarization::SignMode signMode, const prediction::Predictor &predictor
+) {
+    auto symbols = py::array_t<TArray>(numSymbols);
+    py::buffer_info buf = symbols.request();
+    self.decodeSymbolsSigned(static_cast<T *>(buf.ptr), numSymbols, config, signMode, predictor);
+    return symbols;
+}
+
 void init_pybind_sequence_coding(py::module &m) {
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Prediction
+    py::enum_<prediction::PredictorId>(m, "PredictorId")
+        .value("NONE", prediction::PredictorId::NONE)
+        .value("PREVIOUS", prediction::PredictorId::PREVIOUS)
+        .value("LINEAR", prediction::PredictorId::LINEAR);
+
+    py::class_<prediction::Predictor>(m, "Predictor")
+        .def(py::init<prediction::PredictorId, unsigned int>(), py::arg("predictorId")=prediction::PredictorId::NONE,
+            py::arg("lag")=1)
+        .def_readonly("predictorId", &prediction::Predictor::predictorId)
+        .def_readonly("lag", &prediction::Predictor::lag);
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Remapping
+    py::enum_<remapping::RemapperId>(m, "RemapperId")
+        .value("NONE", remapping::RemapperId::NONE)
+        .value("FREQUENCY", remapping::RemapperId::FREQUENCY)
+        .value("MTF", remapping::RemapperId::MTF);
+
+    py::class_<remapping::SymbolRemapper>(m, "SymbolRemapper")
+        .def(py::init<remapping::RemapperId, unsigned int>(), py::arg("remapperId")=remapping::RemapperId::NONE,
+            py::arg("alphabetSize")=0)
+        .def("reset", &remapping::SymbolRemapper::reset)
+        .def_readonly("remapperId", &remapping::SymbolRemapper::remapperId)
+        .def_readonly("alphabetSize", &remapping::SymbolRemapper::alphabetSize);
+
     // ---------------------------------------------------------------------------------------------------------------------
     // SequenceEncoder
     py::class_<cabacSimpleSequenceEncoder, cabacSymbolEncoder>(m, "cabacSimpleSequenceEncoder")
@@ -26,6 +86,13 @@ void init_pybind_sequence_coding(py::module &m) {
             uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
             self.encodeSymbolsBypass(ptr, buf.size, binId, binParams);
         })
+        .def("encodeSymbolsBypassAligned", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            binarization::BinarizationId binId, const std::vector<unsigned int> binParams
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            self.encodeSymbolsBypassAligned(ptr, buf.size, binId, binParams);
+        })
         .def("encodeSymbols", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
             binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId,
             const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams
@@ -34,6 +101,91 @@ void init_pybind_sequence_coding(py::module &m) {
             uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
             self.encodeSymbols(ptr, buf.size, binId, ctxModelId, binParams, ctxParams);
         })
+        .def("encodeSymbolsPrecomputed", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId,
+            const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams, unsigned int numThreads
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            self.encodeSymbolsPrecomputed(ptr, buf.size, binId, ctxModelId, binParams, ctxParams, numThreads);
+        }, "Same as encodeSymbols, but with context IDs precomputed in parallel (numThreads=0 uses all cores)",
+            py::arg("symbols"), py::arg("binId"), py::arg("ctxModelId"), py::arg("binParams"), py::arg("ctxParams"),
+            py::arg("numThreads")=0)
+        .def("encodeSymbols", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            const CodingConfig &config
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            if (config.bypass) {
+                self.encodeSymbolsBypass(ptr, buf.size, config);
+            } else {
+                self.encodeSymbols(ptr, buf.size, config);
+            }
+        }, "Encode symbols with a CodingConfig (bypass or context-adaptive)", py::arg("symbols"), py::arg("config"))
+        .def("encodeSymbolsRemapped", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            const CodingConfig &config, remapping::SymbolRemapper &remapper
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            self.encodeSymbolsRemapped(ptr, buf.size, config, remapper);
+        }, "Encode the ranks of the symbols under the adaptive remapper (bypass or context-adaptive). The remapper "
+            "state carries over to subsequent calls.", py::arg("symbols"), py::arg("config"), py::arg("remapper"))
+        .def("encodeSymbolsEquality", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            const CodingConfig &flagConfig, const CodingConfig &valueConfig
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            self.encodeSymbolsEquality(ptr, buf.size, flagConfig, valueConfig);
+        }, "Equality coding: flags (symbol equals the previous symbol) and values of the other symbols as sub-streams",
+            py::arg("symbols"), py::arg("flagConfig"), py::arg("valueConfig"))
+        .def("encodeSymbolsRunLength", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            uint64_t guard, const CodingConfig &valueConfig, const CodingConfig &lengthConfig
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            self.encodeSymbolsRunLength(ptr, buf.size, guard, valueConfig, lengthConfig);
+        }, "Run-length coding: values and run lengths (in [0, guard], guard=0 for no limit) as sub-streams",
+            py::arg("symbols"), py::arg("guard"), py::arg("valueConfig"), py::arg("lengthConfig"))
+        .def("encodeSymbolsMatch", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            unsigned int windowSize, const CodingConfig &lengthConfig, const CodingConfig &offsetConfig,
+            const CodingConfig &literalConfig
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            self.encodeSymbolsMatch(ptr, buf.size, windowSize, lengthConfig, offsetConfig, literalConfig);
+        }, "LZ-like match coding against the previous windowSize symbols: match lengths, offsets and literals as "
+            "sub-streams", py::arg("symbols"), py::arg("windowSize"), py::arg("lengthConfig"), py::arg("offsetConfig"),
+            py::arg("literalConfig"))
+        .def("encodeSymbolsBlockSwitching", [](cabacSimpleSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            const BlockSwitchingConfig &blockConfig
+        ) {
+            auto buf = symbols.request();
+            uint64_t *ptr = static_cast<uint64_t *>(buf.ptr);
+            return self.encodeSymbolsBlockSwitching(ptr, buf.size, blockConfig);
+        }, "Encode symbols block-wise with the candidate of blockConfig with the fewest estimated bits. Returns the "
+            "selected candidate per block.", py::arg("symbols"), py::arg("blockConfig"))
+        .def("encodeSymbolsSigned", [](cabacSimpleSequenceEncoder &self, const py::array &symbols,
+            const CodingConfig &config, binarization::SignMode signMode, const prediction::Predictor &predictor
+        ) {
+            const char kind = symbols.dtype().kind();
+            if (kind != 'i' && kind != 'u') {
+                throw std::runtime_error("encodeSymbolsSigned: Integer array required");
+            }
+            switch (symbols.itemsize()) {
+                case 1: kind == 'i' ? encodeSymbolsSignedTyped<int8_t, int8_t>(self, symbols, config, signMode, predictor) :
+                    encodeSymbolsSignedTyped<uint8_t, int8_t>(self, symbols, config, signMode, predictor); break;
+                case 2: kind == 'i' ? encodeSymbolsSignedTyped<int16_t, int16_t>(self, symbols, config, signMode, predictor) :
+                    encodeSymbolsSignedTyped<uint16_t, int16_t>(self, symbols, config, signMode, predictor); break;
+                case 4: kind == 'i' ? encodeSymbolsSignedTyped<int32_t, int32_t>(self, symbols, config, signMode, predictor) :
+                    encodeSymbolsSignedTyped<uint32_t, int32_t>(self, symbols, config, signMode, predictor); break;
+                case 8: kind == 'i' ? encodeSymbolsSignedTyped<int64_t, int64_t>(self, symbols, config, signMode, predictor) :
+                    encodeSymbolsSignedTyped<uint64_t, int64_t>(self, symbols, config, signMode, predictor); break;
+                default:
+                    throw std::runtime_error("encodeSymbolsSigned: Unsupported integer size");
+            }
+        }, "Encode integer symbols (int8 ... int64, uint8 ... uint64) with a CodingConfig, see SignMode. "
+            "With a predictor, the prediction residuals are coded instead of the symbols.",
+            py::arg("symbols"), py::arg("config"), py::arg("signMode"), py::arg("predictor")=prediction::Predictor())
         .def("encodeSymbolBypass", [](cabacSimpleSequenceEncoder &self, const uint64_t symbol,
             binarization::BinarizationId binId, const std::vector<unsigned int> binParams
         ) {
@@ -73,6 +225,18 @@ void init_pybind_sequence_coding(py::module &m) {
 
             return symbols;
         })
+        .def("decodeSymbolsBypassAligned", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            binarization::BinarizationId binId, const std::vector<unsigned int> binParams
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+
+            py::buffer_info buf = symbols.request();
+            uint64_t *symbols_ptr = static_cast<uint64_t *>(buf.ptr);
+
+            self.decodeSymbolsBypassAligned(symbols_ptr, numSymbols, binId, binParams);
+
+            return symbols;
+        })
         .def("decodeSymbols", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
             binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId,
             const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams
@@ -87,6 +251,89 @@ void init_pybind_sequence_coding(py::module &m) {
 
             return symbols;
         })
+        .def("decodeSymbols", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            const CodingConfig &config
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+
+            py::buffer_info buf = symbols.request();
+            uint64_t *symbols_ptr = static_cast<uint64_t *>(buf.ptr);
+
+            if (config.bypass) {
+                self.decodeSymbolsBypass(symbols_ptr, numSymbols, config);
+            } else {
+                self.decodeSymbols(symbols_ptr, numSymbols, config);
+            }
+
+            return symbols;
+        }, "Decode symbols with a CodingConfig (bypass or context-adaptive)", py::arg("numSymbols"), py::arg("config"))
+        .def("decodeSymbolsRemapped", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            const CodingConfig &config, remapping::SymbolRemapper &remapper
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+
+            py::buffer_info buf = symbols.request();
+            uint64_t *symbols_ptr = static_cast<uint64_t *>(buf.ptr);
+
+            self.decodeSymbolsRemapped(symbols_ptr, numSymbols, config, remapper);
+
+            return symbols;
+        }, "Decode symbols written by encodeSymbolsRemapped, with a remapper in the same initial state",
+            py::arg("numSymbols"), py::arg("config"), py::arg("remapper"))
+        .def("decodeSymbolsEquality", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            const CodingConfig &flagConfig, const CodingConfig &valueConfig
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+            self.decodeSymbolsEquality(static_cast<uint64_t *>(symbols.request().ptr), numSymbols, flagConfig, valueConfig);
+            return symbols;
+        }, py::arg("numSymbols"), py::arg("flagConfig"), py::arg("valueConfig"))
+        .def("decodeSymbolsRunLength", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            uint64_t guard, const CodingConfig &valueConfig, const CodingConfig &lengthConfig
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+            self.decodeSymbolsRunLength(static_cast<uint64_t *>(symbols.request().ptr), numSymbols, guard, valueConfig,
+                lengthConfig);
+            return symbols;
+        }, py::arg("numSymbols"), py::arg("guard"), py::arg("valueConfig"), py::arg("lengthConfig"))
+        .def("decodeSymbolsMatch", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            const CodingConfig &lengthConfig, const CodingConfig &offsetConfig, const CodingConfig &literalConfig
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+            self.decodeSymbolsMatch(static_cast<uint64_t *>(symbols.request().ptr), numSymbols, lengthConfig,
+                offsetConfig, literalConfig);
+            return symbols;
+        }, py::arg("numSymbols"), py::arg("lengthConfig"), py::arg("offsetConfig"), py::arg("literalConfig"))
+        .def("decodeSymbolsBlockSwitching", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            const BlockSwitchingConfig &blockConfig
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+            self.decodeSymbolsBlockSwitching(static_cast<uint64_t *>(symbols.request().ptr), numSymbols, blockConfig);
+            return symbols;
+        }, py::arg("numSymbols"), py::arg("blockConfig"))
+        .def("decodeSymbolsSigned", [](cabacSimpleSequenceDecoder &self, unsigned int numSymbols,
+            const CodingConfig &config, binarization::SignMode signMode, const py::dtype &dtype,
+            const prediction::Predictor &predictor
+        ) {
+            const char kind = dtype.kind();
+            if (kind != 'i' && kind != 'u') {
+                throw std::runtime_error("decodeSymbolsSigned: Integer dtype required");
+            }
+            switch (dtype.itemsize()) {
+                case 1: return kind == 'i' ? decodeSymbolsSignedTyped<int8_t, int8_t>(self, numSymbols, config, signMode, predictor) :
+                    decodeSymbolsSignedTyped<uint8_t, int8_t>(self, numSymbols, config, signMode, predictor);
+                case 2: return kind == 'i' ? decodeSymbolsSignedTyped<int16_t, int16_t>(self, numSymbols, config, signMode, predictor) :
+                    decodeSymbolsSignedTyped<uint16_t, int16_t>(self, numSymbols, config, signMode, predictor);
+                case 4: return kind == 'i' ? decodeSymbolsSignedTyped<int32_t, int32_t>(self, numSymbols, config, signMode, predictor) :
+                    decodeSymbolsSignedTyped<uint32_t, int32_t>(self, numSymbols, config, signMode, predictor);
+                case 8: return kind == 'i' ? decodeSymbolsSignedTyped<int64_t, int64_t>(self, numSymbols, config, signMode, predictor) :
+                    decodeSymbolsSignedTyped<uint64_t, int64_t>(self, numSymbols, config, signMode, predictor);
+                default:
+                    throw std::runtime_error("decodeSymbolsSigned: Unsupported integer size");
+            }
+        }, "Decode integer symbols with a CodingConfig into an array of dtype (int8 ... int64, uint8 ... uint64), "
+            "see SignMode. With a predictor, the symbols are reconstructed from the decoded residuals.",
+            py::arg("numSymbols"), py::arg("config"), py::arg("signMode"), py::arg("dtype")=py::dtype::of<int64_t>(),
+            py::arg("predictor")=prediction::Predictor())
         .def("decodeSymbolBypass", [](cabacSimpleSequenceDecoder &self, 
             binarization::BinarizationId binId, const std::vector<unsigned int> binParams
         ) {
@@ -113,4 +360,135 @@ void init_pybind_sequence_coding(py::module &m) {
             return self.decodeSymbol(0, ptr, binId, ctxModelId, binParams, ctxParams);
         });
 
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Multi-symbol backend
+    py::class_<multiSymbol::CdfAdaptation>(m, "CdfAdaptation")
+        .def(py::init<unsigned int, unsigned int, unsigned int>(), py::arg("rateInit")=5, py::arg("rateFinal")=7,
+            py::arg("countPerStep")=16)
+        .def_readonly("rateInit", &multiSymbol::CdfAdaptation::rateInit)
+        .def_readonly("rateFinal", &multiSymbol::CdfAdaptation::rateFinal)
+        .def_readonly("countPerStep", &multiSymbol::CdfAdaptation::countPerStep);
+
+    py::class_<multiSymbol::Config>(m, "MultiSymbolConfig")
+        .def(py::init<unsigned int, unsigned int, unsigned int>(), py::arg("alphabetSize"), py::arg("order")=0,
+            py::arg("ctxOffset")=0)
+        .def_readonly("alphabetSize", &multiSymbol::Config::alphabetSize)
+        .def_readonly("order", &multiSymbol::Config::order)
+        .def_readonly("ctxOffset", &multiSymbol::Config::ctxOffset)
+        .def_readonly("numContexts", &multiSymbol::Config::numContexts);
+
+    py::class_<multiSymbolSequenceEncoder>(m, "multiSymbolSequenceEncoder")
+        .def(py::init<>())
+        .def("initCtx", &multiSymbolSequenceEncoder::initCtx, py::arg("numContexts"), py::arg("alphabetSize"),
+            py::arg("adaptation")=multiSymbol::CdfAdaptation())
+        .def("start", &multiSymbolSequenceEncoder::start)
+        .def("finish", &multiSymbolSequenceEncoder::finish)
+        .def("getBitstream", &multiSymbolSequenceEncoder::getBitstream)
+        .def("encodeSymbols", [](multiSymbolSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            const multiSymbol::Config &config
+        ) {
+            auto buf = symbols.request();
+            self.encodeSymbols(static_cast<uint64_t *>(buf.ptr), buf.size, config);
+        }, py::arg("symbols"), py::arg("config"));
+
+    py::class_<multiSymbolSequenceDecoder>(m, "multiSymbolSequenceDecoder")
+        .def(py::init<std::vector<uint8_t>>())
+        .def("initCtx", &multiSymbolSequenceDecoder::initCtx, py::arg("numContexts"), py::arg("alphabetSize"),
+            py::arg("adaptation")=multiSymbol::CdfAdaptation())
+        .def("start", &multiSymbolSequenceDecoder::start)
+        .def("finish", &multiSymbolSequenceDecoder::finish)
+        .def("decodeSymbols", [](multiSymbolSequenceDecoder &self, unsigned int numSymbols,
+            const multiSymbol::Config &config
+        ) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+            self.decodeSymbols(static_cast<uint64_t *>(symbols.request().ptr), numSymbols, config);
+            return symbols;
+        }, py::arg("numSymbols"), py::arg("config"));
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // rANS backend
+    py::class_<rans::Config>(m, "RansConfig")
+        .def(py::init<unsigned int, unsigned int, const std::vector<uint64_t>&>(), py::arg("alphabetSize"),
+            py::arg("numStates")=4, py::arg("staticFreqs")=std::vector<uint64_t>())
+        .def_readonly("alphabetSize", &rans::Config::alphabetSize)
+        .def_readonly("numStates", &rans::Config::numStates)
+        .def_readonly("freqs", &rans::Config::freqs);
+
+    py::class_<ransSequenceEncoder>(m, "ransSequenceEncoder")
+        .def(py::init<>())
+        .def("start", &ransSequenceEncoder::start)
+        .def("finish", &ransSequenceEncoder::finish)
+        .def("getBitstream", &ransSequenceEncoder::getBitstream)
+        .def("encodeSymbols", [](ransSequenceEncoder &self, const py::array_t<uint64_t> &symbols,
+            const rans::Config &config
+        ) {
+            auto buf = symbols.request();
+            self.encodeSymbols(static_cast<uint64_t *>(buf.ptr), buf.size, config);
+        }, py::arg("symbols"), py::arg("config"));
+
+    py::class_<ransSequenceDecoder>(m, "ransSequenceDecoder")
+        .def(py::init<std::vector<uint8_t>>())
+        .def("start", &ransSequenceDecoder::start)
+        .def("finish", &ransSequenceDecoder::finish)
+        .def("decodeSymbols", [](ransSequenceDecoder &self, unsigned int numSymbols, const rans::Config &config) {
+            auto symbols = py::array_t<uint64_t>(numSymbols);
+            self.decodeSymbols(static_cast<uint64_t *>(symbols.request().ptr), numSymbols, config);
+            return symbols;
+        }, py::arg("numSymbols"), py::arg("config"));
+
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Context initialization training
+    m.def("trainContextInit", [](const std::vector<py::array_t<uint64_t, py::array::c_style | py::array::forcecast>> &samples,
+        const CodingConfig &config, unsigned int numThreads, unsigned int numProbs, size_t maxNumBins
+    ) {
+        std::vector<std::vector<uint64_t>> sampleVectors;
+        for (const auto &sample : samples) {
+            sampleVectors.emplace_back(sample.data(), sample.data() + sample.size());
+        }
+        py::gil_scoped_release release;
+        return contextTraining::trainContextInit(sampleVectors, config, numThreads, numProbs, maxNumBins);
+    }, "Best initCtx list (p1, shiftIdx) per context for the samples coded with config (entry i for context "
+        "config.ctxOffset + i), using at most maxNumBins bins per context and sample", py::arg("samples"), py::arg("config"), py::arg("numThreads")=0,
+        py::arg("numProbs")=64, py::arg("maxNumBins")=BinStore::defaultMaxNumBins);
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Auto-tuning
+    py::class_<autotune::SearchSpace>(m, "SearchSpace")
+        .def(py::init<>())
+        .def_readwrite("binIds", &autotune::SearchSpace::binIds)
+        .def_readwrite("ctxModelIds", &autotune::SearchSpace::ctxModelIds)
+        .def_readwrite("orders", &autotune::SearchSpace::orders)
+        .def_readwrite("restPos", &autotune::SearchSpace::restPos)
+        .def_readwrite("symbolMax", &autotune::SearchSpace::symbolMax)
+        .def_readwrite("k", &autotune::SearchSpace::k)
+        .def_readwrite("cutoffs", &autotune::SearchSpace::cutoffs)
+        .def_readwrite("bypass", &autotune::SearchSpace::bypass)
+        .def_readwrite("maxSymbolTU", &autotune::SearchSpace::maxSymbolTU)
+        .def("getCandidates", &autotune::SearchSpace::getCandidates, py::arg("maxSymbol"));
+
+    py::class_<autotune::Result>(m, "AutotuneResult")
+        .def_readonly("config", &autotune::Result::config)
+        .def_readonly("bitsPerSymbol", &autotune::Result::bitsPerSymbol)
+        .def_readonly("symbolsPerSecond", &autotune::Result::symbolsPerSecond);
+
+    m.def("autotune", [](const py::array_t<uint64_t, py::array::c_style | py::array::forcecast> &symbols,
+        const autotune::SearchSpace &searchSpace, unsigned int numThreads
+    ) {
+        const uint64_t *ptr = symbols.data();
+        const unsigned int numSymbols = static_cast<unsigned int>(symbols.size());
+        py::gil_scoped_release release;
+        return autotune::autotune(ptr, numSymbols, searchSpace, numThreads);
+    }, "Candidate configurations of searchSpace ranked by estimated bits per symbol",
+        py::arg("symbols"), py::arg("searchSpace")=autotune::SearchSpace(), py::arg("numThreads")=0);
+    m.def("autotune", [](const py::array_t<uint64_t, py::array::c_style | py::array::forcecast> &symbols,
+        const std::vector<CodingConfig> &candidates, unsigned int numThreads, double p1Init, uint8_t shiftIdx
+    ) {
+        const uint64_t *ptr = symbols.data();
+        const unsigned int numSymbols = static_cast<unsigned int>(symbols.size());
+        py::gil_scoped_release release;
+        return autotune::autotune(ptr, numSymbols, candidates, numThreads, p1Init, shiftIdx);
+    }, "Candidate configurations ranked by estimated bits per symbol",
+        py::arg("symbols"), py::arg("candidates"), py::arg("numThreads")=0, py::arg("p1Init")=0.5,
+        py::arg("shiftIdx")=8);
 }  // init_pybind_sequence_coding
\ No newline at end of file
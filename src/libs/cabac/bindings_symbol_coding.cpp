@@ -75,6 +75,41 @@ void init_pybind_symbol_coding(py::module &m) {
         })
         .def("encodeBinsEGk", [](cabacSymbolEncoder &self, uint64_t symbol, const unsigned int k,  CtxFunction &ctxFun) {
             self.encodeBinsEGk(symbol, k, ctxFun);
+        })
+        .def("encodeBinsRICE", [](cabacSymbolEncoder &self, uint64_t symbol, const py::array_t<unsigned int>& ctxIdsNumpy,
+            const unsigned int riceParam, const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+
+            auto buf = ctxIdsNumpy.request();
+            unsigned int *ptr = static_cast<unsigned int *>(buf.ptr);
+            self.encodeBinsRICE(symbol, ptr, riceParam, cutoff, maxLog2TrDynamicRange);
+        })
+        .def("encodeBinsRICE", [](cabacSymbolEncoder &self, uint64_t symbol, CtxFunction &ctxFun,
+            const unsigned int riceParam, const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+            self.encodeBinsRICE(symbol, ctxFun, riceParam, cutoff, maxLog2TrDynamicRange);
+        })
+        .def("encodeBinsTBbypass", static_cast<void (cabacSymbolEncoder::*)(uint64_t, const unsigned int)>(&cabacSymbolEncoder::encodeBinsTBbypass),
+            "bypass-encode TB-binarized symbol in [0, cMax]", py::arg("symbol"), py::arg("cMax"))
+        .def("encodeBinsTB", [](cabacSymbolEncoder &self, uint64_t symbol, const py::array_t<unsigned int>& ctxIdsNumpy, const unsigned int cMax) {
+
+            auto buf = ctxIdsNumpy.request();
+            unsigned int *ptr = static_cast<unsigned int *>(buf.ptr);
+            self.encodeBinsTB(symbol, ptr, cMax);
+        })
+        .def("encodeBinsTB", [](cabacSymbolEncoder &self, uint64_t symbol, CtxFunction &ctxFun, const unsigned int cMax) {
+            self.encodeBinsTB(symbol, ctxFun, cMax);
+        })
+        .def("encodeBinsUEGkbypass", static_cast<void (cabacSymbolEncoder::*)(uint64_t, const unsigned int, const unsigned int)>(&cabacSymbolEncoder::encodeBinsUEGkbypass),
+            "bypass-encode UEGk-binarized symbol", py::arg("symbol"), py::arg("cutoff"), py::arg("k"))
+        .def("encodeBinsUEGk", [](cabacSymbolEncoder &self, uint64_t symbol, const py::array_t<unsigned int>& ctxIdsNumpy,
+            const unsigned int cutoff, const unsigned int k) {
+
+            auto buf = ctxIdsNumpy.request();
+            unsigned int *ptr = static_cast<unsigned int *>(buf.ptr);
+            self.encodeBinsUEGk(symbol, ptr, cutoff, k);
+        })
+        .def("encodeBinsUEGk", [](cabacSymbolEncoder &self, uint64_t symbol, CtxFunction &ctxFun,
+            const unsigned int cutoff, const unsigned int k) {
+            self.encodeBinsUEGk(symbol, ctxFun, cutoff, k);
         });
 
     // ---------------------------------------------------------------------------------------------------------------------
@@ -112,6 +147,41 @@ void init_pybind_symbol_coding(py::module &m) {
         })
         .def("decodeBinsEGk", [](cabacSymbolDecoder &self, const unsigned int k, CtxFunction &ctxFun) {
             return self.decodeBinsEGk(k, ctxFun);
+        })
+        .def("decodeBinsRICE", [](cabacSymbolDecoder &self, const py::array_t<unsigned int>& ctxIdsNumpy,
+            const unsigned int riceParam, const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+
+            auto buf = ctxIdsNumpy.request();
+            unsigned int *ptr = static_cast<unsigned int *>(buf.ptr);
+            return self.decodeBinsRICE(ptr, riceParam, cutoff, maxLog2TrDynamicRange);
+        })
+        .def("decodeBinsRICE", [](cabacSymbolDecoder &self, CtxFunction &ctxFun,
+            const unsigned int riceParam, const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+            return self.decodeBinsRICE(ctxFun, riceParam, cutoff, maxLog2TrDynamicRange);
+        })
+        .def("decodeBinsTBbypass", static_cast<uint64_t (cabacSymbolDecoder::*)(const unsigned int)>(&cabacSymbolDecoder::decodeBinsTBbypass),
+            "bypass-decode TB-binarized symbol in [0, cMax]", py::arg("cMax"))
+        .def("decodeBinsTB", [](cabacSymbolDecoder &self, const py::array_t<unsigned int>& ctxIdsNumpy, const unsigned int cMax) {
+
+            auto buf = ctxIdsNumpy.request();
+            unsigned int *ptr = static_cast<unsigned int *>(buf.ptr);
+            return self.decodeBinsTB(ptr, cMax);
+        })
+        .def("decodeBinsTB", [](cabacSymbolDecoder &self, CtxFunction &ctxFun, const unsigned int cMax) {
+            return self.decodeBinsTB(ctxFun, cMax);
+        })
+        .def("decodeBinsUEGkbypass", static_cast<uint64_t (cabacSymbolDecoder::*)(const unsigned int, const unsigned int)>(&cabacSymbolDecoder::decodeBinsUEGkbypass),
+            "bypass-decode UEGk-binarized symbol", py::arg("cutoff"), py::arg("k"))
+        .def("decodeBinsUEGk", [](cabacSymbolDecoder &self, const py::array_t<unsigned int>& ctxIdsNumpy,
+            const unsigned int cutoff, const unsigned int k) {
+
+            auto buf = ctxIdsNumpy.request();
+            unsigned int *ptr = static_cast<unsigned int *>(buf.ptr);
+            return self.decodeBinsUEGk(ptr, cutoff, k);
+        })
+        .def("decodeBinsUEGk", [](cabacSymbolDecoder &self, CtxFunction &ctxFun,
+            const unsigned int cutoff, const unsigned int k) {
+            return self.decodeBinsUEGk(ctxFun, cutoff, k);
         });
 
 }  // init_pybind_symbol_coding
\ No newline at end of file
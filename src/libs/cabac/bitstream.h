@@ -71,6 +71,15 @@ class OutputBitstream {
      */
     void write(uint32_t uiBits, uint32_t uiNumberOfBits);
 
+    /** append a byte, with a shortcut for a byte-aligned bitstream */
+    void writeByte(uint32_t uiByte) {
+        if (m_num_held_bits == 0) {
+            m_fifo.push_back(uint8_t(uiByte));
+        } else {
+            write(uiByte, 8);
+        }
+    }
+
     /** insert one bits until the bitstream is byte-aligned */
     void writeAlignOne();
 
@@ -173,6 +182,10 @@ class InputBitstream {
     uint8_t getHeldBits() { return m_held_bits; }
     OutputBitstream& operator=(const OutputBitstream& src);
     uint32_t getByteLocation() { return m_fifo_idx; }
+    // Byte at offset from the current read position, without reading it (0 beyond the end of the FIFO)
+    uint32_t peekByte(uint32_t offset) const {
+        return m_fifo_idx + offset < m_fifo.size() ? m_fifo[m_fifo_idx + offset] : 0;
+    }
 
     // Peek at bits in word-storage. Used in determining if we have completed reading of current bitstream and therefore
     // slice in LCEC.
@@ -0,0 +1,196 @@
+#include "coding_config.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+#if RWTH_PYTHON_IF
+const unsigned int CodingConfig::numSignContexts;
+const unsigned int BlockSwitchingConfig::maxNumCandidates;
+
+// ---------------------------------------------------------------------------------------------------------------------
+CodingConfig::CodingConfig(const binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId,
+  const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams
+) : binId(binId), ctxModelId(ctxModelId), binParams(binParams), ctxParams(ctxParams), bypass(false),
+  numMaxBins(0), k(0), riceParam(0), cutoff(0), maxLog2TrDynamicRange(0), numMaxPrefixBins(0), maxSymbolRICE(0),
+  order(0), restPos(0), ctxOffset(0), symbolMax(0), symbolPosMode(0), symbolPosIdx{0, 0, 0},
+  ctxModelId0(contextSelector::getBaseContextModelId(ctxModelId)), symbolPosition(false),
+  numContexts0(0), numContexts(0), ctxIdRest(0)
+{
+  switch (binId) {
+    case binarization::BinarizationId::BI:
+    case binarization::BinarizationId::TU:
+    case binarization::BinarizationId::EGk:
+    case binarization::BinarizationId::RICE:
+    case binarization::BinarizationId::TB:
+    case binarization::BinarizationId::UEGk:
+      break;
+    case binarization::BinarizationId::NA:
+      throw std::runtime_error("CodingConfig: Binarization not supported with context-adaptive coding");
+    default:
+      throw std::runtime_error("CodingConfig: Unknown binarization ID");
+  }
+  parseBinParams();
+
+  // Context model parameters
+  symbolPosition = ctxModelId0 != ctxModelId;
+  unsigned int numCtxParams = 3;
+  if (ctxModelId0 == contextSelector::ContextModelId::SYMBOLORDERN || symbolPosition) {
+    numCtxParams = 4;
+  }
+  if (symbolPosition) {
+    numCtxParams = 5;
+    if (ctxParams.size() > 4 && ctxParams[4] == 1) {
+      numCtxParams = 8;
+    }
+  }
+  if (ctxParams.size() < numCtxParams) {
+    throw std::runtime_error("CodingConfig: Context model requires " + std::to_string(numCtxParams) + " ctxParams");
+  }
+  order = ctxParams[0];
+  restPos = ctxParams[1];
+  ctxOffset = ctxParams[2];
+  symbolMax = ctxParams.size() > 3 ? ctxParams[3] : 0;
+  if (order == 0 || order > 3) {
+    throw std::runtime_error("CodingConfig: Order must be 1, 2 or 3"); // TODO: Add support for higher orders
+  }
+  if (binId == binarization::BinarizationId::RICE && ctxModelId0 == contextSelector::ContextModelId::BINSORDERN) {
+    // The prefix bins of previous symbols depend on their (adapted) Rice parameters
+    throw std::runtime_error("CodingConfig: Context model BINSORDERN not supported with RICE");
+  }
+  if (symbolPosition) {
+    symbolPosMode = ctxParams[4];
+    if (symbolPosMode > 5) {
+      throw std::runtime_error("CodingConfig: Unknown symbol position mode");
+    }
+    if (symbolPosMode == 1) {
+      symbolPosIdx[0] = ctxParams[5];
+      symbolPosIdx[1] = ctxParams[6];
+      symbolPosIdx[2] = ctxParams[7];
+    }
+  }
+
+  // Derived values
+  switch (ctxModelId0) {
+    case contextSelector::ContextModelId::BINSORDERN: {
+      const bool isBI = binId == binarization::BinarizationId::BI || binId == binarization::BinarizationId::TB;
+      const unsigned int numBinValues = isBI ? 2 : 3; // 0, 1, (NA)
+      ctxIdRest = restPos;
+      for (unsigned int o = 0; o < order; o++) {
+        ctxIdRest *= numBinValues;
+      }
+    } break;
+    case contextSelector::ContextModelId::SYMBOLORDERN: {
+      ctxIdRest = restPos;
+      for (unsigned int o = 0; o < order; o++) {
+        ctxIdRest *= symbolMax + 1;
+      }
+    } break;
+    case contextSelector::ContextModelId::BINPOSITION: {
+      ctxIdRest = restPos;
+    } break;
+    case contextSelector::ContextModelId::BAC: {
+      ctxIdRest = 0;
+    } break;
+    default:
+      throw std::runtime_error("CodingConfig: Unknown context model ID");
+  }
+  numContexts0 = contextSelector::getNumContexts(binId, ctxModelId0, binParams, ctxParams);
+  numContexts = contextSelector::getNumContexts(binId, ctxModelId, binParams, ctxParams);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+CodingConfig::CodingConfig(const binarization::BinarizationId binId, const std::vector<unsigned int>& binParams
+) : binId(binId), ctxModelId(contextSelector::ContextModelId::BAC), binParams(binParams), ctxParams(), bypass(true),
+  numMaxBins(0), k(0), riceParam(0), cutoff(0), maxLog2TrDynamicRange(0), numMaxPrefixBins(0), maxSymbolRICE(0),
+  order(0), restPos(0), ctxOffset(0), symbolMax(0), symbolPosMode(0), symbolPosIdx{0, 0, 0},
+  ctxModelId0(contextSelector::ContextModelId::BAC), symbolPosition(false),
+  numContexts0(0), numContexts(0), ctxIdRest(0)
+{
+  switch (binId) {
+    case binarization::BinarizationId::BI:
+    case binarization::BinarizationId::TU:
+    case binarization::BinarizationId::EGk:
+    case binarization::BinarizationId::NA:
+    case binarization::BinarizationId::RICE:
+    case binarization::BinarizationId::TB:
+    case binarization::BinarizationId::UEGk:
+      break;
+    default:
+      throw std::runtime_error("CodingConfig: Unknown binarization ID");
+  }
+  parseBinParams();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+void CodingConfig::parseBinParams()
+{
+  unsigned int numBinParams = 0;
+  switch (binId) {
+    case binarization::BinarizationId::BI:
+    case binarization::BinarizationId::TU:
+    case binarization::BinarizationId::TB: {
+      numBinParams = 1;
+    } break;
+    case binarization::BinarizationId::EGk:
+    case binarization::BinarizationId::UEGk: {
+      numBinParams = 2;
+    } break;
+    case binarization::BinarizationId::RICE: {
+      numBinParams = 5;
+    } break;
+    default:
+      numBinParams = 0;
+  }
+  if (binParams.size() < numBinParams) {
+    throw std::runtime_error("CodingConfig: Binarization requires " + std::to_string(numBinParams) + " binParams");
+  }
+
+  numMaxBins = binParams.size() > 0 ? binParams[0] : 0;
+  k = binParams.size() > 1 ? binParams[1] : 0;
+  riceParam = binParams.size() > 2 ? binParams[2] : 0;
+  cutoff = binParams.size() > 3 ? binParams[3] : 0;
+  maxLog2TrDynamicRange = binParams.size() > 4 ? binParams[4] : 0;
+
+  if (binId == binarization::BinarizationId::RICE) {
+    if (cutoff + maxLog2TrDynamicRange > 32 || riceParam > maxLog2TrDynamicRange) {
+      throw std::runtime_error("CodingConfig: RICE requires cutoff + maxLog2TrDynamicRange <= 32 and riceParam <= maxLog2TrDynamicRange");
+    }
+    // With context-adaptive coding, the adapted Rice parameter may drop to 0, which has the smallest range
+    maxSymbolRICE = getMaxRemAbsEP(bypass ? riceParam : 0, cutoff, maxLog2TrDynamicRange);
+  }
+  if (binId == binarization::BinarizationId::BI && numMaxBins > 64) {
+    throw std::runtime_error("CodingConfig: BI supports at most 64 bins");
+  }
+  if (binId == binarization::BinarizationId::EGk) {
+    if (k > 31) {
+      throw std::runtime_error("CodingConfig: EGk parameter k must be smaller than 32");
+    }
+    // Leading zeros plus terminating bin
+    numMaxPrefixBins = binarization::getNumLeadZerosEGk(numMaxBins, k) + 1;
+  }
+  if (binId == binarization::BinarizationId::UEGk && k > 31) {
+    throw std::runtime_error("CodingConfig: UEGk parameter k must be smaller than 32");
+  }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+BlockSwitchingConfig::BlockSwitchingConfig(const std::vector<CodingConfig>& candidates, const unsigned int blockSize)
+  : candidates(candidates), blockSize(blockSize), ctxIdSelect(0), numContexts(0)
+{
+  if (candidates.empty() || candidates.size() > maxNumCandidates) {
+    throw std::runtime_error("BlockSwitchingConfig: Number of candidates must be 1 to " +
+      std::to_string(maxNumCandidates));
+  }
+  if (blockSize == 0) {
+    throw std::runtime_error("BlockSwitchingConfig: Block size must be positive");
+  }
+  for (const auto& config : candidates) {
+    if (!config.bypass) {
+      ctxIdSelect = std::max(ctxIdSelect, config.ctxOffset + config.numContexts);
+    }
+  }
+  numContexts = ctxIdSelect + static_cast<unsigned int>(candidates.size()) - 1;
+}
+
+#endif  // RWTH_PYTHON_IF
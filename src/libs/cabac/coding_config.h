@@ -0,0 +1,99 @@
+#ifndef __RWTH_CODING_CONFIG_H__
+#define __RWTH_CODING_CONFIG_H__
+
+#include "CommonDef.h"
+#include <cstdint>
+#include <vector>
+
+#if RWTH_PYTHON_IF
+#include "binarization.h"
+#include "context_selector.h"
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Coding configuration of a sequence of symbols.
+// Parses and validates the positional parameter vectors once and caches all derived values, such that
+// the coding loops do not need to re-interpret them per symbol.
+// binParams = {numMaxBins or numBins, [k, [riceParam, cuttoff, maxLog2TrDynamicRange]]}
+// ctxParams = {order, restPos, offset, [symbolMax, [symbolPosMode, [idx1, idx2, idx3]]]}
+class CodingConfig {
+public:
+  // Context-adaptive coding
+  CodingConfig(const binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId,
+    const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams);
+
+  // Bypass coding
+  CodingConfig(const binarization::BinarizationId binId, const std::vector<unsigned int>& binParams);
+
+  // Context ID offset of symbol at position d for the *SYMBOLPOSITION context models
+  unsigned int getSymbolPositionContextOffset(const unsigned int d) const {
+    if (!symbolPosition) {
+      return 0;
+    }
+    return contextSelector::getSymbolPositionContextOffset(d, numContexts0, symbolPosMode,
+      symbolPosIdx[0], symbolPosIdx[1], symbolPosIdx[2]);
+  }
+
+  // Context ID of the sign bin of signed symbols (binarization::SignMode::SIGNCONTEXT), selected by the sign class of
+  // the previous symbol (see binarization::getSignClass). The numSignContexts sign contexts follow the contexts of
+  // the symbols.
+  static const unsigned int numSignContexts = 3;
+  unsigned int getSignContextId(const unsigned int signClassPrev) const {
+    return ctxOffset + numContexts + signClassPrev;
+  }
+
+  // Parameters as given
+  binarization::BinarizationId binId;
+  contextSelector::ContextModelId ctxModelId;
+  std::vector<unsigned int> binParams;
+  std::vector<unsigned int> ctxParams;
+  bool bypass;
+
+  // Binarization
+  unsigned int numMaxBins;  // BI: number of bins, TU/EGk/TB: maximum value, UEGk: cutoff of the TU prefix
+  unsigned int k;  // EGk, UEGk
+  unsigned int riceParam;  // RICE, initial Rice parameter of the adaptation with context-adaptive coding
+  unsigned int cutoff;  // RICE
+  unsigned int maxLog2TrDynamicRange;  // RICE
+  unsigned int numMaxPrefixBins;  // EGk: number of prefix bins of the largest symbol (numMaxBins)
+  uint64_t maxSymbolRICE;  // RICE: largest codable symbol (see getMaxRemAbsEP), for any adapted Rice parameter
+
+  // Context model
+  unsigned int order;
+  unsigned int restPos;
+  unsigned int ctxOffset;
+  unsigned int symbolMax;
+  unsigned int symbolPosMode;
+  unsigned int symbolPosIdx[3];
+
+  // Derived context model values
+  contextSelector::ContextModelId ctxModelId0;  // context model without symbol position
+  bool symbolPosition;  // one of the *SYMBOLPOSITION context models
+  unsigned int numContexts0;  // number of contexts of ctxModelId0
+  unsigned int numContexts;  // number of contexts in total, including the symbol position offsets
+  unsigned int ctxIdRest;  // context ID of bins at position n>=restPos, without offsets
+
+private:
+  void parseBinParams();
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Per-block switching between candidate coding configurations, see encodeSymbolsBlockSwitching.
+// The sequence is split into blocks of blockSize symbols, each coded with one of the candidates (bypass or
+// context-adaptive). The candidate index of each block is coded TU with numCandidates - 1 as maximum, with one context
+// per bin. These selection contexts follow the contexts [ctxOffset, ctxOffset + numContexts) of all candidates.
+// Candidates may share contexts (same ctxOffset) or use separate ones, which then keep their state while the
+// candidate is not selected.
+class BlockSwitchingConfig {
+public:
+  BlockSwitchingConfig(const std::vector<CodingConfig>& candidates, const unsigned int blockSize);
+
+  static const unsigned int maxNumCandidates = 16;
+
+  std::vector<CodingConfig> candidates;
+  unsigned int blockSize;
+  unsigned int ctxIdSelect;  // context ID of the first selection bin
+  unsigned int numContexts;  // number of contexts in total, including the selection contexts
+};
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_CODING_CONFIG_H__
@@ -4,7 +4,11 @@
 #include <vector>
 #include <tuple>
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
 #include "binarization.h"
+#include "coding_config.h"
 
 
 
@@ -12,6 +16,7 @@
 namespace contextSelector{
     const std::vector<unsigned int> offsetsBinOrderNBI = {1, 2, 4, 8}; // lookup table for "speedup"
     const std::vector<unsigned int> offsetsBinOrderNTU = {1, 3, 9, 27}; // lookup table for "speedup"
+    const unsigned int maxOrder = 3; // maximum number of previous symbols used by the order N context models
 
     /*
     Context model on bin-to-symbol level
@@ -225,24 +230,13 @@ namespace contextSelector{
         The prefix is modelled as a TU code with a context for each bin.
         */
 
-        unsigned int prevNumLeadZeros;
-        if (k == 0) {
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + 1)));
-        } else {
-            // Get number of leading zeros to encode previous symbol with EGk code
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + (1 << k))) - k);
-        }
+        unsigned int prevNumLeadZeros = binarization::getNumLeadZerosEGk(symbolPrev, k);
         // Return context ID for the prefix TU code
         return getContextIdBinsOrder1TU(n, prevNumLeadZeros, restPos);
     }
 
     void getContextIdsBinsOrder1EGk(std::vector<unsigned int>& ctxIds, const uint64_t symbolPrev, const unsigned int k, const unsigned int restPos){
-        unsigned int prevNumLeadZeros;
-        if (k==0) {
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + 1)));
-        } else {
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + (1 << k))) - k);
-        }
+        unsigned int prevNumLeadZeros = binarization::getNumLeadZerosEGk(symbolPrev, k);
         getContextIdsBinsOrder1TU(ctxIds, prevNumLeadZeros, restPos);
     }
 
@@ -253,7 +247,7 @@ namespace contextSelector{
 
     // ---------------------------------------------------------------------------------------------------------------------
     // BI
-    unsigned int getContextIdBinsOrderNBI(const unsigned int order, const unsigned int n, const std::vector<uint64_t> symbolsPrev, 
+    unsigned int getContextIdBinsOrderNBI(const unsigned int order, const unsigned int n, const uint64_t * symbolsPrev, 
         const unsigned int numBins, const unsigned int restPos=10
     ){
         /* 
@@ -299,7 +293,7 @@ namespace contextSelector{
         return ctxId;
     }
 
-    void getContextIdsBinsOrderNBI(std::vector<unsigned int>& ctxIds, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    void getContextIdsBinsOrderNBI(std::vector<unsigned int>& ctxIds, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int numBins, const unsigned int restPos=10
     ) {
         /* 
@@ -319,7 +313,7 @@ namespace contextSelector{
 
     // ---------------------------------------------------------------------------------------------------------------------
     // TU
-    unsigned int getContextIdBinsOrderNTU(const unsigned int order, const unsigned int n, const std::vector<uint64_t> symbolsPrev,
+    unsigned int getContextIdBinsOrderNTU(const unsigned int order, const unsigned int n, const uint64_t * symbolsPrev,
         const unsigned int restPos=10
     ) {
         /* 
@@ -382,7 +376,7 @@ namespace contextSelector{
         return ctxId;
     }
 
-    void getContextIdsBinsOrderNTU(std::vector<unsigned int>& ctxIds, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    void getContextIdsBinsOrderNTU(std::vector<unsigned int>& ctxIds, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int restPos=10
     ) {
         
@@ -399,7 +393,7 @@ namespace contextSelector{
 
     // ---------------------------------------------------------------------------------------------------------------------
     // EGk
-    unsigned int getContextIdBinsOrderNEGk(const unsigned int n, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    unsigned int getContextIdBinsOrderNEGk(const unsigned int n, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int k, const unsigned int restPos=10
     ) {
         /*
@@ -407,35 +401,28 @@ namespace contextSelector{
         The prefix is modelled as a TU code with a context for each bin.
         */
 
+        if (order > maxOrder) {
+            throw std::runtime_error("getContextIdBinsOrderNEGk: Order must be at most 3");
+        }
         // Get number of leading zeros to encode previous symbol with EGk code
-        std::vector<uint64_t> prevNumsLeadZeros(order, 0);
-        if (k == 0){
-            for(unsigned int o=0; o < order; o++){
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + 1))); // number of leading zeros
-            }
-        } else {
-            for(unsigned int o=0; o < order; o++) {
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + (1 << k))) - k); // number of leading zeros
-            }
+        uint64_t prevNumsLeadZeros[maxOrder] = {0, 0, 0};
+        for(unsigned int o=0; o < order; o++) {
+            prevNumsLeadZeros[o] = binarization::getNumLeadZerosEGk(symbolsPrev[o], k); // number of leading zeros
         }
 
         // Return context ID for the prefix TU code
         return getContextIdBinsOrderNTU(order, n, prevNumsLeadZeros, restPos);
     }
 
-    void getContextIdsBinsOrderNEGk(std::vector<unsigned int>& ctxIds, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    void getContextIdsBinsOrderNEGk(std::vector<unsigned int>& ctxIds, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int k, const unsigned int restPos
     ) {
-        std::vector<uint64_t> prevNumsLeadZeros(order, 0);
-        if (k == 0) {
-            for(unsigned int o=0; o < order; o++){
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + 1))); // number of leading zeros
-            }
+        if (order > maxOrder) {
+            throw std::runtime_error("getContextIdsBinsOrderNEGk: Order must be at most 3");
         }
-        else {
-            for(unsigned int o=0; o < order; o++) {
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + (1 << k))) - k); // number of leading zeros
-            }
+        uint64_t prevNumsLeadZeros[maxOrder] = {0, 0, 0};
+        for(unsigned int o=0; o < order; o++) {
+            prevNumsLeadZeros[o] = binarization::getNumLeadZerosEGk(symbolsPrev[o], k); // number of leading zeros
         }
 
         getContextIdsBinsOrderNTU(ctxIds, order, prevNumsLeadZeros, restPos);
@@ -525,12 +512,7 @@ namespace contextSelector{
         */
 
         // Get number of leading zeros to encode previous symbol with EGk code
-        unsigned int prevNumLeadZeros;
-        if (k == 0) {
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + 1)));
-        } else {
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + (1 << k))) - k);
-        }
+        unsigned int prevNumLeadZeros = binarization::getNumLeadZerosEGk(symbolPrev, k);
 
         // Return context ID for the prefix TU code
         return getContextIdSymbolOrder1TU(n, prevNumLeadZeros, restPos, symbolMax);
@@ -544,12 +526,7 @@ namespace contextSelector{
         */
         
         // Get number of leading zeros to encode previous symbol with EGk code
-        unsigned int prevNumLeadZeros;
-        if (k==0) {
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + 1)));
-        } else {
-            prevNumLeadZeros = (unsigned int)(floor(log2(symbolPrev + (1 << k))) - k);
-        }
+        unsigned int prevNumLeadZeros = binarization::getNumLeadZerosEGk(symbolPrev, k);
 
         // Get Context IDs for the prefix TU code
         getContextIdsSymbolOrder1TU(ctxIds, prevNumLeadZeros, restPos, symbolMax);
@@ -562,7 +539,7 @@ namespace contextSelector{
 
     // ---------------------------------------------------------------------------------------------------------------------
     // BI
-    unsigned int getContextIdSymbolOrderNBI(const unsigned int order, const unsigned int n, const std::vector<uint64_t> symbolsPrev,
+    unsigned int getContextIdSymbolOrderNBI(const unsigned int order, const unsigned int n, const uint64_t * symbolsPrev,
         const unsigned int restPos=8, const unsigned int symbolMax=32
     ) {
         /* 
@@ -627,7 +604,7 @@ namespace contextSelector{
         return ctxId;
     }
 
-    void getContextIdsSymbolOrderNBI(std::vector<unsigned int>& ctxIds, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    void getContextIdsSymbolOrderNBI(std::vector<unsigned int>& ctxIds, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int restPos=8, const unsigned int symbolMax=32
     ) {
         /* 
@@ -647,13 +624,13 @@ namespace contextSelector{
 
     // ---------------------------------------------------------------------------------------------------------------------
     // TU
-    unsigned int getContextIdSymbolOrderNTU(const unsigned int order, const unsigned int n, const std::vector<uint64_t> symbolsPrev,
+    unsigned int getContextIdSymbolOrderNTU(const unsigned int order, const unsigned int n, const uint64_t * symbolsPrev,
         const unsigned int restPos=8, const unsigned int symbolMax=32
     ) {
         return getContextIdSymbolOrderNBI(order, n, symbolsPrev, restPos, symbolMax); // For TU, the symbol-wise orderN context model is the same as for BI
     }
 
-    void getContextIdsSymbolOrderNTU(std::vector<unsigned int>& ctxIds, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    void getContextIdsSymbolOrderNTU(std::vector<unsigned int>& ctxIds, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int restPos=8, const unsigned int symbolMax=32
     ) {
         getContextIdsSymbolOrderNBI(ctxIds, order, symbolsPrev, restPos, symbolMax); // For TU, the symbol-wise orderN context model is the same as for BI
@@ -661,7 +638,7 @@ namespace contextSelector{
 
     // ---------------------------------------------------------------------------------------------------------------------
     // EGk
-    unsigned int getContextIdSymbolOrderNEGk(const unsigned int n, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    unsigned int getContextIdSymbolOrderNEGk(const unsigned int n, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int k, const unsigned int restPos=10
     ) {
         /*
@@ -669,39 +646,56 @@ namespace contextSelector{
         The prefix is modelled as a TU code with a context for each bin.
         */
 
+        if (order > maxOrder) {
+            throw std::runtime_error("getContextIdSymbolOrderNEGk: Order must be at most 3");
+        }
         // Get number of leading zeros to encode previous symbol with EGk code
-        std::vector<uint64_t> prevNumsLeadZeros(order, 0);
-        if (k==0) {
-            for(unsigned int o=0; o < order; o++){
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + 1))); // number of leading zeros
-            }
-        } else {
-            for(unsigned int o=0; o < order; o++) {
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + (1 << k))) - k); // number of leading zeros
-            }
+        uint64_t prevNumsLeadZeros[maxOrder] = {0, 0, 0};
+        for(unsigned int o=0; o < order; o++) {
+            prevNumsLeadZeros[o] = binarization::getNumLeadZerosEGk(symbolsPrev[o], k); // number of leading zeros
         }
 
         // Return context ID for the prefix TU code
         return getContextIdSymbolOrderNTU(order, n, prevNumsLeadZeros, restPos);
     }
 
-    void getContextIdsSymbolOrderNEGk(std::vector<unsigned int>& ctxIds, const unsigned int order, const std::vector<uint64_t> symbolsPrev,
+    void getContextIdsSymbolOrderNEGk(std::vector<unsigned int>& ctxIds, const unsigned int order, const uint64_t * symbolsPrev,
         const unsigned int k, const unsigned int restPos
     ) {
-        std::vector<uint64_t> prevNumsLeadZeros(order, 0);
-        if (k==0) {
-            for(unsigned int o=0; o < order; o++){
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + 1))); // number of leading zeros
-            }
-        } else {
-            for(unsigned int o=0; o < order; o++) {
-                prevNumsLeadZeros[o] = (unsigned int)(floor(log2(symbolsPrev[o] + (1 << k))) - k); // number of leading zeros
-            }
+        if (order > maxOrder) {
+            throw std::runtime_error("getContextIdsSymbolOrderNEGk: Order must be at most 3");
+        }
+        uint64_t prevNumsLeadZeros[maxOrder] = {0, 0, 0};
+        for(unsigned int o=0; o < order; o++) {
+            prevNumsLeadZeros[o] = binarization::getNumLeadZerosEGk(symbolsPrev[o], k); // number of leading zeros
         }
 
         getContextIdsSymbolOrderNTU(ctxIds, order, prevNumsLeadZeros, restPos);
     }
 
+    // ---------------------------------------------------------------------------------------------------------------------
+    // TB
+    // With the bins-order models, TB codewords are modelled bin by bin as BI codewords of getNumMaxBins() bins, with
+    // the shorter codewords left-aligned such that bins at the same position n line up. All other context models use
+    // the previous symbols themselves.
+    static void getSymbolsPrevTB(uint64_t * symbolsPrevTB, const uint64_t * symbolsPrev, const unsigned int order,
+        const contextSelector::ContextModelId ctxModelId, const std::vector<unsigned int>& binParams
+    ) {
+        const binarization::TruncatedBinary tb(binParams[0]);
+        const bool aligned = getBaseContextModelId(ctxModelId) == contextSelector::ContextModelId::BINSORDERN;
+        for(unsigned int o=0; o < order; o++) {
+            symbolsPrevTB[o] = aligned ? tb.getAlignedCodeword(symbolsPrev[o]) : symbolsPrev[o];
+        }
+    }
+
+    // Number of bins of the BI-like codewords of BI and TB
+    static unsigned int getNumMaxBinsBI(const binarization::BinarizationId binId, const std::vector<unsigned int>& binParams) {
+        if (binId == binarization::BinarizationId::TB) {
+            return binarization::TruncatedBinary(binParams[0]).getNumMaxBins();
+        }
+        return binParams[0];
+    }
+
     // ---------------------------------------------------------------------------------------------------------------------
     // Generalization
     // ---------------------------------------------------------------------------------------------------------------------
@@ -711,33 +705,36 @@ namespace contextSelector{
     // See encodeSymbols for definition of binParams and ctxParams
     unsigned int getContextId(const unsigned int n, const unsigned int d, const uint64_t* symbolsPrev,
         const binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId, 
-        const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams)
+        const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
     {
         auto order = ctxParams[0];
         auto restPos = ctxParams[1];
         auto ctxOffset = ctxParams[2];
 
         unsigned int contextId = 0;
-        std::vector<uint64_t> symbolsPrevForTU(order, 0);
+        if (order > maxOrder) {
+            throw std::runtime_error("getContextId: Order must be at most 3");
+        }
+        uint64_t symbolsPrevForTU[maxOrder] = {0, 0, 0};
 
         // Prepare symbolsPrev to be used for TU context model
         switch (binId) {
             case binarization::BinarizationId::BI:
             case binarization::BinarizationId::TU: {
-                symbolsPrevForTU = std::vector<uint64_t>(symbolsPrev, symbolsPrev + order);
+                std::copy(symbolsPrev, symbolsPrev + order, symbolsPrevForTU);
             } break;
             case binarization::BinarizationId::EGk: {
                 auto k = binParams[1];
-                if (k==0) {
-                    for(unsigned int o=0; o < order; o++) {
-                        symbolsPrevForTU[o] = (unsigned int)(floor(log2(symbolsPrev[o] + 1))); // number of leading zeros
-                    }
-                } else {
-                    for(unsigned int o=0; o < order; o++) {
-                        symbolsPrevForTU[o] = (unsigned int)(floor(log2(symbolsPrev[o] + (1 << k))) - k); // number of leading zeros
-                    }
+                for(unsigned int o=0; o < order; o++) {
+                    symbolsPrevForTU[o] = binarization::getNumLeadZerosEGk(symbolsPrev[o], k); // number of leading zeros
                 }
             } break;
+            case binarization::BinarizationId::TB: {
+                getSymbolsPrevTB(symbolsPrevForTU, symbolsPrev, order, ctxModelId, binParams);
+            } break;
+            case binarization::BinarizationId::UEGk: {
+                std::copy(symbolsPrev, symbolsPrev + order, symbolsPrevForTU); // TU prefix
+            } break;
             default:
                 throw std::runtime_error("getContextId: Unknown binarization ID");
         }
@@ -748,8 +745,9 @@ namespace contextSelector{
             case contextSelector::ContextModelId::BINSORDERNSYMBOLPOSITION: {
                 
                 switch (binId) {
-                    case binarization::BinarizationId::BI: {
-                        auto numBins = binParams[0];
+                    case binarization::BinarizationId::BI:
+                    case binarization::BinarizationId::TB: {
+                        auto numBins = getNumMaxBinsBI(binId, binParams);
                         contextId = getContextIdBinsOrderNBI(order, n, symbolsPrevForTU, numBins, restPos);
                     } break;
                     default: {
@@ -794,31 +792,34 @@ namespace contextSelector{
 
     void getContextIds(std::vector<unsigned int>& ctxIds, const unsigned int d, const uint64_t * symbolsPrev,
         const binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId, 
-        const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams)
+        const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
     {
         auto order = ctxParams[0];
         auto restPos = ctxParams[1];
         auto ctxOffset = ctxParams[2];
 
-        std::vector<uint64_t> symbolsPrevForTU(order, 0); // for BI and TU
+        if (order > maxOrder) {
+            throw std::runtime_error("getContextIds: Order must be at most 3");
+        }
+        uint64_t symbolsPrevForTU[maxOrder] = {0, 0, 0}; // for BI and TU
         switch(binId) {
             case binarization::BinarizationId::BI:
             case binarization::BinarizationId::TU: {
-                symbolsPrevForTU = std::vector<uint64_t>(symbolsPrev, symbolsPrev + order);
+                std::copy(symbolsPrev, symbolsPrev + order, symbolsPrevForTU);
             } break;
             case binarization::BinarizationId::EGk: {
                 auto k = binParams[1];
 
-                if (k==0) {
-                    for(unsigned int o=0; o < order; o++) {
-                        symbolsPrevForTU[o] = (unsigned int)(floor(log2(symbolsPrev[o] + 1))); // number of leading zeros
-                    }
-                } else {
-                    for(unsigned int o=0; o < order; o++) {
-                        symbolsPrevForTU[o] = (unsigned int)(floor(log2(symbolsPrev[o] + (1 << k))) - k); // number of leading zeros
-                    }
+                for(unsigned int o=0; o < order; o++) {
+                    symbolsPrevForTU[o] = binarization::getNumLeadZerosEGk(symbolsPrev[o], k); // number of leading zeros
                 }
             } break;
+            case binarization::BinarizationId::TB: {
+                getSymbolsPrevTB(symbolsPrevForTU, symbolsPrev, order, ctxModelId, binParams);
+            } break;
+            case binarization::BinarizationId::UEGk: {
+                std::copy(symbolsPrev, symbolsPrev + order, symbolsPrevForTU); // TU prefix
+            } break;
             default:
                 throw std::runtime_error("getContextIds: Unknown binarization ID");
         }
@@ -829,8 +830,9 @@ namespace contextSelector{
             case contextSelector::ContextModelId::BINSORDERNSYMBOLPOSITION: {
 
                 switch (binId) {
-                    case binarization::BinarizationId::BI: {
-                        auto numBins = binParams[0];
+                    case binarization::BinarizationId::BI:
+                    case binarization::BinarizationId::TB: {
+                        auto numBins = getNumMaxBinsBI(binId, binParams);
                         getContextIdsBinsOrderNBI(ctxIds, order, symbolsPrevForTU, numBins, restPos);
                     } break;
                     default: {
@@ -882,7 +884,7 @@ namespace contextSelector{
     // Calculate number of total contexts per ctxModelId
     // See encodeSymbols for definition of binParams and ctxParams
     unsigned int getNumContexts(const binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId, 
-        const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams
+        const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams
     ){
         unsigned int numContexts = 0;
 
@@ -892,7 +894,8 @@ namespace contextSelector{
         switch(ctxModelId){
             case contextSelector::ContextModelId::BINSORDERN: {
                 switch(binId){
-                    case binarization::BinarizationId::BI: {
+                    case binarization::BinarizationId::BI:
+                    case binarization::BinarizationId::TB: {
                         numContexts = pow(2, order)*restPos + 1; // 0, 1
                     } break;
                     default: {
@@ -944,64 +947,25 @@ namespace contextSelector{
     // See encodeSymbols for definition of binParams and ctxParams
     unsigned int getSymbolPositionContextOffset(const unsigned int d, 
         const binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId, 
-        const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams
+        const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams
     ) {
         // Get number of contexts without symbol position offset
-        auto ctxSymbolPosMode = ctxParams[4];
         contextSelector::ContextModelId ctxModelId0 = getBaseContextModelId(ctxModelId);
         unsigned int numContexts0 = getNumContexts(binId, ctxModelId0, binParams, ctxParams);
 
-        // Determine symbol position offset
-        unsigned int ctxOffset = 0;  // default case, ctxSymbolPosMode == 0
+        return getSymbolPositionContextOffset(d, numContexts0, ctxParams);
+    } // getSymbolPositionContextOffset
 
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Same as above, but with the number of contexts of the base context model already known
+    unsigned int getSymbolPositionContextOffset(const unsigned int d, const unsigned int numContexts0,
+        const std::vector<unsigned int>& ctxParams
+    ) {
+        auto ctxSymbolPosMode = ctxParams[4];
         if (ctxSymbolPosMode == 1) {
-            // Custom with four variable intervals:
-            // [0, idx1), [idx1, idx2), [idx2, idx3), [idx3, oo)
-            auto idx1 = ctxParams[5];
-            auto idx2 = ctxParams[6];
-            auto idx3 = ctxParams[7];
-
-            if (d < idx1) {
-                ctxOffset = 1 * numContexts0;
-            } else if (d < idx2) {
-                ctxOffset = 2 * numContexts0;
-            } else if (d < idx3) {
-                ctxOffset = 3 * numContexts0;
-            }
-
-         } else if (ctxSymbolPosMode == 2) {
-            // VVC significance luminance with three intervals
-            // [0, 2), [2, 5), [5, oo)
-            if (d < 2) {
-                ctxOffset = 1 * numContexts0;
-            } else if (d < 5) {
-                ctxOffset = 2 * numContexts0;
-            }
-        } else if (ctxSymbolPosMode == 3) {
-            // VVC significance chrominance with two intervals
-            // [0, 2), [2, oo)
-            if (d < 2) {
-                ctxOffset = 1 * numContexts0;
-            }
-        } else if (ctxSymbolPosMode == 4) {
-            // VVC gt1, par, gt3 luminance with four intervals
-            // [0], [1, 3), [3, 10), [10, oo)
-            if (d == 0) {
-                ctxOffset = 3 * numContexts0;
-            } else if (d < 3) {
-                ctxOffset = 2 * numContexts0;
-            } else if (d < 10) {
-                ctxOffset = 1 * numContexts0;
-            }
-        } else if (ctxSymbolPosMode == 5) {
-            // VVC gt1, par, gt3 chrominance with two intervals
-            // [0], [1, oo)
-            if (d == 0) {
-                ctxOffset = 1 * numContexts0;
-            }
+            return getSymbolPositionContextOffset(d, numContexts0, ctxSymbolPosMode, ctxParams[5], ctxParams[6], ctxParams[7]);
         }
-
-        return ctxOffset;
+        return getSymbolPositionContextOffset(d, numContexts0, ctxSymbolPosMode, 0, 0, 0);
     } // getSymbolPositionContextOffset
 
     contextSelector::ContextModelId getBaseContextModelId(const contextSelector::ContextModelId ctxModelId) {
@@ -1025,6 +989,125 @@ namespace contextSelector{
         return ctxModelId0;
     }
 
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Whole-sequence context ID precomputation (encoder side)
+    // ---------------------------------------------------------------------------------------------------------------------
+
+    /*
+    On the encoder side, all symbols are known in advance. Thus, the context IDs of all symbols can be computed before
+    the (serial) arithmetic coding loop, in parallel. They are computed with ContextIdProvider, such that the context
+    ID computation of each context model exists only once.
+
+    Bins at position n>=restPos share a single rest context. Thus, per symbol only the context IDs of the first
+    restPos bins plus the one of the rest case need to be stored. The context IDs of symbol d are stored in row d
+    of ctxIds with stride getContextIdsSequenceStride(), where the last entry of each row is the rest context:
+
+        ctxId(d, n) = ctxIds[d*stride + min(n, stride-1)]
+    */
+
+    unsigned int getContextIdsSequenceStride(const std::vector<unsigned int>& binParams,
+        const std::vector<unsigned int>& ctxParams
+    ) {
+        const unsigned int numMaxBins = binParams[0];
+        const unsigned int restPos = ctxParams[1];
+
+        return std::min(restPos, numMaxBins) + 1;
+    }
+
+    static void getContextIdsSequenceRange(unsigned int* ctxIds, const uint64_t* symbols,
+        const unsigned int dBegin, const unsigned int dEnd, const CodingConfig& config
+    ) {
+        const unsigned int stride = getContextIdsSequenceStride(config.binParams, config.ctxParams);
+        const unsigned int numCtxBins = stride - 1; // number of bins with individual context
+        // TB: the stride is derived from cMax, bins beyond the longest codeword are never coded
+        const unsigned int numCodedCtxBins = config.binId == binarization::BinarizationId::TB ?
+            std::min(numCtxBins, binarization::TruncatedBinary(config.numMaxBins).getNumMaxBins()) : numCtxBins;
+
+        ContextIdProvider ctxIdProvider(config);
+        uint64_t symbolsPrev[3] = {0, 0, 0};
+        for (unsigned int d = dBegin; d < dEnd; d++) {
+            unsigned int* row = ctxIds + (size_t)(d - dBegin) * stride;
+            for (unsigned int o = 0; o < config.order; o++) {
+                symbolsPrev[o] = d > o ? symbols[d - o - 1] : 0;
+            }
+            ctxIdProvider.setSymbol(d, symbolsPrev);
+
+            for (unsigned int n = 0; n < numCodedCtxBins; n++) {
+                row[n] = ctxIdProvider(n);
+            }
+            row[numCtxBins] = ctxIdProvider(config.restPos);  // rest context
+            for (unsigned int n = numCodedCtxBins; n < numCtxBins; n++) {
+                row[n] = row[numCtxBins];
+            }
+        }
+    }
+
+    void getContextIdsSequence(unsigned int* ctxIds, const uint64_t* symbols,
+        const unsigned int dBegin, const unsigned int dEnd, const CodingConfig& config, unsigned int numThreads
+    ) {
+        switch (config.binId) {
+            case binarization::BinarizationId::BI:
+            case binarization::BinarizationId::TU:
+            case binarization::BinarizationId::EGk:
+            case binarization::BinarizationId::TB:
+            case binarization::BinarizationId::UEGk:
+                break;
+            default:
+                throw std::runtime_error("getContextIdsSequence: Unknown binarization ID");
+        }
+        if (config.bypass) {
+            throw std::runtime_error("getContextIdsSequence: Coding configuration is bypass only");
+        }
+
+        // Split symbols in contiguous ranges, one per thread. Do not spawn threads for tiny ranges.
+        const unsigned int minSymbolsPerThread = 4096;
+        const unsigned int numSymbols = dEnd - dBegin;
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        numThreads = std::max(1u, std::min(numThreads, numSymbols / minSymbolsPerThread));
+
+        const unsigned int stride = getContextIdsSequenceStride(config.binParams, config.ctxParams);
+        const unsigned int numSymbolsPerThread = (numSymbols + numThreads - 1) / numThreads;
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < numThreads; t++) {
+            const unsigned int d0 = dBegin + std::min(numSymbols, t * numSymbolsPerThread);
+            const unsigned int d1 = dBegin + std::min(numSymbols, (t + 1) * numSymbolsPerThread);
+            threads.emplace_back(getContextIdsSequenceRange, ctxIds + (size_t)(d0 - dBegin) * stride, symbols,
+                d0, d1, std::cref(config));
+        }
+        getContextIdsSequenceRange(ctxIds, symbols, dBegin, dBegin + std::min(numSymbols, numSymbolsPerThread), config);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Lazy per-bin context IDs
+    // ---------------------------------------------------------------------------------------------------------------------
+    ContextIdProvider::ContextIdProvider(const binarization::BinarizationId binId,
+        const contextSelector::ContextModelId ctxModelId,
+        const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams
+    ) : ContextIdProvider(CodingConfig(binId, ctxModelId, binParams, ctxParams))
+    {}
+
+    ContextIdProvider::ContextIdProvider(const CodingConfig& config
+    ) : m_binId(config.binId), m_ctxModelId0(config.ctxModelId0), m_symbolPosition(config.symbolPosition),
+        m_symbolPosMode(config.symbolPosMode),
+        m_symbolPosIdx{config.symbolPosIdx[0], config.symbolPosIdx[1], config.symbolPosIdx[2]},
+        m_order(config.order), m_restPos(config.restPos), m_ctxOffset(config.ctxOffset),
+        m_symbolMax(config.symbolMax), m_numBins(config.numMaxBins), m_k(config.k), m_tb(config.numMaxBins),
+        m_numContexts0(config.numContexts0), m_ctxIdRest(config.ctxIdRest),
+        m_symbolsPrev{0, 0, 0}, m_base(0), m_ctxIdRestSymbol(0)
+    {
+        if (config.bypass) {
+            throw std::runtime_error("ContextIdProvider: Coding configuration is bypass only");
+        }
+        if (m_binId == binarization::BinarizationId::TB) {
+            m_numBins = m_tb.getNumMaxBins();
+        }
+    }
+
 }; // namespace contextSelector
 
 #endif  // RWTH_PYTHON_IF
@@ -3,6 +3,7 @@
 
 #include "contexts.h"
 #include "binarization.h"
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 #include <tuple>
@@ -11,6 +12,8 @@
 
 
 #if RWTH_PYTHON_IF
+class CodingConfig;
+
 namespace contextSelector{
     
     enum class ContextModelId : uint8_t {
@@ -43,21 +46,21 @@ namespace contextSelector{
 
     /* Context model on bin-to-symbol level, order=N */
     // BI binarization
-    unsigned int getContextIdBinsOrderNBI(const unsigned int, const unsigned int, const std::vector<uint64_t>,
+    unsigned int getContextIdBinsOrderNBI(const unsigned int, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int);
-    void getContextIdsBinsOrderNBI(std::vector<unsigned int>&, const unsigned int, const std::vector<uint64_t>,
+    void getContextIdsBinsOrderNBI(std::vector<unsigned int>&, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int);
     
     // TU binarization
-    unsigned int getContextIdBinsOrderNTU(const unsigned int, const unsigned int, const std::vector<uint64_t>,
+    unsigned int getContextIdBinsOrderNTU(const unsigned int, const unsigned int, const uint64_t *,
         const unsigned int);
-    void getContextIdsBinsOrderNTU(std::vector<unsigned int>&, const unsigned int, const std::vector<uint64_t>,
+    void getContextIdsBinsOrderNTU(std::vector<unsigned int>&, const unsigned int, const uint64_t *,
         const unsigned int);
         
     // EGk binarization
-    unsigned int getContextIdBinsOrderNEGk(const unsigned int, const unsigned int, const std::vector<uint64_t>,
+    unsigned int getContextIdBinsOrderNEGk(const unsigned int, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int);
-    void getContextIdsBinsOrderNEGk(std::vector<unsigned int>&, const unsigned int, const std::vector<uint64_t>,
+    void getContextIdsBinsOrderNEGk(std::vector<unsigned int>&, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int);
 
 
@@ -76,46 +79,231 @@ namespace contextSelector{
 
     /* Context model on symbol-to-symbol level, order=1 */
     // BI binarization
-    unsigned int getContextIdSymbolOrderNBI(const unsigned int, const unsigned int, const std::vector<uint64_t>,
+    unsigned int getContextIdSymbolOrderNBI(const unsigned int, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int, const unsigned int);
-    void getContextIdsSymbolOrderNBI(std::vector<unsigned int>&, const unsigned int, const std::vector<uint64_t>,
+    void getContextIdsSymbolOrderNBI(std::vector<unsigned int>&, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int, const unsigned int);
     
     // TU binarization
-    unsigned int getContextIdSymbolOrderNTU(const unsigned int, const unsigned int, const std::vector<uint64_t>,
+    unsigned int getContextIdSymbolOrderNTU(const unsigned int, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int);
-    void getContextIdsSymbolOrderNTU(std::vector<unsigned int>&, const unsigned int, const std::vector<uint64_t>,
+    void getContextIdsSymbolOrderNTU(std::vector<unsigned int>&, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int);
     
     // EGk binarization
-    unsigned int getContextIdSymbolOrderNEGk(const unsigned int, const unsigned int, const std::vector<uint64_t>,
+    unsigned int getContextIdSymbolOrderNEGk(const unsigned int, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int, const unsigned int);
-    void getContextIdsSymbolOrderNEGk(std::vector<unsigned int>&, const unsigned int, const std::vector<uint64_t>,
+    void getContextIdsSymbolOrderNEGk(std::vector<unsigned int>&, const unsigned int, const uint64_t *,
         const unsigned int, const unsigned int, const unsigned int);
 
     /* General stuff */
     unsigned int getContextIdOrder1(const unsigned int, const uint64_t, 
         const binarization::BinarizationId, const contextSelector::ContextModelId, 
-        const std::vector<unsigned int>, const std::vector<unsigned int>);
+        const std::vector<unsigned int>&, const std::vector<unsigned int>&);
     void getContextIdsOrder1(std::vector<unsigned int>&, const uint64_t, 
         const binarization::BinarizationId, const contextSelector::ContextModelId, 
-        const std::vector<unsigned int>, const std::vector<unsigned int>);
+        const std::vector<unsigned int>&, const std::vector<unsigned int>&);
     unsigned int getContextId(const unsigned int, const unsigned int, const uint64_t *,
         const binarization::BinarizationId, const contextSelector::ContextModelId, 
-        const std::vector<unsigned int>, const std::vector<unsigned int>);
+        const std::vector<unsigned int>&, const std::vector<unsigned int>&);
     void getContextIds(std::vector<unsigned int>&, const unsigned int, const uint64_t *, 
         const binarization::BinarizationId, const contextSelector::ContextModelId, 
-        const std::vector<unsigned int>, const std::vector<unsigned int>);
+        const std::vector<unsigned int>&, const std::vector<unsigned int>&);
 
     unsigned int getNumContexts(const binarization::BinarizationId, const contextSelector::ContextModelId, 
-        const std::vector<unsigned int>, const std::vector<unsigned int>);
+        const std::vector<unsigned int>&, const std::vector<unsigned int>&);
 
     unsigned int getSymbolPositionContextOffset(const unsigned int, 
         const binarization::BinarizationId, const contextSelector::ContextModelId, 
-        const std::vector<unsigned int>, const std::vector<unsigned int>);
+        const std::vector<unsigned int>&, const std::vector<unsigned int>&);
+
+    unsigned int getSymbolPositionContextOffset(const unsigned int, const unsigned int, const std::vector<unsigned int>&);
+
+    // Same as above, with symbol position mode (ctxParams[4]) and interval bounds (ctxParams[5..7]) already parsed
+    inline unsigned int getSymbolPositionContextOffset(const unsigned int d, const unsigned int numContexts0,
+        const unsigned int ctxSymbolPosMode, const unsigned int idx1, const unsigned int idx2, const unsigned int idx3
+    ) {
+        // Determine symbol position offset
+        unsigned int ctxOffset = 0;  // default case, ctxSymbolPosMode == 0
+
+        if (ctxSymbolPosMode == 1) {
+            // Custom with four variable intervals:
+            // [0, idx1), [idx1, idx2), [idx2, idx3), [idx3, oo)
+            if (d < idx1) {
+                ctxOffset = 1 * numContexts0;
+            } else if (d < idx2) {
+                ctxOffset = 2 * numContexts0;
+            } else if (d < idx3) {
+                ctxOffset = 3 * numContexts0;
+            }
+
+         } else if (ctxSymbolPosMode == 2) {
+            // VVC significance luminance with three intervals
+            // [0, 2), [2, 5), [5, oo)
+            if (d < 2) {
+                ctxOffset = 1 * numContexts0;
+            } else if (d < 5) {
+                ctxOffset = 2 * numContexts0;
+            }
+        } else if (ctxSymbolPosMode == 3) {
+            // VVC significance chrominance with two intervals
+            // [0, 2), [2, oo)
+            if (d < 2) {
+                ctxOffset = 1 * numContexts0;
+            }
+        } else if (ctxSymbolPosMode == 4) {
+            // VVC gt1, par, gt3 luminance with four intervals
+            // [0], [1, 3), [3, 10), [10, oo)
+            if (d == 0) {
+                ctxOffset = 3 * numContexts0;
+            } else if (d < 3) {
+                ctxOffset = 2 * numContexts0;
+            } else if (d < 10) {
+                ctxOffset = 1 * numContexts0;
+            }
+        } else if (ctxSymbolPosMode == 5) {
+            // VVC gt1, par, gt3 chrominance with two intervals
+            // [0], [1, oo)
+            if (d == 0) {
+                ctxOffset = 1 * numContexts0;
+            }
+        }
+
+        return ctxOffset;
+    } // getSymbolPositionContextOffset
 
     contextSelector::ContextModelId getBaseContextModelId(const contextSelector::ContextModelId);
 
+    /* Whole-sequence context ID precomputation (encoder side) */
+    unsigned int getContextIdsSequenceStride(const std::vector<unsigned int>&, const std::vector<unsigned int>&);
+    void getContextIdsSequence(unsigned int *, const uint64_t *, const unsigned int, const unsigned int,
+        const CodingConfig&, unsigned int);
+
+    /* Lazy per-bin context IDs */
+    // Same context IDs as getContextIds, but computed on demand for the bins that are actually coded. All symbol
+    // dependent work is done once per symbol in setSymbol (O(order)), such that the cost per symbol scales with the
+    // number of coded bins instead of numMaxBins.
+    class ContextIdProvider {
+    public:
+        ContextIdProvider(const binarization::BinarizationId, const contextSelector::ContextModelId,
+            const std::vector<unsigned int>&, const std::vector<unsigned int>&);
+        explicit ContextIdProvider(const CodingConfig&);
+
+        // Prepare context ID computation for symbol at position d with previous symbols symbolsPrev[0..order-1]
+        void setSymbol(const unsigned int d, const uint64_t * symbolsPrev) {
+            setSymbol(d, symbolsPrev, m_binId, m_ctxModelId0, m_order);
+        }
+
+        // Bins at position n>=getRestPos() share the context ID of the rest bins, see getRestPos in CommonDef.h
+        unsigned int getRestPos() const { return m_restPos; }
+
+        // Context ID for bin at position n of the current symbol
+        unsigned int operator()(const unsigned int n) const {
+            return getContextId(n, m_binId, m_ctxModelId0, m_order);
+        }
+
+    protected:
+        // Implementation of setSymbol and operator(). TContextIdProvider passes binId, ctxModelId0 and order as
+        // compile-time constants, such that the switches are resolved by the compiler.
+        void setSymbol(const unsigned int d, const uint64_t * symbolsPrev, const binarization::BinarizationId binId,
+            const ContextModelId ctxModelId0, const unsigned int order) {
+            unsigned int offset = m_ctxOffset;
+            if (m_symbolPosition) {
+                offset += getSymbolPositionContextOffset(d, m_numContexts0, m_symbolPosMode,
+                    m_symbolPosIdx[0], m_symbolPosIdx[1], m_symbolPosIdx[2]);
+            }
+            m_ctxIdRestSymbol = m_ctxIdRest + offset;
+            m_base = offset;
+
+            if (ctxModelId0 != ContextModelId::BINSORDERN && ctxModelId0 != ContextModelId::SYMBOLORDERN) {
+                return;
+            }
+            for (unsigned int o = 0; o < order; o++) {
+                uint64_t symbolPrev = symbolsPrev[o];
+                if (binId == binarization::BinarizationId::EGk) { // number of leading zeros
+                    symbolPrev = binarization::getNumLeadZerosEGk(symbolPrev, m_k);
+                } else if (binId == binarization::BinarizationId::TB &&
+                    ctxModelId0 == ContextModelId::BINSORDERN) { // bins of the aligned codeword
+                    symbolPrev = m_tb.getAlignedCodeword(symbolPrev);
+                }
+                m_symbolsPrev[o] = symbolPrev;
+            }
+            if (ctxModelId0 == ContextModelId::SYMBOLORDERN) {
+                unsigned int weight = m_restPos;
+                for (unsigned int o = 0; o < order; o++) {
+                    m_base += std::min<uint64_t>(m_symbolsPrev[o], m_symbolMax) * weight;
+                    weight *= m_symbolMax + 1;
+                }
+            }
+        }
+
+        unsigned int getContextId(const unsigned int n, const binarization::BinarizationId binId,
+            const ContextModelId ctxModelId0, const unsigned int order) const {
+            if (n >= m_restPos) { // bins at position n>=restPos are modeled with the same rest context
+                return m_ctxIdRestSymbol;
+            }
+            if (ctxModelId0 == ContextModelId::BINSORDERN) {
+                unsigned int ctxId = 0;
+                if (binId == binarization::BinarizationId::BI || binId == binarization::BinarizationId::TB) {
+                    for (unsigned int o = 0; o < order; o++) {
+                        ctxId += static_cast<unsigned int>((m_symbolsPrev[o] >> static_cast<uint8_t>(m_numBins-n-1)) & 0x1u)
+                            << o;
+                    }
+                } else {
+                    unsigned int weight = 1;
+                    for (unsigned int o = 0; o < order; o++) {
+                        // NA: 0, 0: 1, 1: 2
+                        ctxId += ((n < m_symbolsPrev[o]) + 2 * (n == m_symbolsPrev[o])) * weight;
+                        weight *= 3;
+                    }
+                }
+                return ctxId * m_restPos + n + m_base;
+            }
+            if (ctxModelId0 == ContextModelId::BAC) {
+                return m_base;
+            }
+            return m_base + n; // SYMBOLORDERN, BINPOSITION
+        }
+
+        binarization::BinarizationId m_binId;
+        contextSelector::ContextModelId m_ctxModelId0;  // context model without symbol position
+        bool m_symbolPosition;
+        unsigned int m_symbolPosMode;
+        unsigned int m_symbolPosIdx[3];
+        unsigned int m_order;
+        unsigned int m_restPos;
+        unsigned int m_ctxOffset;
+        unsigned int m_symbolMax;
+        unsigned int m_numBins;  // TB: bins of the longest codeword
+        unsigned int m_k;
+        binarization::TruncatedBinary m_tb;
+        unsigned int m_numContexts0;
+        unsigned int m_ctxIdRest;  // rest context without offsets, see CodingConfig::ctxIdRest
+
+        // Per symbol state
+        uint64_t m_symbolsPrev[3];  // previous symbols, EGk: number of leading zeros, TB (BINSORDERN): aligned codeword
+        unsigned int m_base;
+        unsigned int m_ctxIdRestSymbol;
+    };
+
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // ContextIdProvider with binarization, context model (without symbol position) and order fixed at compile time.
+    // All switches are resolved by the compiler, such that context selection inlines into the coding loops.
+    template <binarization::BinarizationId binId, ContextModelId ctxModelId0, unsigned int order>
+    class TContextIdProvider : public ContextIdProvider {
+    public:
+        explicit TContextIdProvider(const CodingConfig& config) : ContextIdProvider(config) {}
+
+        void setSymbol(const unsigned int d, const uint64_t * symbolsPrev) {
+            ContextIdProvider::setSymbol(d, symbolsPrev, binId, ctxModelId0, order);
+        }
+
+        unsigned int operator()(const unsigned int n) const {
+            return getContextId(n, binId, ctxModelId0, order);
+        }
+    };
+
 };  // namespace contextSelector
 
 #endif  // RWTH_PYTHON_IF
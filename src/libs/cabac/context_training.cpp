@@ -0,0 +1,113 @@
+#include "context_training.h"
+#include "sequence_encoder.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+
+#if RWTH_PYTHON_IF
+namespace contextTraining{
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  std::vector<ContextBins> recordBins(const std::vector<std::vector<uint64_t>>& samples, const CodingConfig& config,
+    const size_t maxNumBins) {
+    std::vector<ContextBins> ctxBins(config.numContexts);
+    cabacSimpleSequenceEncoder encoder;
+    encoder.setBinStorage(true, maxNumBins);
+    for (const auto& sample : samples) {
+      encoder.initCtx(config.ctxOffset + config.numContexts, 0.5, 8);  // the bins do not depend on the initialization
+      encoder.start();
+      encoder.encodeSymbols(sample.data(), static_cast<unsigned int>(sample.size()), config);
+      encoder.finish();
+
+      const BinStore* binStore = encoder.getBinStore();
+      for (unsigned int i = 0; i < config.numContexts; i++) {
+        ContextBins& c = ctxBins[i];
+        const unsigned int ctxId = config.ctxOffset + i;
+        if (ctxId < binStore->getNumContexts()) {
+          const std::vector<uint8_t>& bins = binStore->getBinVector(ctxId);
+          c.bins.insert(c.bins.end(), bins.begin(), bins.end());
+        }
+        c.sampleEnds.push_back(c.bins.size());
+      }
+    }
+    return ctxBins;
+  }
+
+  std::vector<uint8_t> getValidShiftIdxs() {
+    std::vector<uint8_t> shiftIdxs;
+    for (unsigned int shiftIdx = 0; shiftIdx <= 13; shiftIdx++) {  // rate1 = 5 + (shiftIdx >> 2) + (shiftIdx & 3) <= 9
+      if ((shiftIdx >> 2) + (shiftIdx & 3) <= 4) {
+        shiftIdxs.push_back(static_cast<uint8_t>(shiftIdx));
+      }
+    }
+    return shiftIdxs;
+  }
+
+  uint64_t estimateBits(const ContextBins& ctxBins, const double p1, const uint8_t shiftIdx) {
+    uint64_t bits = 0;
+    size_t i = 0;
+    for (const size_t sampleEnd : ctxBins.sampleEnds) {
+      BinProbModel_Std probModel;
+      probModel.initFromP1AndShiftIdx(p1, shiftIdx);
+      for (; i < sampleEnd; i++) {
+        probModel.estFracBitsUpdate(ctxBins.bins[i], bits);
+      }
+    }
+    return bits;
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  std::vector<std::tuple<double, uint8_t>> trainContextInit(const std::vector<ContextBins>& ctxBins,
+    unsigned int numThreads, const unsigned int numProbs, const std::tuple<double, uint8_t>& defaultInit) {
+    if (numProbs < 2) {
+      throw std::runtime_error("trainContextInit: Number of probabilities must be at least 2");
+    }
+    const std::vector<uint8_t> shiftIdxs = getValidShiftIdxs();
+    std::vector<std::tuple<double, uint8_t>> initCtx(ctxBins.size(), defaultInit);
+
+    // Contexts are taken from a shared counter, since the number of bins per context varies a lot
+    std::atomic<size_t> nextCtxId(0);
+    auto trainContexts = [&]() {
+      for (size_t ctxId = nextCtxId++; ctxId < ctxBins.size(); ctxId = nextCtxId++) {
+        if (ctxBins[ctxId].bins.empty()) {
+          continue;
+        }
+        uint64_t bitsBest = UINT64_MAX;
+        for (const uint8_t shiftIdx : shiftIdxs) {
+          for (unsigned int k = 1; k < numProbs; k++) {
+            const double p1 = static_cast<double>(k) / numProbs;
+            const uint64_t bits = estimateBits(ctxBins[ctxId], p1, shiftIdx);
+            if (bits < bitsBest) {
+              bitsBest = bits;
+              initCtx[ctxId] = std::make_tuple(p1, shiftIdx);
+            }
+          }
+        }
+      }
+    };
+
+    if (numThreads == 0) {
+      numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(numThreads, ctxBins.size())));
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < numThreads; t++) {
+      threads.emplace_back(trainContexts);
+    }
+    trainContexts();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    return initCtx;
+  }
+
+  std::vector<std::tuple<double, uint8_t>> trainContextInit(const std::vector<std::vector<uint64_t>>& samples,
+    const CodingConfig& config, const unsigned int numThreads, const unsigned int numProbs, const size_t maxNumBins) {
+    return trainContextInit(recordBins(samples, config, maxNumBins), numThreads, numProbs);
+  }
+
+};  // namespace contextTraining
+
+#endif  // RWTH_PYTHON_IF
@@ -0,0 +1,56 @@
+#ifndef __RWTH_CONTEXT_TRAINING_H__
+#define __RWTH_CONTEXT_TRAINING_H__
+
+#include "CommonDef.h"
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#if RWTH_PYTHON_IF
+#include "coding_config.h"
+#include "symbol_encoder.h"
+
+namespace contextTraining{
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Trainer for the context initializations (p1, shiftIdx) of initCtx.
+    // The context-coded bins of sample sequences are recorded once per context (recordBins). The bins do not depend on
+    // the probabilities, since the context selection only depends on the symbols. Then, each candidate initialization
+    // is evaluated per context by the estimated bits (BinProbModel_Std::estFracBitsUpdate, i.e. the m_binFracBits
+    // tables), where each sample starts from the initial state, as a separate stream would.
+
+    // Context-coded bins of one context: bins of all samples, sample s ends at sampleEnds[s]
+    struct ContextBins {
+        std::vector<uint8_t> bins;
+        std::vector<size_t> sampleEnds;
+    };
+
+    // Records the bins of encodeSymbols(sample, config) for all samples, at most maxNumBins per context and sample.
+    // Entry i holds the bins of context config.ctxOffset + i.
+    std::vector<ContextBins> recordBins(const std::vector<std::vector<uint64_t>>& samples, const CodingConfig& config,
+        const size_t maxNumBins = BinStore::defaultMaxNumBins);
+
+    // Valid shiftIdx values of initFromP1AndShiftIdx, see BinProbModel_Std::setLog2WindowSize
+    std::vector<uint8_t> getValidShiftIdxs();
+
+    // Estimated bits (in 1 << SCALE_BITS units) of the bins of one context with initialization (p1, shiftIdx)
+    uint64_t estimateBits(const ContextBins& ctxBins, const double p1, const uint8_t shiftIdx);
+
+    // Best initialization per context among p1 = k / numProbs (0 < k < numProbs) and all valid shiftIdx values.
+    // Contexts are distributed over numThreads threads (0: hardware concurrency). Contexts without bins get
+    // defaultInit. The result can be passed to initCtx of the encoder and decoder.
+    std::vector<std::tuple<double, uint8_t>> trainContextInit(const std::vector<ContextBins>& ctxBins,
+        unsigned int numThreads = 0, const unsigned int numProbs = 64,
+        const std::tuple<double, uint8_t>& defaultInit = std::make_tuple(0.5, uint8_t(8)));
+
+    // Same as above, recording the bins of samples with config first. Returns config.numContexts initializations,
+    // entry i for context config.ctxOffset + i.
+    std::vector<std::tuple<double, uint8_t>> trainContextInit(const std::vector<std::vector<uint64_t>>& samples,
+        const CodingConfig& config, const unsigned int numThreads = 0, const unsigned int numProbs = 64,
+        const size_t maxNumBins = BinStore::defaultMaxNumBins);
+
+};  // namespace contextTraining
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_CONTEXT_TRAINING_H__
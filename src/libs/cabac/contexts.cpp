@@ -38,6 +38,7 @@
 #include "contexts.h"
 #include "cabac/CommonDef.h"
 #include <cstdint>
+#include <stdexcept>
 #include <tuple>
 
 // #include <algorithm>
@@ -147,4 +148,51 @@ void BinProbModel_Std::initFromP1AndShiftIdx( double p1, uint8_t shiftIdx ) {
   CHECK(shiftIdx > 13, "I think shiftIdx should not be greater than 13")
   setLog2WindowSize(shiftIdx);
 }
+
+// Window sizes of setLog2WindowSize (rate0 in [2, 5], rate1 in [rate0 + 3, min(rate0 + 6, 9)]) or of a frozen model
+static bool isValidRate( const uint16_t rate )
+{
+  if( rate == 0xff )
+  {
+    return true;
+  }
+  const unsigned rate0 = rate >> 4;
+  const unsigned rate1 = rate & 15;
+  return rate0 >= 2 && rate0 <= 5 && rate1 >= rate0 + 3 && rate1 <= rate0 + 6 && rate1 <= 9;
+}
+
+void BinProbModel_Std::setStateWords( const uint16_t* words )
+{
+  if( ( words[0] & ~MASK_0 ) || ( words[1] & ~MASK_1 ) || !isValidRate( words[2] ) )
+  {
+    throw std::runtime_error( "importContexts: Invalid context state" );
+  }
+  m_state[0] = words[0];
+  m_state[1] = words[1];
+  m_rate     = static_cast<uint8_t>( words[2] );
+}
+
+std::vector<uint16_t> exportContexts( const std::vector<BinProbModel_Std>& ctx )
+{
+  std::vector<uint16_t> words( ctx.size() * BinProbModel_Std::numStateWords );
+  for( size_t i = 0; i < ctx.size(); i++ )
+  {
+    ctx[i].getStateWords( &words[i * BinProbModel_Std::numStateWords] );
+  }
+  return words;
+}
+
+std::vector<BinProbModel_Std> importContexts( const std::vector<uint16_t>& words )
+{
+  if( words.size() % BinProbModel_Std::numStateWords )
+  {
+    throw std::runtime_error( "importContexts: Number of words must be a multiple of 3" );
+  }
+  std::vector<BinProbModel_Std> ctx( words.size() / BinProbModel_Std::numStateWords );
+  for( size_t i = 0; i < ctx.size(); i++ )
+  {
+    ctx[i].setStateWords( &words[i * BinProbModel_Std::numStateWords] );
+  }
+  return ctx;
+}
 #endif
@@ -39,6 +39,8 @@
 #define __CONTEXTS__
 
 #include <cstdint>
+#include <memory>
+#include <tuple>
 #include <vector>
 #include "CommonDef.h"
 
@@ -142,6 +144,22 @@ public:
     m_state[0] = (pState >> 1) & MASK_0;
     m_state[1] = (pState >> 1) & MASK_1;
   }
+#if RWTH_PYTHON_IF
+  // Frozen model: with both window sizes at the maximum shift of 15, update() leaves the state unchanged, such that
+  // the probability is static without a branch in the bin coding loops
+  void freeze()         { m_rate = 0xff; }
+  bool isFrozen() const { return m_rate == 0xff; }
+
+  // Complete state as numStateWords words (both estimates and the window sizes), see exportContexts
+  static const unsigned numStateWords = 3;
+  void getStateWords(uint16_t* words) const
+  {
+    words[0] = m_state[0];
+    words[1] = m_state[1];
+    words[2] = m_rate;
+  }
+  void setStateWords(const uint16_t* words);
+#endif
 public:
   uint64_t estFracExcessBits(const BinProbModel_Std &r) const
   {
@@ -153,4 +171,49 @@ private:
   uint8_t  m_rate;
 };
 
+#if RWTH_PYTHON_IF
+// ---------------------------------------------------------------------------------------------------------------------
+// Lossless serialization of context states, e.g. to carry trained contexts over to the next stream (warm start):
+// BinProbModel_Std::numStateWords uint16 words per context
+std::vector<uint16_t>         exportContexts(const std::vector<BinProbModel_Std>& ctx);
+std::vector<BinProbModel_Std> importContexts(const std::vector<uint16_t>& words);
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Immutable set of frozen contexts, e.g. after a training phase. Copies share the context array, which is never
+// written, such that one set can be used by several encoders and decoders (also in different threads). Each coder
+// copies the contexts in initCtx, which is O(number of contexts).
+class FrozenContexts
+{
+public:
+  FrozenContexts() : m_ctx(std::make_shared<const std::vector<BinProbModel_Std>>()) {}
+  explicit FrozenContexts(std::vector<BinProbModel_Std> ctx)
+  {
+    for (auto& probModel : ctx)
+    {
+      probModel.freeze();
+    }
+    m_ctx = std::make_shared<const std::vector<BinProbModel_Std>>(std::move(ctx));
+  }
+  explicit FrozenContexts(const std::vector<std::tuple<double, uint8_t>>& initCtx)
+    : FrozenContexts(getInitialContexts(initCtx)) {}
+
+  size_t                  size      ()                  const { return m_ctx->size(); }
+  const BinProbModel_Std& operator[]( unsigned ctxId )  const { return (*m_ctx)[ctxId]; }
+  const std::vector<BinProbModel_Std>& getContexts()    const { return *m_ctx; }
+
+private:
+  static std::vector<BinProbModel_Std> getInitialContexts(const std::vector<std::tuple<double, uint8_t>>& initCtx)
+  {
+    std::vector<BinProbModel_Std> ctx(initCtx.size());
+    for (size_t i = 0; i < initCtx.size(); i++)
+    {
+      ctx[i].initFromP1AndShiftIdx(std::get<0>(initCtx[i]), std::get<1>(initCtx[i]));
+    }
+    return ctx;
+  }
+
+  std::shared_ptr<const std::vector<BinProbModel_Std>> m_ctx;
+};
+#endif
+
 #endif
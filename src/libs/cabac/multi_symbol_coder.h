@@ -0,0 +1,370 @@
+#ifndef __RWTH_MULTI_SYMBOL_CODER_H__
+#define __RWTH_MULTI_SYMBOL_CODER_H__
+
+#include "CommonDef.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if RWTH_PYTHON_IF
+namespace multiSymbol{
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Adaptive multi-symbol arithmetic coding backend (AV1-style), as an alternative to the binary CABAC engine. A symbol
+    // of an alphabet of up to maxAlphabetSize letters is coded in a single step of a range coder with the cumulative
+    // distribution function (CDF) of its context, instead of one engine step per bin.
+    static const unsigned int maxAlphabetSize = 16;
+    static const unsigned int cdfBits = 15;
+    static const uint32_t cdfTotal = 1u << cdfBits;
+    static const uint32_t minProb = 4;  // minimum frequency per letter, such that no letter gets a zero-size interval
+
+    // CDF adaptation: after each symbol, the CDF moves towards the coded symbol by 2^-rate of the remaining
+    // distance. The rate starts at rateInit (fast adaptation) and increases by one every countPerStep symbols up to
+    // rateFinal. The defaults match AV1 for alphabets of 4 and more letters.
+    struct CdfAdaptation {
+        explicit CdfAdaptation(const unsigned int rateInit = 5, const unsigned int rateFinal = 7,
+            const unsigned int countPerStep = 16)
+            : rateInit(rateInit), rateFinal(rateFinal), countPerStep(countPerStep)
+        {
+            if (rateInit == 0 || rateInit > rateFinal || rateFinal >= cdfBits || countPerStep == 0) {
+                throw std::runtime_error("CdfAdaptation: Requires 0 < rateInit <= rateFinal < 15 and countPerStep > 0");
+            }
+        }
+
+        unsigned int rateInit;
+        unsigned int rateFinal;
+        unsigned int countPerStep;
+    };
+
+    // Coding configuration of a sequence of symbols.
+    // Letters 0 ... alphabetSize-2 code the symbols directly. The last letter is an escape for symbols >= alphabetSize-1,
+    // followed by the remainder symbol - (alphabetSize-1) as EG0 bypass bits. The context of a symbol is selected by the
+    // previous order symbols (clipped to the last letter), i.e. there are alphabetSize^order contexts starting at
+    // ctxOffset.
+    struct Config {
+        Config(const unsigned int alphabetSize, const unsigned int order = 0, const unsigned int ctxOffset = 0)
+            : alphabetSize(alphabetSize), order(order), ctxOffset(ctxOffset), numContexts(1)
+        {
+            if (alphabetSize < 2 || alphabetSize > maxAlphabetSize) {
+                throw std::runtime_error("multiSymbol::Config: Alphabet size must be in [2, 16]");
+            }
+            if (order > 2) {
+                throw std::runtime_error("multiSymbol::Config: Order must be at most 2");
+            }
+            for (unsigned int o = 0; o < order; o++) {
+                numContexts *= alphabetSize;
+            }
+        }
+
+        unsigned int alphabetSize;
+        unsigned int order;
+        unsigned int ctxOffset;
+        unsigned int numContexts;  // derived
+    };
+
+    // CDF of one context. cdf[i] is the scaled probability of the letters 0 ... i, for i < alphabetSize-1.
+    class CdfContext {
+    public:
+        void init(const unsigned int alphabetSize) {
+            m_alphabetSize = alphabetSize;
+            m_count = 0;
+            for (unsigned int i = 0; i < maxAlphabetSize; i++) {
+                m_cdf[i] = static_cast<uint16_t>(i + 1 < alphabetSize ? cdfTotal * (i + 1) / alphabetSize : cdfTotal);
+            }
+        }
+
+        unsigned int getAlphabetSize() const { return m_alphabetSize; }
+
+        // Cumulative frequency of the letters below letter, with the minimum frequency minProb per letter.
+        // getCumFreq(alphabetSize) = cdfTotal.
+        uint32_t getCumFreq(const unsigned int letter) const {
+            const uint32_t cdf = letter == 0 ? 0 : m_cdf[letter - 1];
+            return ((cdf * (cdfTotal - m_alphabetSize * minProb)) >> cdfBits) + letter * minProb;
+        }
+
+        void update(const unsigned int letter, const CdfAdaptation& adaptation) {
+            const unsigned int rate = std::min(adaptation.rateInit + m_count / adaptation.countPerStep,
+                adaptation.rateFinal);
+            for (unsigned int i = 0; i + 1 < m_alphabetSize; i++) {
+                if (i >= letter) {
+                    m_cdf[i] = static_cast<uint16_t>(m_cdf[i] + ((cdfTotal - m_cdf[i]) >> rate));
+                } else {
+                    m_cdf[i] = static_cast<uint16_t>(m_cdf[i] - (m_cdf[i] >> rate));
+                }
+            }
+            if (adaptation.rateInit + m_count / adaptation.countPerStep < adaptation.rateFinal) {
+                m_count++;
+            }
+        }
+
+        uint16_t getCdf(const unsigned int i) const { return m_cdf[i]; }
+
+    private:
+        uint16_t m_cdf[maxAlphabetSize];
+        unsigned int m_alphabetSize;
+        unsigned int m_count;
+    };
+
+    inline unsigned int getContextId(const Config& config, const unsigned int * symbolsPrev) {
+        unsigned int ctxId = 0;
+        for (unsigned int o = 0; o < config.order; o++) {
+            ctxId = ctxId * config.alphabetSize + symbolsPrev[o];
+        }
+        return config.ctxOffset + ctxId;
+    }
+
+};  // namespace multiSymbol
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Sequence coders of the multi-symbol backend. They provide the same sequence API as cabacSimpleSequenceEncoder /
+// cabacSimpleSequenceDecoder (initCtx, start, encodeSymbols/decodeSymbols, finish, getBitstream), with a
+// multiSymbol::Config instead of a CodingConfig.
+// The range coder keeps a 32-bit range, normalized to at least 2^24, and a 33-bit low with carry propagation through
+// the pending 0xFF bytes.
+class multiSymbolSequenceEncoder {
+public:
+  multiSymbolSequenceEncoder() { start(); }
+
+  // Initializes numContexts contexts with uniform CDFs of alphabetSize letters
+  void initCtx(const unsigned int numContexts, const unsigned int alphabetSize,
+    const multiSymbol::CdfAdaptation& adaptation = multiSymbol::CdfAdaptation())
+  {
+    if (alphabetSize < 2 || alphabetSize > multiSymbol::maxAlphabetSize) {
+      throw std::runtime_error("initCtx: Alphabet size must be in [2, 16]");
+    }
+    m_ctx.resize(numContexts);
+    for (auto& ctx : m_ctx) {
+      ctx.init(alphabetSize);
+    }
+    m_adaptation = adaptation;
+  }
+
+  void start() {
+    m_low = 0;
+    m_range = 0xFFFFFFFFu;
+    m_cache = 0;
+    m_cacheSize = 1;
+    m_bytes.clear();
+  }
+
+  void finish() {
+    for (unsigned int i = 0; i < 5; i++) {
+      shiftLow();
+    }
+  }
+
+  const std::vector<uint8_t>& getBitstream() const { return m_bytes; }
+
+  // Codes letter with the CDF of context ctxId and adapts the CDF
+  void encodeLetter(const unsigned int letter, const unsigned int ctxId) {
+    multiSymbol::CdfContext& ctx = m_ctx[ctxId];
+    const uint32_t r = m_range >> multiSymbol::cdfBits;
+    const uint32_t cumFreq = ctx.getCumFreq(letter);
+    m_low += static_cast<uint64_t>(r) * cumFreq;
+    if (letter + 1 < ctx.getAlphabetSize()) {
+      m_range = r * (ctx.getCumFreq(letter + 1) - cumFreq);
+    } else {  // the last letter gets the remainder of the range
+      m_range -= r * cumFreq;
+    }
+    normalize();
+    ctx.update(letter, m_adaptation);
+  }
+
+  void encodeBinsEP(const uint64_t bins, const unsigned int numBins) {
+    for (unsigned int n = numBins; n > 0; n--) {
+      m_range >>= 1;
+      if ((bins >> (n - 1)) & 1) {
+        m_low += m_range;
+      }
+      normalize();
+    }
+  }
+
+  void encodeBinsEG0bypass(const uint64_t symbol) {
+    const uint64_t value = symbol + 1;  // not 0, since symbol is at most UINT64_MAX - escape
+    const unsigned int numBits = floorLog2(value);
+    encodeBinsEP(0, numBits);  // prefix: numBits zeros, followed by value with its leading one
+    encodeBinsEP(value, numBits + 1);
+  }
+
+  void encodeSymbol(const uint64_t symbol, const unsigned int ctxId, const multiSymbol::Config& config) {
+    const unsigned int escape = config.alphabetSize - 1;
+    if (symbol < escape) {
+      encodeLetter(static_cast<unsigned int>(symbol), ctxId);
+    } else {
+      encodeLetter(escape, ctxId);
+      encodeBinsEG0bypass(symbol - escape);
+    }
+  }
+
+  void encodeSymbols(const uint64_t * symbols, const unsigned int numSymbols, const multiSymbol::Config& config) {
+    if (config.ctxOffset + config.numContexts > m_ctx.size()) {
+      throw std::runtime_error("encodeSymbols: Not enough contexts initialized");
+    }
+    if (m_ctx[config.ctxOffset].getAlphabetSize() != config.alphabetSize) {
+      throw std::runtime_error("encodeSymbols: Contexts initialized with a different alphabet size");
+    }
+    unsigned int symbolsPrev[2] = {0, 0};  // clipped to the escape letter
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      encodeSymbol(symbols[i], multiSymbol::getContextId(config, symbolsPrev), config);
+      symbolsPrev[1] = symbolsPrev[0];
+      symbolsPrev[0] = static_cast<unsigned int>(std::min<uint64_t>(symbols[i], config.alphabetSize - 1));
+    }
+  }
+
+  const multiSymbol::CdfContext& getCtx(const unsigned int ctxId) const { return m_ctx[ctxId]; }
+
+private:
+  void normalize() {
+    while (m_range < (1u << 24)) {
+      m_range <<= 8;
+      shiftLow();
+    }
+  }
+
+  void shiftLow() {
+    if (static_cast<uint32_t>(m_low) < 0xFF000000u || (m_low >> 32) != 0) {
+      const uint8_t carry = static_cast<uint8_t>(m_low >> 32);
+      uint8_t byte = m_cache;
+      do {
+        m_bytes.push_back(static_cast<uint8_t>(byte + carry));
+        byte = 0xFF;
+      } while (--m_cacheSize != 0);
+      m_cache = static_cast<uint8_t>(m_low >> 24);
+    }
+    m_cacheSize++;
+    m_low = (m_low & 0x00FFFFFFu) << 8;
+  }
+
+  std::vector<multiSymbol::CdfContext> m_ctx;
+  multiSymbol::CdfAdaptation m_adaptation;
+  uint64_t m_low;
+  uint32_t m_range;
+  uint8_t m_cache;
+  uint64_t m_cacheSize;
+  std::vector<uint8_t> m_bytes;
+};
+
+
+class multiSymbolSequenceDecoder {
+public:
+  explicit multiSymbolSequenceDecoder(const std::vector<uint8_t>& bitstream) : m_bytes(bitstream), m_pos(0) {}
+
+  // see multiSymbolSequenceEncoder::initCtx
+  void initCtx(const unsigned int numContexts, const unsigned int alphabetSize,
+    const multiSymbol::CdfAdaptation& adaptation = multiSymbol::CdfAdaptation())
+  {
+    if (alphabetSize < 2 || alphabetSize > multiSymbol::maxAlphabetSize) {
+      throw std::runtime_error("initCtx: Alphabet size must be in [2, 16]");
+    }
+    m_ctx.resize(numContexts);
+    for (auto& ctx : m_ctx) {
+      ctx.init(alphabetSize);
+    }
+    m_adaptation = adaptation;
+  }
+
+  void start() {
+    m_range = 0xFFFFFFFFu;
+    m_code = 0;
+    for (unsigned int i = 0; i < 5; i++) {
+      m_code = (m_code << 8) | readByte();
+    }
+  }
+
+  void finish() {}
+
+  unsigned int decodeLetter(const unsigned int ctxId) {
+    multiSymbol::CdfContext& ctx = m_ctx[ctxId];
+    const uint32_t r = m_range >> multiSymbol::cdfBits;
+    const uint32_t value = m_code / r;
+    const unsigned int escape = ctx.getAlphabetSize() - 1;
+    unsigned int letter = 0;
+    uint32_t cumFreqNext = ctx.getCumFreq(1);
+    while (letter < escape && cumFreqNext <= value) {
+      letter++;
+      cumFreqNext = ctx.getCumFreq(letter + 1);
+    }
+    const uint32_t cumFreq = ctx.getCumFreq(letter);
+    m_code -= r * cumFreq;
+    if (letter < escape) {
+      m_range = r * (cumFreqNext - cumFreq);
+    } else {
+      m_range -= r * cumFreq;
+    }
+    normalize();
+    ctx.update(letter, m_adaptation);
+    return letter;
+  }
+
+  uint64_t decodeBinsEP(const unsigned int numBins) {
+    uint64_t bins = 0;
+    for (unsigned int n = 0; n < numBins; n++) {
+      m_range >>= 1;
+      const bool bin = m_code >= m_range;
+      if (bin) {
+        m_code -= m_range;
+      }
+      bins = (bins << 1) | bin;
+      normalize();
+    }
+    return bins;
+  }
+
+  uint64_t decodeBinsEG0bypass() {
+    unsigned int numBits = 0;
+    while (decodeBinsEP(1) == 0) {
+      if (++numBits > 63) {
+        throw std::runtime_error("decodeBinsEG0bypass: Invalid prefix");
+      }
+    }
+    return ((uint64_t(1) << numBits) | decodeBinsEP(numBits)) - 1;
+  }
+
+  uint64_t decodeSymbol(const unsigned int ctxId, const multiSymbol::Config& config) {
+    const unsigned int letter = decodeLetter(ctxId);
+    if (letter + 1 < config.alphabetSize) {
+      return letter;
+    }
+    return letter + decodeBinsEG0bypass();
+  }
+
+  void decodeSymbols(uint64_t * symbols, const unsigned int numSymbols, const multiSymbol::Config& config) {
+    if (config.ctxOffset + config.numContexts > m_ctx.size()) {
+      throw std::runtime_error("decodeSymbols: Not enough contexts initialized");
+    }
+    if (m_ctx[config.ctxOffset].getAlphabetSize() != config.alphabetSize) {
+      throw std::runtime_error("decodeSymbols: Contexts initialized with a different alphabet size");
+    }
+    unsigned int symbolsPrev[2] = {0, 0};
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      symbols[i] = decodeSymbol(multiSymbol::getContextId(config, symbolsPrev), config);
+      symbolsPrev[1] = symbolsPrev[0];
+      symbolsPrev[0] = static_cast<unsigned int>(std::min<uint64_t>(symbols[i], config.alphabetSize - 1));
+    }
+  }
+
+private:
+  uint8_t readByte() {
+    return m_pos < m_bytes.size() ? m_bytes[m_pos++] : 0;
+  }
+
+  void normalize() {
+    while (m_range < (1u << 24)) {
+      m_range <<= 8;
+      m_code = (m_code << 8) | readByte();
+    }
+  }
+
+  std::vector<multiSymbol::CdfContext> m_ctx;
+  multiSymbol::CdfAdaptation m_adaptation;
+  std::vector<uint8_t> m_bytes;
+  size_t m_pos;
+  uint32_t m_range;
+  uint32_t m_code;
+};
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_MULTI_SYMBOL_CODER_H__
@@ -0,0 +1,68 @@
+#ifndef __RWTH_PREDICTION_H__
+#define __RWTH_PREDICTION_H__
+
+#include "CommonDef.h"
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#if RWTH_PYTHON_IF
+namespace prediction{
+
+    enum class PredictorId : uint8_t {
+        NONE = 0,  // no prediction, the symbols are coded as they are
+        PREVIOUS = 1,  // x[i-lag]
+        LINEAR = 2  // linear extrapolation 2*x[i-lag] - x[i-2*lag]
+    };
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Prediction (DPCM) pre-stage of the sequence coders. Symbols are predicted from the previous symbols at lag and
+    // 2*lag, and the residuals are coded instead. Symbols without enough previous symbols fall back to PREVIOUS or to
+    // a prediction of 0.
+    // Prediction, residuals and reconstruction are computed modulo 2^(8*sizeof(T)), such that residuals always fit
+    // into T and the reconstruction is lossless for any T. Thus, unsigned symbols can be passed as signed symbols of the
+    // same width, e.g. uint8_t as int8_t.
+    class Predictor {
+    public:
+        explicit Predictor(const PredictorId predictorId = PredictorId::NONE, const unsigned int lag = 1)
+            : predictorId(predictorId), lag(lag)
+        {
+            if (lag == 0) {
+                throw std::runtime_error("Predictor: Lag must be at least 1");
+            }
+        }
+
+        // Prediction of symbols[i] from symbols[0..i-1]
+        template <typename T>
+        T predict(const T * symbols, const unsigned int i) const {
+            typedef typename std::make_unsigned<T>::type U;
+            if (predictorId == PredictorId::NONE || i < lag) {
+                return 0;
+            }
+            const U symbolPrev = static_cast<U>(symbols[i - lag]);
+            if (predictorId == PredictorId::PREVIOUS || i < 2 * lag) {
+                return static_cast<T>(symbolPrev);
+            }
+            return static_cast<T>(static_cast<U>(2 * symbolPrev - static_cast<U>(symbols[i - 2 * lag])));
+        }
+
+        template <typename T>
+        static T getResidual(const T symbol, const T prediction) {
+            typedef typename std::make_unsigned<T>::type U;
+            return static_cast<T>(static_cast<U>(static_cast<U>(symbol) - static_cast<U>(prediction)));
+        }
+
+        template <typename T>
+        static T reconstruct(const T residual, const T prediction) {
+            typedef typename std::make_unsigned<T>::type U;
+            return static_cast<T>(static_cast<U>(static_cast<U>(residual) + static_cast<U>(prediction)));
+        }
+
+        PredictorId predictorId;
+        unsigned int lag;
+    };
+
+};  // namespace prediction
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_PREDICTION_H__
@@ -0,0 +1,154 @@
+#include "rans_coder.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+#if RWTH_PYTHON_IF
+namespace rans{
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  std::vector<uint32_t> normalizeFrequencies(const std::vector<uint64_t>& counts) {
+    uint64_t total = 0;
+    for (const uint64_t count : counts) {
+      total += count;
+    }
+    std::vector<uint32_t> freqs(counts.size(), 0);
+    if (total == 0) {
+      return freqs;
+    }
+
+    uint32_t sum = 0;
+    for (size_t s = 0; s < counts.size(); s++) {
+      if (counts[s] > 0) {
+        freqs[s] = static_cast<uint32_t>(std::max<uint64_t>(1,
+          static_cast<uint64_t>(static_cast<double>(counts[s]) * scaleTotal / static_cast<double>(total))));
+        sum += freqs[s];
+      }
+    }
+
+    // Distribute the rounding error to the most frequent letters
+    while (sum != scaleTotal) {
+      const auto largest = std::max_element(freqs.begin(), freqs.end());
+      if (sum < scaleTotal) {
+        *largest += scaleTotal - sum;
+        sum = scaleTotal;
+      } else {
+        const uint32_t excess = std::min(sum - scaleTotal, *largest - 1);
+        if (excess == 0) {
+          throw std::runtime_error("normalizeFrequencies: Too many letters");
+        }
+        *largest -= excess;
+        sum -= excess;
+        if (sum != scaleTotal) {  // take the remaining excess from the other letters, one by one
+          for (auto& freq : freqs) {
+            if (freq > 1 && sum != scaleTotal) {
+              freq--;
+              sum--;
+            }
+          }
+        }
+      }
+    }
+    return freqs;
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  Config::Config(const unsigned int alphabetSize, const unsigned int numStates, const std::vector<uint64_t>& staticFreqs)
+    : alphabetSize(alphabetSize), numStates(numStates)
+  {
+    if (alphabetSize == 0 || alphabetSize > maxAlphabetSize) {
+      throw std::runtime_error("rans::Config: Alphabet size must be in [1, 4096]");
+    }
+    if (numStates != 4 && numStates != 8) {
+      throw std::runtime_error("rans::Config: Number of states must be 4 or 8");
+    }
+    if (!staticFreqs.empty()) {
+      if (staticFreqs.size() != alphabetSize) {
+        throw std::runtime_error("rans::Config: One static frequency per letter required");
+      }
+      freqs = normalizeFrequencies(staticFreqs);
+      if (std::all_of(freqs.begin(), freqs.end(), [](const uint32_t freq) { return freq == 0; })) {
+        throw std::runtime_error("rans::Config: Static frequencies must not be all zero");
+      }
+    }
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  static void writeLEB128(uint32_t value, std::vector<uint8_t>& bytes) {
+    while (value >= 0x80) {
+      bytes.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+  }
+
+  static uint32_t readLEB128(const std::vector<uint8_t>& bytes, size_t& pos) {
+    uint32_t value = 0;
+    for (unsigned int shift = 0; shift < 32; shift += 7) {
+      if (pos >= bytes.size()) {
+        throw std::runtime_error("readFrequencies: Bitstream exceeded");
+      }
+      const uint8_t byte = bytes[pos++];
+      value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    throw std::runtime_error("readFrequencies: Invalid LEB128 value");
+  }
+
+  void writeFrequencies(const std::vector<uint32_t>& freqs, std::vector<uint8_t>& bytes) {
+    for (size_t s = 0; s < freqs.size(); s++) {
+      writeLEB128(freqs[s], bytes);
+      if (freqs[s] == 0) {
+        size_t run = 0;
+        while (s + 1 < freqs.size() && freqs[s + 1] == 0) {
+          run++;
+          s++;
+        }
+        writeLEB128(static_cast<uint32_t>(run), bytes);
+      }
+    }
+  }
+
+  std::vector<uint32_t> readFrequencies(const unsigned int alphabetSize, const std::vector<uint8_t>& bytes,
+    size_t& pos) {
+    std::vector<uint32_t> freqs(alphabetSize, 0);
+    uint64_t sum = 0;
+    for (unsigned int s = 0; s < alphabetSize; s++) {
+      freqs[s] = readLEB128(bytes, pos);
+      if (freqs[s] > scaleTotal) {
+        throw std::runtime_error("readFrequencies: Frequency exceeds 2^scaleBits");
+      }
+      sum += freqs[s];
+      if (freqs[s] == 0) {
+        const uint32_t run = readLEB128(bytes, pos);
+        if (run >= alphabetSize - s) {
+          throw std::runtime_error("readFrequencies: Invalid run of zero frequencies");
+        }
+        s += run;
+      }
+    }
+    if (sum != scaleTotal && sum != 0) {
+      throw std::runtime_error("readFrequencies: Frequencies must sum up to 2^scaleBits");
+    }
+    return freqs;
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  std::vector<DecodingEntry> getDecodingTable(const std::vector<uint32_t>& freqs) {
+    std::vector<DecodingEntry> table(scaleTotal, DecodingEntry{1, 0, 0});
+    uint32_t cumFreq = 0;
+    for (size_t s = 0; s < freqs.size(); s++) {
+      for (uint32_t slot = cumFreq; slot < cumFreq + freqs[s]; slot++) {
+        table[slot] = DecodingEntry{static_cast<uint16_t>(freqs[s]), static_cast<uint16_t>(slot - cumFreq),
+          static_cast<uint16_t>(s)};
+      }
+      cumFreq += freqs[s];
+    }
+    return table;
+  }
+
+};  // namespace rans
+
+#endif  // RWTH_PYTHON_IF
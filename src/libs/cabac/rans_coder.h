@@ -0,0 +1,213 @@
+#ifndef __RWTH_RANS_CODER_H__
+#define __RWTH_RANS_CODER_H__
+
+#include "CommonDef.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if RWTH_PYTHON_IF
+namespace rans{
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Interleaved rANS backend with static or semi-static frequency tables, for (close to) stationary data, where the
+    // adaptation of the CABAC contexts does not pay off and decoding throughput matters.
+    // Frequencies are normalized to a total of 2^scaleBits. The 32-bit states are renormalized to [2^16, 2^32) with
+    // at most one 16-bit word per symbol, such that decoding is a table lookup per symbol without branches.
+    static const unsigned int scaleBits = 12;
+    static const uint32_t scaleTotal = 1u << scaleBits;
+    static const uint32_t stateLow = 1u << 16;
+    static const unsigned int maxAlphabetSize = scaleTotal;
+
+    // Normalizes counts to frequencies with a total of scaleTotal, where each letter with a non-zero count gets a
+    // non-zero frequency
+    std::vector<uint32_t> normalizeFrequencies(const std::vector<uint64_t>& counts);
+
+    // Coding configuration of a sequence of symbols in [0, alphabetSize).
+    // Without staticFreqs, the frequency table is semi-static: it is counted per encodeSymbols call and transmitted in
+    // a header in front of the coded symbols. With staticFreqs (counts of all letters, normalized here), the table is
+    // known to both sides and not transmitted.
+    // numStates: number of interleaved rANS states (4 or 8)
+    struct Config {
+        Config(const unsigned int alphabetSize, const unsigned int numStates = 4,
+            const std::vector<uint64_t>& staticFreqs = std::vector<uint64_t>());
+
+        unsigned int alphabetSize;
+        unsigned int numStates;
+        std::vector<uint32_t> freqs;  // normalized staticFreqs, empty for semi-static tables
+    };
+
+    // Header of the semi-static frequency tables: one LEB128 value per letter, where a zero frequency is followed by the
+    // number of additional letters with zero frequency. readFrequencies rejects tables which do not sum up to
+    // scaleTotal, except for the all-zero table of an empty sequence.
+    void writeFrequencies(const std::vector<uint32_t>& freqs, std::vector<uint8_t>& bytes);
+    std::vector<uint32_t> readFrequencies(const unsigned int alphabetSize, const std::vector<uint8_t>& bytes,
+        size_t& pos);
+
+    // Decoding table entry per slot in [0, scaleTotal)
+    struct DecodingEntry {
+        uint16_t freq;
+        uint16_t bias;  // slot - cumulative frequency of symbol
+        uint16_t symbol;
+    };
+
+    std::vector<DecodingEntry> getDecodingTable(const std::vector<uint32_t>& freqs);
+
+};  // namespace rans
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Sequence coders of the rANS backend, with the same symbol array API as cabacSimpleSequenceEncoder /
+// cabacSimpleSequenceDecoder (start, encodeSymbols/decodeSymbols, finish, getBitstream). Each encodeSymbols call
+// appends a self-contained block (header, final states and renormalization words), which is read by a decodeSymbols
+// call with the same configuration and number of symbols.
+class ransSequenceEncoder {
+public:
+  ransSequenceEncoder() {}
+
+  void start() { m_bytes.clear(); }
+  void finish() {}
+  const std::vector<uint8_t>& getBitstream() const { return m_bytes; }
+
+  void encodeSymbols(const uint64_t * symbols, const unsigned int numSymbols, const rans::Config& config)
+  {
+    std::vector<uint32_t> freqs = config.freqs;
+    if (freqs.empty()) {
+      std::vector<uint64_t> counts(config.alphabetSize, 0);
+      for (unsigned int i = 0; i < numSymbols; i++) {
+        if (symbols[i] >= config.alphabetSize) {
+          throw std::runtime_error("encodeSymbols: Symbol exceeds the alphabet size");
+        }
+        counts[symbols[i]]++;
+      }
+      freqs = rans::normalizeFrequencies(counts);
+      rans::writeFrequencies(freqs, m_bytes);
+    }
+    std::vector<uint32_t> cumFreqs(config.alphabetSize, 0);
+    for (unsigned int s = 1; s < config.alphabetSize; s++) {
+      cumFreqs[s] = cumFreqs[s - 1] + freqs[s - 1];
+    }
+
+    // Encode in reverse order, such that the decoder reads the words forwards
+    std::vector<uint32_t> states(config.numStates, rans::stateLow);
+    std::vector<uint16_t> words;
+    words.reserve(numSymbols / 2 + 2 * config.numStates);
+    for (unsigned int i = numSymbols; i > 0; i--) {
+      const uint64_t symbol = symbols[i - 1];
+      if (symbol >= config.alphabetSize || freqs[symbol] == 0) {
+        throw std::runtime_error("encodeSymbols: Symbol with zero frequency");
+      }
+      uint32_t& x = states[(i - 1) % config.numStates];
+      const uint32_t freq = freqs[symbol];
+      if (x >= (static_cast<uint64_t>(rans::stateLow >> rans::scaleBits) << 16) * freq) {
+        words.push_back(static_cast<uint16_t>(x));
+        x >>= 16;
+      }
+      x = ((x / freq) << rans::scaleBits) + (x % freq) + cumFreqs[symbol];
+    }
+    for (unsigned int j = config.numStates; j > 0; j--) {
+      words.push_back(static_cast<uint16_t>(states[j - 1]));
+      words.push_back(static_cast<uint16_t>(states[j - 1] >> 16));
+    }
+
+    m_bytes.reserve(m_bytes.size() + 2 * words.size());
+    for (size_t w = words.size(); w > 0; w--) {  // little-endian words
+      m_bytes.push_back(static_cast<uint8_t>(words[w - 1]));
+      m_bytes.push_back(static_cast<uint8_t>(words[w - 1] >> 8));
+    }
+  }
+
+private:
+  std::vector<uint8_t> m_bytes;
+};
+
+
+class ransSequenceDecoder {
+public:
+  explicit ransSequenceDecoder(const std::vector<uint8_t>& bitstream) : m_bytes(bitstream), m_pos(0) {}
+
+  void start() { m_pos = 0; }
+  void finish() {}
+
+  void decodeSymbols(uint64_t * symbols, const unsigned int numSymbols, const rans::Config& config)
+  {
+    std::vector<uint32_t> freqs = config.freqs;
+    if (freqs.empty()) {
+      freqs = rans::readFrequencies(config.alphabetSize, m_bytes, m_pos);
+      if (numSymbols > 0 && std::all_of(freqs.begin(), freqs.end(), [](const uint32_t freq) { return freq == 0; })) {
+        throw std::runtime_error("decodeSymbols: Frequencies must not be all zero");
+      }
+    }
+    const std::vector<rans::DecodingEntry> table = rans::getDecodingTable(freqs);
+
+    const uint8_t * begin = m_bytes.data() + m_pos;
+    const uint8_t * end = m_bytes.data() + m_bytes.size();
+    const uint8_t * ptr = nullptr;
+    switch (config.numStates) {
+      case 4: ptr = decodeKernel<4>(symbols, numSymbols, table.data(), begin, end); break;
+      case 8: ptr = decodeKernel<8>(symbols, numSymbols, table.data(), begin, end); break;
+      default:
+        throw std::runtime_error("decodeSymbols: Number of states must be 4 or 8");
+    }
+    m_pos += ptr - begin;
+  }
+
+private:
+  // Decodes from the little-endian words in [ptr, end) and returns the pointer behind the words read.
+  // The end of the bitstream is only checked once per numStates symbols, which read at most numStates words.
+  template <unsigned int numStates>
+  static const uint8_t * decodeKernel(uint64_t * symbols, const unsigned int numSymbols,
+    const rans::DecodingEntry * table, const uint8_t * ptr, const uint8_t * end)
+  {
+    if (end - ptr < 4 * static_cast<ptrdiff_t>(numStates)) {
+      throw std::runtime_error("decodeSymbols: Bitstream exceeded");
+    }
+    uint32_t states[numStates];
+    for (unsigned int j = 0; j < numStates; j++) {
+      states[j] = (static_cast<uint32_t>(readWord(ptr)) << 16) | readWord(ptr + 2);
+      ptr += 4;
+    }
+
+    unsigned int i = 0;
+    for (; i + numStates <= numSymbols && end - ptr >= 2 * static_cast<ptrdiff_t>(numStates); i += numStates) {
+      for (unsigned int j = 0; j < numStates; j++) {
+        symbols[i + j] = decodeStep(states[j], table, ptr);
+      }
+    }
+    for (unsigned int j = 0; i < numSymbols; i++, j = (j + 1) % numStates) {  // last symbols, checked per symbol
+      if (end - ptr < 2) {
+        uint8_t padding[2] = {0, 0};
+        const uint8_t * paddingPtr = padding;
+        symbols[i] = decodeStep(states[j], table, paddingPtr);
+        if (paddingPtr != padding) {
+          throw std::runtime_error("decodeSymbols: Bitstream exceeded");
+        }
+      } else {
+        symbols[i] = decodeStep(states[j], table, ptr);
+      }
+    }
+    return ptr;
+  }
+
+  static uint16_t readWord(const uint8_t * ptr) {
+    return static_cast<uint16_t>(ptr[0] | (ptr[1] << 8));
+  }
+
+  static uint64_t decodeStep(uint32_t& x, const rans::DecodingEntry * table, const uint8_t *& ptr)
+  {
+    const rans::DecodingEntry entry = table[x & (rans::scaleTotal - 1)];
+    x = entry.freq * (x >> rans::scaleBits) + entry.bias;
+    const uint32_t renorm = x < rans::stateLow;  // without branch: shift by 0 or 16, and mask the word
+    x = (x << (renorm << 4)) | (readWord(ptr) & (0u - renorm));
+    ptr += renorm << 1;
+    return entry.symbol;
+  }
+
+  std::vector<uint8_t> m_bytes;
+  size_t m_pos;
+};
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_RANS_CODER_H__
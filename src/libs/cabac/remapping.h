@@ -0,0 +1,121 @@
+#ifndef __RWTH_REMAPPING_H__
+#define __RWTH_REMAPPING_H__
+
+#include "CommonDef.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#if RWTH_PYTHON_IF
+namespace remapping{
+
+    enum class RemapperId : uint8_t {
+        NONE = 0,  // no remapping, the symbols are coded as they are
+        FREQUENCY = 1,  // rank in a table of adaptive symbol frequencies
+        MTF = 2  // position in a move-to-front list
+    };
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Adaptive remapping stage of the sequence coders. Each symbol in [0, alphabetSize) is replaced by its current rank,
+    // such that frequent (FREQUENCY) or recently used (MTF) symbols get small values, i.e. the shortest TU/EGk bin
+    // strings. The table is updated after each symbol, identically on the encoder and decoder side. Initially, the
+    // rank of each symbol is the symbol itself.
+    // The state persists across calls, such that a sequence can be coded in chunks. reset() restores the initial state.
+    class SymbolRemapper {
+    public:
+        explicit SymbolRemapper(const RemapperId remapperId = RemapperId::NONE, const unsigned int alphabetSize = 0)
+            : remapperId(remapperId), alphabetSize(alphabetSize)
+        {
+            if (remapperId != RemapperId::NONE && alphabetSize == 0) {
+                throw std::runtime_error("SymbolRemapper: Alphabet size must be at least 1");
+            }
+            reset();
+        }
+
+        void reset() {
+            const unsigned int size = remapperId == RemapperId::NONE ? 0 : alphabetSize;
+            m_symbols.resize(size);
+            m_ranks.resize(size);
+            m_counts.assign(remapperId == RemapperId::FREQUENCY ? size : 0, 0);
+            for (unsigned int s = 0; s < size; s++) {
+                m_symbols[s] = s;
+                m_ranks[s] = s;
+            }
+        }
+
+        // Encoder side: rank of symbol, followed by the update
+        uint64_t getRank(const uint64_t symbol) {
+            if (remapperId == RemapperId::NONE) {
+                return symbol;
+            }
+            if (symbol >= alphabetSize) {
+                throw std::runtime_error("SymbolRemapper: Symbol exceeds the alphabet size");
+            }
+            const unsigned int rank = m_ranks[symbol];
+            update(rank);
+            return rank;
+        }
+
+        // Decoder side: symbol of rank, followed by the update
+        uint64_t getSymbol(const uint64_t rank) {
+            if (remapperId == RemapperId::NONE) {
+                return rank;
+            }
+            if (rank >= alphabetSize) {
+                throw std::runtime_error("SymbolRemapper: Rank exceeds the alphabet size");
+            }
+            const unsigned int symbol = m_symbols[rank];
+            update(static_cast<unsigned int>(rank));
+            return symbol;
+        }
+
+        RemapperId remapperId;
+        unsigned int alphabetSize;
+
+    private:
+        // Swap the table entries at rank a and b
+        void swapRanks(const unsigned int a, const unsigned int b) {
+            std::swap(m_symbols[a], m_symbols[b]);
+            m_ranks[m_symbols[a]] = a;
+            m_ranks[m_symbols[b]] = b;
+        }
+
+        void update(unsigned int rank) {
+            if (remapperId == RemapperId::MTF) {
+                const unsigned int symbol = m_symbols[rank];
+                for (; rank > 0; rank--) {
+                    m_symbols[rank] = m_symbols[rank - 1];
+                    m_ranks[m_symbols[rank]] = rank;
+                }
+                m_symbols[0] = symbol;
+                m_ranks[symbol] = 0;
+                return;
+            }
+
+            // FREQUENCY: the counts are sorted in descending order. Before the increment, the symbol is swapped with
+            // the first symbol of equal count, such that the order is retained (O(log(alphabetSize)) per symbol).
+            const unsigned int first = static_cast<unsigned int>(std::lower_bound(m_counts.begin(), m_counts.begin() + rank,
+                m_counts[rank], std::greater<uint32_t>()) - m_counts.begin());
+            if (first != rank) {
+                swapRanks(first, rank);
+            }
+            if (++m_counts[first] == maxCount) { // halve the counts to follow changing statistics
+                for (auto& count : m_counts) {
+                    count >>= 1;
+                }
+            }
+        }
+
+        static const uint32_t maxCount = 1 << 16;
+
+        std::vector<uint32_t> m_symbols;  // symbol per rank
+        std::vector<uint32_t> m_ranks;  // rank per symbol
+        std::vector<uint32_t> m_counts;  // count per rank, FREQUENCY only
+    };
+
+};  // namespace remapping
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_REMAPPING_H__
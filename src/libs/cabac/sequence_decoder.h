@@ -1,105 +1,466 @@
 #pragma once
 
 #include "CommonDef.h"
+#include <algorithm>
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
 #if RWTH_PYTHON_IF
+#include "coding_config.h"
 #include "context_selector.h"
 #include "binarization.h"
+#include "prediction.h"
+#include "remapping.h"
+#include "transform.h"
 #include "symbol_decoder.h"
 
 
-typedef uint64_t (cabacSymbolDecoder::*binReader)(const std::vector<unsigned int>&, std::vector<unsigned int>);
-typedef uint64_t (cabacSymbolDecoder::*binBypassReader)(std::vector<unsigned int>);
+class cabacSimpleSequenceDecoder;
+typedef void (cabacSimpleSequenceDecoder::*symbolsReader)(uint64_t *, const unsigned int, const CodingConfig&);
+template <typename T>
+using signedSymbolsReader = void (cabacSimpleSequenceDecoder::*)(T *, const unsigned int, const CodingConfig&,
+  const binarization::SignMode, const prediction::Predictor&);
+typedef void (cabacSimpleSequenceDecoder::*remappedSymbolsReader)(uint64_t *, const unsigned int, const CodingConfig&,
+  remapping::SymbolRemapper&);
 
 class cabacSimpleSequenceDecoder : public cabacSymbolDecoder{
   public:
     cabacSimpleSequenceDecoder(std::vector<uint8_t> bs) : cabacSymbolDecoder(bs){}
 
-    binReader getReader(binarization::BinarizationId binId)
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decode bins of a symbol for given binarization, with context IDs provided per bin by ctxIds (see getCtxId).
+    // Selects the binarization at run time, see decodeBins<binId> below.
+    template <class CtxProvider>
+    uint64_t decodeBins(const CodingConfig& config, const CtxProvider &ctxIds)
     {
-      binReader func = nullptr;
-      switch(binId){
-        case binarization::BinarizationId::BI:{
-          func = &cabacSimpleSequenceDecoder::decodeBinsBI;
-        } break;
+      switch(config.binId){
+        case binarization::BinarizationId::BI: {
+          return decodeBins<binarization::BinarizationId::BI>(config, ctxIds);
+        }
         case binarization::BinarizationId::TU: {
-          func = &cabacSimpleSequenceDecoder::decodeBinsTU;
-        } break;
+          return decodeBins<binarization::BinarizationId::TU>(config, ctxIds);
+        }
         case binarization::BinarizationId::EGk: {
-          func = &cabacSimpleSequenceDecoder::decodeBinsEGk;
-        } break;
-        case binarization::BinarizationId::NA: {
-          func = &cabacSimpleSequenceDecoder::decodeBinsNA;
-        } break;
+          return decodeBins<binarization::BinarizationId::EGk>(config, ctxIds);
+        }
         case binarization::BinarizationId::RICE: {
-          throw std::runtime_error("getReader: Binarization RICE not supported with context-adaptive coding");
-        } break;
+          return decodeBins<binarization::BinarizationId::RICE>(config, ctxIds);
+        }
+        case binarization::BinarizationId::TB: {
+          return decodeBins<binarization::BinarizationId::TB>(config, ctxIds);
+        }
+        case binarization::BinarizationId::UEGk: {
+          return decodeBins<binarization::BinarizationId::UEGk>(config, ctxIds);
+        }
         default:
-          throw std::runtime_error("getReader: Unknown binarization ID");
+          throw std::runtime_error("decodeBins: Binarization not supported with context-adaptive coding");
       }
-      return func;
     }
 
-    binBypassReader getBypassReader(binarization::BinarizationId binId)
+    // Binarization fixed at compile time
+    template <binarization::BinarizationId binId, class CtxProvider>
+    uint64_t decodeBins(const CodingConfig& config, const CtxProvider &ctxIds)
     {
-      binBypassReader func = nullptr;
       switch(binId){
-        case binarization::BinarizationId::BI:{
-          func = &cabacSimpleSequenceDecoder::decodeBinsBIbypass;
-        } break;
+        case binarization::BinarizationId::BI: {
+          return decodeBinsBI(ctxIds, config.numMaxBins);
+        }
         case binarization::BinarizationId::TU: {
-          func = &cabacSimpleSequenceDecoder::decodeBinsTUbypass;
-        } break;
+          return decodeBinsTU(ctxIds, config.numMaxBins);
+        }
         case binarization::BinarizationId::EGk: {
-          func = &cabacSimpleSequenceDecoder::decodeBinsEGkbypass;
-        } break;
-        case binarization::BinarizationId::NA: {
-          func = &cabacSimpleSequenceDecoder::decodeBinsNAbypass;
-        } break;
+          return decodeBinsEGk(config.k, ctxIds);
+        }
         case binarization::BinarizationId::RICE: {
-          func = &cabacSimpleSequenceDecoder::decodeBinsRicebypass;
-        } break;
+          return decodeBinsRICE(ctxIds, config.riceParam, config.cutoff, config.maxLog2TrDynamicRange);
+        }
+        case binarization::BinarizationId::TB: {
+          return decodeBinsTB(ctxIds, config.numMaxBins);
+        }
+        case binarization::BinarizationId::UEGk: {
+          return decodeBinsUEGk(ctxIds, config.numMaxBins, config.k);
+        }
         default:
-          throw std::runtime_error("getBypassReader: Unknown binarization ID");
+          throw std::runtime_error("decodeBins: Binarization not supported with context-adaptive coding");
       }
-      return func;
     }
 
     // ---------------------------------------------------------------------------------------------------------------------
-    // This is a general method for decoding a sequence of symbols for given binarization and context model
-    // parameter definition see encodeSymbols
-    void decodeSymbols(uint64_t * symbols, const unsigned int numSymbols,
-      binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId,
-      const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams)
+    // Bypass-decode bins of a symbol for given binarization, selected at run time, see decodeBinsBypass<binId> below
+    uint64_t decodeBinsBypass(const CodingConfig& config)
     {
-      // Allocate memory
-      auto order = ctxParams[0];
-      std::vector<uint64_t> symbolsPrev(order, 0);
-      const unsigned int numMaxBins = binParams[0];
-      std::vector<unsigned int> ctxIds(numMaxBins, 0);
+      switch(config.binId){
+        case binarization::BinarizationId::BI: {
+          return decodeBinsBypass<binarization::BinarizationId::BI>(config);
+        }
+        case binarization::BinarizationId::TU: {
+          return decodeBinsBypass<binarization::BinarizationId::TU>(config);
+        }
+        case binarization::BinarizationId::EGk: {
+          return decodeBinsBypass<binarization::BinarizationId::EGk>(config);
+        }
+        case binarization::BinarizationId::NA: {
+          return decodeBinsBypass<binarization::BinarizationId::NA>(config);
+        }
+        case binarization::BinarizationId::RICE: {
+          return decodeBinsBypass<binarization::BinarizationId::RICE>(config);
+        }
+        case binarization::BinarizationId::TB: {
+          return decodeBinsBypass<binarization::BinarizationId::TB>(config);
+        }
+        case binarization::BinarizationId::UEGk: {
+          return decodeBinsBypass<binarization::BinarizationId::UEGk>(config);
+        }
+        default:
+          throw std::runtime_error("decodeBinsBypass: Unknown binarization ID");
+      }
+    }
+
+    // Binarization fixed at compile time
+    template <binarization::BinarizationId binId>
+    uint64_t decodeBinsBypass(const CodingConfig& config)
+    {
+      switch(binId){
+        case binarization::BinarizationId::BI: {
+          return decodeBinsBIbypass(config.numMaxBins);
+        }
+        case binarization::BinarizationId::TU: {
+          return decodeBinsTUbypass(config.numMaxBins);
+        }
+        case binarization::BinarizationId::EGk: {
+          return decodeBinsEGkbypass(config.k);
+        }
+        case binarization::BinarizationId::NA: {
+          return decodeBinEP();
+        }
+        case binarization::BinarizationId::TB: {
+          return decodeBinsTBbypass(config.numMaxBins);
+        }
+        case binarization::BinarizationId::UEGk: {
+          return decodeBinsUEGkbypass(config.numMaxBins, config.k);
+        }
+        default: { // RICE
+          return decodeRemAbsEP(config.riceParam, config.cutoff, config.maxLog2TrDynamicRange);
+        }
+      }
+    }
 
-      // Get reader
-      binReader func = getReader(binId);
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decoding kernels, specialized per binarization, context model (without symbol position) and order,
+    // see cabacSimpleSequenceEncoder::encodeSymbolsKernel
+    template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+    void decodeSymbolsKernel(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config)
+    {
+      uint64_t symbolsPrev[3] = {0, 0, 0};
+      contextSelector::TContextIdProvider<binId, ctxModelId0, order> ctxIds(config);
+      binarization::RiceParamAdaptation riceAdaptation(config.riceParam, config.maxLog2TrDynamicRange);
 
       for (unsigned int i = 0; i < numSymbols; i++) {
-        // Get context ids for each bin
+        // Prepare context ids of current symbol
         for (unsigned int o = 0; o < order; o++) {
           if (i > o) {
             symbolsPrev[o] = symbols[i-o - 1];
           }
         }
-        contextSelector::getContextIds(ctxIds, i, symbolsPrev.data(), binId, ctxModelId, binParams, ctxParams);
+        ctxIds.setSymbol(i, symbolsPrev);
 
         // Decode bins
-        symbols[i] = (*this.*func)(ctxIds, binParams);
+        if (binId == binarization::BinarizationId::RICE) { // Rice parameter adapted to the previously coded symbols
+          const unsigned int set = binarization::RiceParamAdaptation::getSet(symbolsPrev[0]);
+          symbols[i] = decodeBinsRICE(ctxIds, riceAdaptation.getRiceParam(set), config.cutoff, config.maxLog2TrDynamicRange);
+          riceAdaptation.update(set, symbols[i]);
+        } else {
+          symbols[i] = decodeBins<binId>(config, ctxIds);
+        }
+      }
+    }
+
+    template <binarization::BinarizationId binId>
+    void decodeSymbolsBypassKernel(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config)
+    {
+      for (unsigned int i = 0; i < numSymbols; i++) {
+        symbols[i] = decodeBinsBypass<binId>(config);
+      }
+    }
+
+    // Kernel selection, shared by the plain, signed and remapped kernels: returns the member function pointer (of type
+    // Reader) of Kernel<binId, ctxModelId0, order>::get() for context-adaptive coding, or of
+    // BypassKernel<binId>::get() for bypass coding.
+    template <typename Reader,
+      template <binarization::BinarizationId, contextSelector::ContextModelId, unsigned int> class Kernel,
+      binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0>
+    static Reader getReaderOrder(const unsigned int order)
+    {
+      switch(order){
+        case 1: return Kernel<binId, ctxModelId0, 1>::get();
+        case 2: return Kernel<binId, ctxModelId0, 2>::get();
+        case 3: return Kernel<binId, ctxModelId0, 3>::get();
+        default:
+          throw std::runtime_error("getReader: Order must be at most 3");
+      }
+    }
+
+    template <typename Reader,
+      template <binarization::BinarizationId, contextSelector::ContextModelId, unsigned int> class Kernel,
+      binarization::BinarizationId binId>
+    static Reader getReaderContextModel(const CodingConfig& config)
+    {
+      switch(config.ctxModelId0){
+        // The order does not affect the context IDs of BAC and BINPOSITION
+        case contextSelector::ContextModelId::BAC:
+          return Kernel<binId, contextSelector::ContextModelId::BAC, 1>::get();
+        case contextSelector::ContextModelId::BINPOSITION:
+          return Kernel<binId, contextSelector::ContextModelId::BINPOSITION, 1>::get();
+        case contextSelector::ContextModelId::BINSORDERN:
+          return getReaderOrder<Reader, Kernel, binId, contextSelector::ContextModelId::BINSORDERN>(config.order);
+        case contextSelector::ContextModelId::SYMBOLORDERN:
+          return getReaderOrder<Reader, Kernel, binId, contextSelector::ContextModelId::SYMBOLORDERN>(config.order);
+        default:
+          throw std::runtime_error("getReader: Unknown context model ID");
+      }
+    }
+
+    template <typename Reader,
+      template <binarization::BinarizationId, contextSelector::ContextModelId, unsigned int> class Kernel>
+    static Reader getReader(const CodingConfig& config)
+    {
+      switch(config.binId){
+        case binarization::BinarizationId::BI:
+          return getReaderContextModel<Reader, Kernel, binarization::BinarizationId::BI>(config);
+        case binarization::BinarizationId::TU:
+          return getReaderContextModel<Reader, Kernel, binarization::BinarizationId::TU>(config);
+        case binarization::BinarizationId::EGk:
+          return getReaderContextModel<Reader, Kernel, binarization::BinarizationId::EGk>(config);
+        case binarization::BinarizationId::RICE:
+          return getReaderContextModel<Reader, Kernel, binarization::BinarizationId::RICE>(config);
+        case binarization::BinarizationId::TB:
+          return getReaderContextModel<Reader, Kernel, binarization::BinarizationId::TB>(config);
+        case binarization::BinarizationId::UEGk:
+          return getReaderContextModel<Reader, Kernel, binarization::BinarizationId::UEGk>(config);
+        default:
+          throw std::runtime_error("getReader: Binarization not supported with context-adaptive coding");
+      }
+    }
+
+    template <typename Reader, template <binarization::BinarizationId> class BypassKernel>
+    static Reader getBypassReader(const CodingConfig& config)
+    {
+      switch(config.binId){
+        case binarization::BinarizationId::BI:
+          return BypassKernel<binarization::BinarizationId::BI>::get();
+        case binarization::BinarizationId::TU:
+          return BypassKernel<binarization::BinarizationId::TU>::get();
+        case binarization::BinarizationId::EGk:
+          return BypassKernel<binarization::BinarizationId::EGk>::get();
+        case binarization::BinarizationId::NA:
+          return BypassKernel<binarization::BinarizationId::NA>::get();
+        case binarization::BinarizationId::RICE:
+          return BypassKernel<binarization::BinarizationId::RICE>::get();
+        case binarization::BinarizationId::TB:
+          return BypassKernel<binarization::BinarizationId::TB>::get();
+        case binarization::BinarizationId::UEGk:
+          return BypassKernel<binarization::BinarizationId::UEGk>::get();
+        default:
+          throw std::runtime_error("getBypassReader: Unknown binarization ID");
       }
     }
 
+    template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+    struct SymbolsKernel {
+      static symbolsReader get() { return &cabacSimpleSequenceDecoder::decodeSymbolsKernel<binId, ctxModelId0, order>; }
+    };
+
+    template <binarization::BinarizationId binId>
+    struct SymbolsBypassKernel {
+      static symbolsReader get() { return &cabacSimpleSequenceDecoder::decodeSymbolsBypassKernel<binId>; }
+    };
+
+    static symbolsReader getSymbolsReader(const CodingConfig& config)
+    {
+      return getReader<symbolsReader, SymbolsKernel>(config);
+    }
+
+    static symbolsReader getSymbolsBypassReader(const CodingConfig& config)
+    {
+      return getBypassReader<symbolsReader, SymbolsBypassKernel>(config);
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decoding kernels for signed symbols of type T, see cabacSimpleSequenceEncoder::encodeSignedSymbolsKernel
+    bool decodeSignBin(const binarization::SignMode signMode, const unsigned int ctxId)
+    {
+      if (signMode == binarization::SignMode::SIGNCONTEXT) {
+        return decodeBin(ctxId) != 0;
+      }
+      return decodeBinEP() != 0;
+    }
+
+    template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order,
+      typename T>
+    void decodeSignedSymbolsKernel(T * symbols, const unsigned int numSymbols, const CodingConfig& config,
+      const binarization::SignMode signMode, const prediction::Predictor& predictor)
+    {
+      uint64_t symbolsPrev[3] = {0, 0, 0};  // unsigned values of the previous symbols
+      unsigned int signClassPrev = 0;
+      contextSelector::TContextIdProvider<binId, ctxModelId0, order> ctxIds(config);
+      binarization::RiceParamAdaptation riceAdaptation(config.riceParam, config.maxLog2TrDynamicRange);
+
+      for (unsigned int i = 0; i < numSymbols; i++) {
+        ctxIds.setSymbol(i, symbolsPrev);
+
+        uint64_t symbol = 0;
+        if (binId == binarization::BinarizationId::RICE) {
+          const unsigned int set = binarization::RiceParamAdaptation::getSet(symbolsPrev[0]);
+          symbol = decodeBinsRICE(ctxIds, riceAdaptation.getRiceParam(set), config.cutoff, config.maxLog2TrDynamicRange);
+          riceAdaptation.update(set, symbol);
+        } else {
+          symbol = decodeBins<binId>(config, ctxIds);
+        }
+        bool negative = false;
+        if (signMode != binarization::SignMode::ZIGZAG && symbol != 0) {
+          negative = decodeSignBin(signMode, config.getSignContextId(signClassPrev));
+        }
+        const int64_t value = binarization::getSignedValue(symbol, negative, signMode);
+        symbols[i] = prediction::Predictor::reconstruct(static_cast<T>(value), predictor.predict(symbols, i));
+
+        for (unsigned int o = order - 1; o > 0; o--) {
+          symbolsPrev[o] = symbolsPrev[o - 1];
+        }
+        symbolsPrev[0] = symbol;
+        signClassPrev = binarization::getSignClass(value);
+      }
+    }
+
+    template <binarization::BinarizationId binId, typename T>
+    void decodeSignedSymbolsBypassKernel(T * symbols, const unsigned int numSymbols, const CodingConfig& config,
+      const binarization::SignMode signMode, const prediction::Predictor& predictor)
+    {
+      unsigned int signClassPrev = 0;
+      for (unsigned int i = 0; i < numSymbols; i++) {
+        const uint64_t symbol = decodeBinsBypass<binId>(config);
+        bool negative = false;
+        if (signMode != binarization::SignMode::ZIGZAG && symbol != 0) {
+          negative = decodeSignBin(signMode, config.getSignContextId(signClassPrev));
+        }
+        const int64_t value = binarization::getSignedValue(symbol, negative, signMode);
+        symbols[i] = prediction::Predictor::reconstruct(static_cast<T>(value), predictor.predict(symbols, i));
+        signClassPrev = binarization::getSignClass(value);
+      }
+    }
+
+    template <typename T>
+    struct SignedSymbolsKernels {
+      template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+      struct Kernel {
+        static signedSymbolsReader<T> get()
+        {
+          return &cabacSimpleSequenceDecoder::decodeSignedSymbolsKernel<binId, ctxModelId0, order, T>;
+        }
+      };
+
+      template <binarization::BinarizationId binId>
+      struct BypassKernel {
+        static signedSymbolsReader<T> get()
+        {
+          return &cabacSimpleSequenceDecoder::decodeSignedSymbolsBypassKernel<binId, T>;
+        }
+      };
+    };
+
+    template <typename T>
+    static signedSymbolsReader<T> getSignedSymbolsReader(const CodingConfig& config)
+    {
+      if (config.bypass) {
+        return getBypassReader<signedSymbolsReader<T>, SignedSymbolsKernels<T>::template BypassKernel>(config);
+      }
+      return getReader<signedSymbolsReader<T>, SignedSymbolsKernels<T>::template Kernel>(config);
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decoding kernels with adaptive remapping, see cabacSimpleSequenceEncoder::encodeRemappedSymbolsKernel
+    template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+    void decodeRemappedSymbolsKernel(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config,
+      remapping::SymbolRemapper& remapper)
+    {
+      uint64_t symbolsPrev[3] = {0, 0, 0};  // ranks of the previous symbols
+      contextSelector::TContextIdProvider<binId, ctxModelId0, order> ctxIds(config);
+      binarization::RiceParamAdaptation riceAdaptation(config.riceParam, config.maxLog2TrDynamicRange);
+
+      for (unsigned int i = 0; i < numSymbols; i++) {
+        ctxIds.setSymbol(i, symbolsPrev);
+
+        uint64_t symbol;
+        if (binId == binarization::BinarizationId::RICE) {
+          const unsigned int set = binarization::RiceParamAdaptation::getSet(symbolsPrev[0]);
+          symbol = decodeBinsRICE(ctxIds, riceAdaptation.getRiceParam(set), config.cutoff, config.maxLog2TrDynamicRange);
+          riceAdaptation.update(set, symbol);
+        } else {
+          symbol = decodeBins<binId>(config, ctxIds);
+        }
+        symbols[i] = remapper.getSymbol(symbol);
+
+        for (unsigned int o = order - 1; o > 0; o--) {
+          symbolsPrev[o] = symbolsPrev[o - 1];
+        }
+        symbolsPrev[0] = symbol;
+      }
+    }
+
+    template <binarization::BinarizationId binId>
+    void decodeRemappedSymbolsBypassKernel(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config,
+      remapping::SymbolRemapper& remapper)
+    {
+      for (unsigned int i = 0; i < numSymbols; i++) {
+        symbols[i] = remapper.getSymbol(decodeBinsBypass<binId>(config));
+      }
+    }
+
+    template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+    struct RemappedSymbolsKernel {
+      static remappedSymbolsReader get()
+      {
+        return &cabacSimpleSequenceDecoder::decodeRemappedSymbolsKernel<binId, ctxModelId0, order>;
+      }
+    };
+
+    template <binarization::BinarizationId binId>
+    struct RemappedSymbolsBypassKernel {
+      static remappedSymbolsReader get()
+      {
+        return &cabacSimpleSequenceDecoder::decodeRemappedSymbolsBypassKernel<binId>;
+      }
+    };
+
+    static remappedSymbolsReader getRemappedSymbolsReader(const CodingConfig& config)
+    {
+      if (config.bypass) {
+        return getBypassReader<remappedSymbolsReader, RemappedSymbolsBypassKernel>(config);
+      }
+      return getReader<remappedSymbolsReader, RemappedSymbolsKernel>(config);
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // This is a general method for decoding a sequence of symbols for given binarization and context model
+    // parameter definition see encodeSymbols
+    void decodeSymbols(uint64_t * symbols, const unsigned int numSymbols,
+      binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId,
+      const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
+    {
+      decodeSymbols(symbols, numSymbols, CodingConfig(binId, ctxModelId, binParams, ctxParams));
+    }
+
+    // Same as above, with binarization and context model given by a (validated) coding configuration
+    // Context IDs are computed lazily, only for the bins actually decoded
+    void decodeSymbols(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config)
+    {
+      const symbolsReader kernel = getSymbolsReader(config);
+      (this->*kernel)(symbols, numSymbols, config);
+    }
+
     std::vector<uint64_t> decodeSymbols(const unsigned int numSymbols, 
       binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId,
-      const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams)
+      const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
     {
       // Allocate memory
       std::vector<uint64_t> symbols(numSymbols, 0);
@@ -115,19 +476,19 @@ class cabacSimpleSequenceDecoder : public cabacSymbolDecoder{
     // This is a general method for bypass decoding a sequence of symbols for given binarization
     // parameter definition see encodeSymbols
     void decodeSymbolsBypass(uint64_t * symbols, const unsigned int numSymbols,
-      binarization::BinarizationId binId, const std::vector<unsigned int> binParams)
+      binarization::BinarizationId binId, const std::vector<unsigned int>& binParams)
     {
-      // Get reader
-      binBypassReader func = getBypassReader(binId);
+      decodeSymbolsBypass(symbols, numSymbols, CodingConfig(binId, binParams));
+    }
 
-      // Decode bins
-      for (unsigned int i = 0; i < numSymbols; i++) {
-        symbols[i] = (*this.*func)(binParams);
-      }
+    void decodeSymbolsBypass(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config)
+    {
+      const symbolsReader kernel = getSymbolsBypassReader(config);
+      (this->*kernel)(symbols, numSymbols, config);
     }
 
     std::vector<uint64_t> decodeSymbolsBypass(const unsigned int numSymbols, 
-      binarization::BinarizationId binId, const std::vector<unsigned int> binParams)
+      binarization::BinarizationId binId, const std::vector<unsigned int>& binParams)
     {
       // Allocate memory
       std::vector<uint64_t> symbols(numSymbols, 0);
@@ -139,35 +500,162 @@ class cabacSimpleSequenceDecoder : public cabacSymbolDecoder{
       return symbols;
     }
 
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decodes a sequence of signed symbols of type T, see cabacSimpleSequenceEncoder::encodeSymbolsSigned
+    // With a predictor, the symbols are reconstructed from the decoded residuals in the decoding loop.
+    template <typename T>
+    void decodeSymbolsSigned(T * symbols, const unsigned int numSymbols, const CodingConfig& config,
+      const binarization::SignMode signMode, const prediction::Predictor& predictor = prediction::Predictor())
+    {
+      static_assert(std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) <= 8,
+        "decodeSymbolsSigned: Signed integer symbols required");
+      const signedSymbolsReader<T> kernel = getSignedSymbolsReader<T>(config);
+      (this->*kernel)(symbols, numSymbols, config, signMode, predictor);
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decodes a sequence of remapped symbols, see cabacSimpleSequenceEncoder::encodeSymbolsRemapped
+    void decodeSymbolsRemapped(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config,
+      remapping::SymbolRemapper& remapper)
+    {
+      const remappedSymbolsReader kernel = getRemappedSymbolsReader(config);
+      (this->*kernel)(symbols, numSymbols, config, remapper);
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decodes a sequence of transformed symbols, see cabacSimpleSequenceEncoder::encodeSymbolsEquality,
+    // encodeSymbolsRunLength and encodeSymbolsMatch
+    void decodeSymbolsEquality(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& flagConfig,
+      const CodingConfig& valueConfig)
+    {
+      transform::EqualityStreams streams;
+      decodeSubstream(streams.flags, numSymbols, flagConfig);
+      const size_t numValues = std::count(streams.flags.begin(), streams.flags.end(), 0);
+      decodeSubstream(streams.values, static_cast<unsigned int>(numValues), valueConfig);
+      transform::decodeEquality(streams, symbols);
+    }
+
+    void decodeSymbolsRunLength(uint64_t * symbols, const unsigned int numSymbols, const uint64_t guard,
+      const CodingConfig& valueConfig, const CodingConfig& lengthConfig)
+    {
+      transform::RunLengthStreams streams;
+      decodeSubstream(streams.lengths, getNumSubstreamSymbols(numSymbols), lengthConfig);
+      decodeSubstream(streams.values, transform::getNumRuns(streams.lengths, guard), valueConfig);
+      transform::decodeRunLength(streams, guard, numSymbols, symbols);
+    }
+
+    void decodeSymbolsMatch(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& lengthConfig,
+      const CodingConfig& offsetConfig, const CodingConfig& literalConfig)
+    {
+      transform::MatchStreams streams;
+      decodeSubstream(streams.lengths, getNumSubstreamSymbols(numSymbols), lengthConfig);
+      const unsigned int numMatches = transform::getNumMatches(streams.lengths);
+      decodeSubstream(streams.offsets, numMatches, offsetConfig);
+      decodeSubstream(streams.literals, static_cast<unsigned int>(streams.lengths.size()) - numMatches, literalConfig);
+      transform::decodeMatch(streams, numSymbols, symbols);
+    }
+
+    void decodeSubstream(std::vector<uint64_t>& symbols, const unsigned int numSymbols, const CodingConfig& config)
+    {
+      symbols.resize(numSymbols);
+      if (config.bypass) {
+        decodeSymbolsBypass(symbols.data(), numSymbols, config);
+      } else {
+        decodeSymbols(symbols.data(), numSymbols, config);
+      }
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Decodes a sequence of symbols coded with encodeSymbolsBlockSwitching. The kernels of all candidates are selected
+    // once per sequence, such that switching per block only indexes a table.
+    void decodeSymbolsBlockSwitching(uint64_t * symbols, const unsigned int numSymbols,
+      const BlockSwitchingConfig& blockConfig)
+    {
+      const std::vector<CodingConfig>& candidates = blockConfig.candidates;
+      const unsigned int numCandidates = static_cast<unsigned int>(candidates.size());
+      std::vector<symbolsReader> kernels(numCandidates);
+      for (unsigned int c = 0; c < numCandidates; c++) {
+        kernels[c] = candidates[c].bypass ? getSymbolsBypassReader(candidates[c]) : getSymbolsReader(candidates[c]);
+      }
+
+      for (unsigned int d0 = 0; d0 < numSymbols; d0 += blockConfig.blockSize) {
+        const unsigned int n = std::min(blockConfig.blockSize, numSymbols - d0);
+        const unsigned int c = decodeSelection(blockConfig);
+        (this->*kernels[c])(symbols + d0, n, candidates[c]);
+      }
+    }
+
+    unsigned int decodeSelection(const BlockSwitchingConfig& blockConfig)
+    {
+      const unsigned int numMaxBins = static_cast<unsigned int>(blockConfig.candidates.size()) - 1;
+      unsigned int c = 0;
+      while (c < numMaxBins && decodeBin(blockConfig.ctxIdSelect + c)) {
+        c++;
+      }
+      return c;
+    }
+
+    // Number of symbols of a sub-stream, coded as EG0 bypass bins. There are at most numSymbols entries per sub-stream.
+    unsigned int getNumSubstreamSymbols(const unsigned int numSymbols)
+    {
+      const uint64_t numSubstreamSymbols = decodeBinsEGkbypass(0);
+      if (numSubstreamSymbols > numSymbols) {
+        throw std::runtime_error("getNumSubstreamSymbols: Invalid number of sub-stream symbols");
+      }
+      return static_cast<unsigned int>(numSubstreamSymbols);
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Bypass-decodes a sequence of fixed-length symbols written by encodeSymbolsBypassAligned
+    void decodeSymbolsBypassAligned(uint64_t * symbols, const unsigned int numSymbols,
+      binarization::BinarizationId binId, const std::vector<unsigned int>& binParams)
+    {
+      decodeSymbolsBypassAligned(symbols, numSymbols, CodingConfig(binId, binParams));
+    }
+
+    void decodeSymbolsBypassAligned(uint64_t * symbols, const unsigned int numSymbols, const CodingConfig& config)
+    {
+      if (config.binId != binarization::BinarizationId::BI) {
+        throw std::runtime_error("decodeSymbolsBypassAligned: Only supported for BinarizationId::BI");
+      }
+      decodeAlignedBinsEPArray(symbols, numSymbols, config.numMaxBins);
+    }
+
     // ---------------------------------------------------------------------------------------------------------------------
     // This is a general method for decoding a symbol for given binarization and context model
-    // parameter definition see encodeSymbols
+    // parameter definition see encodeSymbols, context-adaptive RICE is not supported (see encodeSymbol)
     uint64_t decodeSymbol(const unsigned int d, const uint64_t * symbolsPrev,
       binarization::BinarizationId binId, const contextSelector::ContextModelId ctxModelId,
-      const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams)
+      const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
     {
-      // Get reader
-      binReader func = getReader(binId);
+      return decodeSymbol(d, symbolsPrev, CodingConfig(binId, ctxModelId, binParams, ctxParams));
+    }
+
+    uint64_t decodeSymbol(const unsigned int d, const uint64_t * symbolsPrev, const CodingConfig& config)
+    {
+      if (config.binId == binarization::BinarizationId::RICE) {
+        throw std::runtime_error("decodeSymbol: Context-adaptive RICE only supported for sequences (decodeSymbols)");
+      }
 
       // Get context id for each bin
-      const unsigned int numMaxBins = binParams[0];
-      std::vector<unsigned int> ctxIds(numMaxBins, 0);
-      contextSelector::getContextIds(ctxIds, d, symbolsPrev, binId, ctxModelId, binParams, ctxParams);
+      contextSelector::ContextIdProvider ctxIds(config);
+      ctxIds.setSymbol(d, symbolsPrev);
 
       // Decode bins
-      return (*this.*func)(ctxIds, binParams);
+      return decodeBins(config, ctxIds);
     }
 
     // ---------------------------------------------------------------------------------------------------------------------
     // This is a general method for bypass decoding a symbol for given binarization
     // parameter definition see encodeSymbols
-    uint64_t decodeSymbolBypass(binarization::BinarizationId binId, const std::vector<unsigned int> binParams)
+    uint64_t decodeSymbolBypass(binarization::BinarizationId binId, const std::vector<unsigned int>& binParams)
     {
-      // Get reader
-      binBypassReader func = getBypassReader(binId);
+      return decodeBinsBypass(CodingConfig(binId, binParams));
+    }
 
-      // Decode bins
-      return (*this.*func)(binParams);
+    uint64_t decodeSymbolBypass(const CodingConfig& config)
+    {
+      return decodeBinsBypass(config);
     }
 
 }; // class cabacSimpleSequenceDecoder
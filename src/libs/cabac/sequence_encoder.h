@@ -1,104 +1,540 @@
 #pragma once
 
 #include "CommonDef.h"
+#include <algorithm>
 #include <cstdint>
+#include <future>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #if RWTH_PYTHON_IF
+#include "coding_config.h"
 #include "context_selector.h"
 #include "binarization.h"
+#include "prediction.h"
+#include "remapping.h"
+#include "transform.h"
 #include "symbol_encoder.h"
 
 
-typedef void (cabacSymbolEncoder::*binWriter)(uint64_t, const std::vector<unsigned int>&, std::vector<unsigned int>);
-typedef void (cabacSymbolEncoder::*binBypassWriter)(uint64_t, std::vector<unsigned int>);
+class cabacSimpleSequenceEncoder;
+typedef void (cabacSimpleSequenceEncoder::*symbolsWriter)(const uint64_t *, unsigned int, const CodingConfig&);
+template <typename T>
+using signedSymbolsWriter = void (cabacSimpleSequenceEncoder::*)(const T *, unsigned int, const CodingConfig&,
+  const binarization::SignMode, const prediction::Predictor&);
+typedef void (cabacSimpleSequenceEncoder::*remappedSymbolsWriter)(const uint64_t *, unsigned int, const CodingConfig&,
+  remapping::SymbolRemapper&);
 
 
 class cabacSimpleSequenceEncoder : public cabacSymbolEncoder{
 public:
   cabacSimpleSequenceEncoder() : cabacSymbolEncoder(){}
 
-  binWriter getWriter(binarization::BinarizationId binId){
-    binWriter func = nullptr;
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encode bins of a symbol for given binarization, with context IDs provided per bin by ctxIds (see getCtxId).
+  // Selects the binarization at run time, see encodeBins<binId> below.
+  template <class CtxProvider>
+  void encodeBins(const uint64_t symbol, const CodingConfig& config, const CtxProvider &ctxIds)
+  {
+    switch(config.binId){
+      case binarization::BinarizationId::BI: {
+        encodeBins<binarization::BinarizationId::BI>(symbol, config, ctxIds);
+      } break;
+      case binarization::BinarizationId::TU: {
+        encodeBins<binarization::BinarizationId::TU>(symbol, config, ctxIds);
+      } break;
+      case binarization::BinarizationId::EGk: {
+        encodeBins<binarization::BinarizationId::EGk>(symbol, config, ctxIds);
+      } break;
+      case binarization::BinarizationId::RICE: {
+        encodeBins<binarization::BinarizationId::RICE>(symbol, config, ctxIds);
+      } break;
+      case binarization::BinarizationId::TB: {
+        encodeBins<binarization::BinarizationId::TB>(symbol, config, ctxIds);
+      } break;
+      case binarization::BinarizationId::UEGk: {
+        encodeBins<binarization::BinarizationId::UEGk>(symbol, config, ctxIds);
+      } break;
+      default:
+        throw std::runtime_error("encodeBins: Binarization not supported with context-adaptive coding");
+    }
+  }
+
+  // Binarization fixed at compile time
+  template <binarization::BinarizationId binId, class CtxProvider>
+  void encodeBins(const uint64_t symbol, const CodingConfig& config, const CtxProvider &ctxIds)
+  {
     switch(binId){
       case binarization::BinarizationId::BI: {
-        func = &cabacSimpleSequenceEncoder::encodeBinsBI;
+        encodeBinsBI(symbol, ctxIds, config.numMaxBins);
+      } break;
+      case binarization::BinarizationId::TU: {
+        encodeBinsTU(symbol, ctxIds, config.numMaxBins);
+      } break;
+      case binarization::BinarizationId::EGk: {
+        encodeBinsEGk(symbol, config.k, ctxIds);
+      } break;
+      case binarization::BinarizationId::RICE: {
+        checkSymbolRICE(symbol, config);
+        encodeBinsRICE(symbol, ctxIds, config.riceParam, config.cutoff, config.maxLog2TrDynamicRange);
+      } break;
+      case binarization::BinarizationId::TB: {
+        encodeBinsTB(symbol, ctxIds, config.numMaxBins);
+      } break;
+      case binarization::BinarizationId::UEGk: {
+        encodeBinsUEGk(symbol, ctxIds, config.numMaxBins, config.k);
+      } break;
+      default:
+        throw std::runtime_error("encodeBins: Binarization not supported with context-adaptive coding");
+    }
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Bypass-encode bins of a symbol for given binarization, selected at run time, see encodeBinsBypass<binId> below
+  void encodeBinsBypass(const uint64_t symbol, const CodingConfig& config)
+  {
+    switch(config.binId){
+      case binarization::BinarizationId::BI: {
+        encodeBinsBypass<binarization::BinarizationId::BI>(symbol, config);
       } break;
       case binarization::BinarizationId::TU: {
-        func = &cabacSimpleSequenceEncoder::encodeBinsTU;
+        encodeBinsBypass<binarization::BinarizationId::TU>(symbol, config);
       } break;
       case binarization::BinarizationId::EGk: {
-        func = &cabacSimpleSequenceEncoder::encodeBinsEGk;
+        encodeBinsBypass<binarization::BinarizationId::EGk>(symbol, config);
       } break;
       case binarization::BinarizationId::NA: {
-        func = &cabacSimpleSequenceEncoder::encodeBinsNA;
+        encodeBinsBypass<binarization::BinarizationId::NA>(symbol, config);
       } break;
       case binarization::BinarizationId::RICE: {
-        throw std::runtime_error("getWriter: Binarization RICE not supported with context-adaptive coding");
+        encodeBinsBypass<binarization::BinarizationId::RICE>(symbol, config);
+      } break;
+      case binarization::BinarizationId::TB: {
+        encodeBinsBypass<binarization::BinarizationId::TB>(symbol, config);
+      } break;
+      case binarization::BinarizationId::UEGk: {
+        encodeBinsBypass<binarization::BinarizationId::UEGk>(symbol, config);
       } break;
       default:
-        throw std::runtime_error("getWriter: Unknown binarization ID");
-    }
-    return func;
-  }
-
-  binBypassWriter getBypassWriter(binarization::BinarizationId binId){
-    binBypassWriter func = nullptr;
-      switch(binId){
-        case binarization::BinarizationId::BI: {
-          func = &cabacSimpleSequenceEncoder::encodeBinsBIbypass;
-        } break;
-        case binarization::BinarizationId::TU: {
-          func = &cabacSimpleSequenceEncoder::encodeBinsTUbypass;
-        } break;
-        case binarization::BinarizationId::EGk: {
-          func = &cabacSimpleSequenceEncoder::encodeBinsEGkbypass;
-        } break;
-        case binarization::BinarizationId::NA: {
-          func = &cabacSimpleSequenceEncoder::encodeBinsNAbypass;
-        } break;
-        case binarization::BinarizationId::RICE: {
-          func = &cabacSimpleSequenceEncoder::encodeBinsRicebypass;
-        } break;
-        default:
-          throw std::runtime_error("getBypassWriter: Unknown binarization ID");
+        throw std::runtime_error("encodeBinsBypass: Unknown binarization ID");
+    }
+  }
+
+  // Binarization fixed at compile time
+  template <binarization::BinarizationId binId>
+  void encodeBinsBypass(const uint64_t symbol, const CodingConfig& config)
+  {
+    switch(binId){
+      case binarization::BinarizationId::BI: {
+        encodeBinsBIbypass(symbol, config.numMaxBins);
+      } break;
+      case binarization::BinarizationId::TU: {
+        encodeBinsTUbypass(symbol, config.numMaxBins);
+      } break;
+      case binarization::BinarizationId::EGk: {
+        encodeBinsEGkbypass(symbol, config.k);
+      } break;
+      case binarization::BinarizationId::NA: {
+        encodeBinEP(static_cast<unsigned int>(symbol));
+      } break;
+      case binarization::BinarizationId::RICE: {
+        checkSymbolRICE(symbol, config);
+        encodeRemAbsEP(static_cast<unsigned int>(symbol), config.riceParam, config.cutoff, config.maxLog2TrDynamicRange);
+      } break;
+      case binarization::BinarizationId::TB: {
+        encodeBinsTBbypass(symbol, config.numMaxBins);
+      } break;
+      case binarization::BinarizationId::UEGk: {
+        encodeBinsUEGkbypass(symbol, config.numMaxBins, config.k);
+      } break;
+    }
+  }
+
+  // Symbols above config.maxSymbolRICE would be truncated by the escape of encodeRemAbsEP
+  static void checkSymbolRICE(const uint64_t symbol, const CodingConfig& config)
+  {
+    if (symbol > config.maxSymbolRICE) {
+      throw std::runtime_error("encodeSymbols: Symbol exceeds the range of RICE (CodingConfig::maxSymbolRICE)");
+    }
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encoding kernels, specialized per binarization, context model (without symbol position) and order, such that
+  // context selection, binarization and arithmetic coding inline into a single loop.
+  // The kernel is selected once per sequence by getSymbolsWriter/getSymbolsBypassWriter.
+  template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+  void encodeSymbolsKernel(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config)
+  {
+    uint64_t symbolsPrev[3] = {0, 0, 0};
+    contextSelector::TContextIdProvider<binId, ctxModelId0, order> ctxIds(config);
+    binarization::RiceParamAdaptation riceAdaptation(config.riceParam, config.maxLog2TrDynamicRange);
+
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      // Prepare context ids of current symbol
+      for (unsigned int o = 0; o < order; o++){
+        if (i > o) {
+          symbolsPrev[o] = symbols[i-o - 1];
+        }
+      }
+      ctxIds.setSymbol(i, symbolsPrev);
+
+      // Encode symbol
+      if (binId == binarization::BinarizationId::RICE) { // Rice parameter adapted to the previously coded symbols
+        const unsigned int set = binarization::RiceParamAdaptation::getSet(symbolsPrev[0]);
+        checkSymbolRICE(symbols[i], config);
+        encodeBinsRICE(symbols[i], ctxIds, riceAdaptation.getRiceParam(set), config.cutoff, config.maxLog2TrDynamicRange);
+        riceAdaptation.update(set, symbols[i]);
+      } else {
+        encodeBins<binId>(symbols[i], config, ctxIds);
+      }
+    }
+  }
+
+  template <binarization::BinarizationId binId>
+  void encodeSymbolsBypassKernel(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config)
+  {
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      encodeBinsBypass<binId>(symbols[i], config);
+    }
+  }
+
+  // Kernel selection, shared by the plain, signed and remapped kernels: returns the member function pointer (of type
+  // Writer) of Kernel<binId, ctxModelId0, order>::get() for context-adaptive coding, or of
+  // BypassKernel<binId>::get() for bypass coding.
+  template <typename Writer,
+    template <binarization::BinarizationId, contextSelector::ContextModelId, unsigned int> class Kernel,
+    binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0>
+  static Writer getWriterOrder(const unsigned int order)
+  {
+    switch(order){
+      case 1: return Kernel<binId, ctxModelId0, 1>::get();
+      case 2: return Kernel<binId, ctxModelId0, 2>::get();
+      case 3: return Kernel<binId, ctxModelId0, 3>::get();
+      default:
+        throw std::runtime_error("getWriter: Order must be at most 3");
+    }
+  }
+
+  template <typename Writer,
+    template <binarization::BinarizationId, contextSelector::ContextModelId, unsigned int> class Kernel,
+    binarization::BinarizationId binId>
+  static Writer getWriterContextModel(const CodingConfig& config)
+  {
+    switch(config.ctxModelId0){
+      // The order does not affect the context IDs of BAC and BINPOSITION
+      case contextSelector::ContextModelId::BAC:
+        return Kernel<binId, contextSelector::ContextModelId::BAC, 1>::get();
+      case contextSelector::ContextModelId::BINPOSITION:
+        return Kernel<binId, contextSelector::ContextModelId::BINPOSITION, 1>::get();
+      case contextSelector::ContextModelId::BINSORDERN:
+        return getWriterOrder<Writer, Kernel, binId, contextSelector::ContextModelId::BINSORDERN>(config.order);
+      case contextSelector::ContextModelId::SYMBOLORDERN:
+        return getWriterOrder<Writer, Kernel, binId, contextSelector::ContextModelId::SYMBOLORDERN>(config.order);
+      default:
+        throw std::runtime_error("getWriter: Unknown context model ID");
+    }
+  }
+
+  template <typename Writer,
+    template <binarization::BinarizationId, contextSelector::ContextModelId, unsigned int> class Kernel>
+  static Writer getWriter(const CodingConfig& config)
+  {
+    switch(config.binId){
+      case binarization::BinarizationId::BI:
+        return getWriterContextModel<Writer, Kernel, binarization::BinarizationId::BI>(config);
+      case binarization::BinarizationId::TU:
+        return getWriterContextModel<Writer, Kernel, binarization::BinarizationId::TU>(config);
+      case binarization::BinarizationId::EGk:
+        return getWriterContextModel<Writer, Kernel, binarization::BinarizationId::EGk>(config);
+      case binarization::BinarizationId::RICE:
+        return getWriterContextModel<Writer, Kernel, binarization::BinarizationId::RICE>(config);
+      case binarization::BinarizationId::TB:
+        return getWriterContextModel<Writer, Kernel, binarization::BinarizationId::TB>(config);
+      case binarization::BinarizationId::UEGk:
+        return getWriterContextModel<Writer, Kernel, binarization::BinarizationId::UEGk>(config);
+      default:
+        throw std::runtime_error("getWriter: Binarization not supported with context-adaptive coding");
+    }
+  }
+
+  template <typename Writer, template <binarization::BinarizationId> class BypassKernel>
+  static Writer getBypassWriter(const CodingConfig& config)
+  {
+    switch(config.binId){
+      case binarization::BinarizationId::BI:
+        return BypassKernel<binarization::BinarizationId::BI>::get();
+      case binarization::BinarizationId::TU:
+        return BypassKernel<binarization::BinarizationId::TU>::get();
+      case binarization::BinarizationId::EGk:
+        return BypassKernel<binarization::BinarizationId::EGk>::get();
+      case binarization::BinarizationId::NA:
+        return BypassKernel<binarization::BinarizationId::NA>::get();
+      case binarization::BinarizationId::RICE:
+        return BypassKernel<binarization::BinarizationId::RICE>::get();
+      case binarization::BinarizationId::TB:
+        return BypassKernel<binarization::BinarizationId::TB>::get();
+      case binarization::BinarizationId::UEGk:
+        return BypassKernel<binarization::BinarizationId::UEGk>::get();
+      default:
+        throw std::runtime_error("getBypassWriter: Unknown binarization ID");
+    }
+  }
+
+  template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+  struct SymbolsKernel {
+    static symbolsWriter get() { return &cabacSimpleSequenceEncoder::encodeSymbolsKernel<binId, ctxModelId0, order>; }
+  };
+
+  template <binarization::BinarizationId binId>
+  struct SymbolsBypassKernel {
+    static symbolsWriter get() { return &cabacSimpleSequenceEncoder::encodeSymbolsBypassKernel<binId>; }
+  };
+
+  static symbolsWriter getSymbolsWriter(const CodingConfig& config)
+  {
+    return getWriter<symbolsWriter, SymbolsKernel>(config);
+  }
+
+  static symbolsWriter getSymbolsBypassWriter(const CodingConfig& config)
+  {
+    return getBypassWriter<symbolsWriter, SymbolsBypassKernel>(config);
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encoding kernels for signed symbols of type T, see encodeSymbolsSigned. Same as encodeSymbolsKernel, with the
+  // prediction residuals and their unsigned values (binarization::getUnsignedValue) computed in the coding loop and
+  // the sign bins interleaved.
+  void encodeSignBin(const bool negative, const binarization::SignMode signMode, const unsigned int ctxId)
+  {
+    if (signMode == binarization::SignMode::SIGNCONTEXT) {
+      encodeBin(negative, ctxId);
+    } else {
+      encodeBinEP(negative);
+    }
+  }
+
+  template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order,
+    typename T>
+  void encodeSignedSymbolsKernel(const T * symbols, unsigned int numSymbols, const CodingConfig& config,
+    const binarization::SignMode signMode, const prediction::Predictor& predictor)
+  {
+    uint64_t symbolsPrev[3] = {0, 0, 0};  // unsigned values of the previous symbols
+    unsigned int signClassPrev = 0;
+    contextSelector::TContextIdProvider<binId, ctxModelId0, order> ctxIds(config);
+    binarization::RiceParamAdaptation riceAdaptation(config.riceParam, config.maxLog2TrDynamicRange);
+
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      const int64_t value = prediction::Predictor::getResidual(symbols[i], predictor.predict(symbols, i));
+      const uint64_t symbol = binarization::getUnsignedValue(value, signMode);
+      ctxIds.setSymbol(i, symbolsPrev);
+
+      if (binId == binarization::BinarizationId::RICE) {
+        const unsigned int set = binarization::RiceParamAdaptation::getSet(symbolsPrev[0]);
+        checkSymbolRICE(symbol, config);
+        encodeBinsRICE(symbol, ctxIds, riceAdaptation.getRiceParam(set), config.cutoff, config.maxLog2TrDynamicRange);
+        riceAdaptation.update(set, symbol);
+      } else {
+        encodeBins<binId>(symbol, config, ctxIds);
+      }
+      if (signMode != binarization::SignMode::ZIGZAG && symbol != 0) {
+        encodeSignBin(value < 0, signMode, config.getSignContextId(signClassPrev));
+      }
+
+      for (unsigned int o = order - 1; o > 0; o--) {
+        symbolsPrev[o] = symbolsPrev[o - 1];
       }
+      symbolsPrev[0] = symbol;
+      signClassPrev = binarization::getSignClass(value);
+    }
+  }
+
+  template <binarization::BinarizationId binId, typename T>
+  void encodeSignedSymbolsBypassKernel(const T * symbols, unsigned int numSymbols, const CodingConfig& config,
+    const binarization::SignMode signMode, const prediction::Predictor& predictor)
+  {
+    unsigned int signClassPrev = 0;
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      const int64_t value = prediction::Predictor::getResidual(symbols[i], predictor.predict(symbols, i));
+      const uint64_t symbol = binarization::getUnsignedValue(value, signMode);
+      encodeBinsBypass<binId>(symbol, config);
+      if (signMode != binarization::SignMode::ZIGZAG && symbol != 0) {
+        encodeSignBin(value < 0, signMode, config.getSignContextId(signClassPrev));
+      }
+      signClassPrev = binarization::getSignClass(value);
+    }
+  }
+
+  template <typename T>
+  struct SignedSymbolsKernels {
+    template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+    struct Kernel {
+      static signedSymbolsWriter<T> get()
+      {
+        return &cabacSimpleSequenceEncoder::encodeSignedSymbolsKernel<binId, ctxModelId0, order, T>;
+      }
+    };
+
+    template <binarization::BinarizationId binId>
+    struct BypassKernel {
+      static signedSymbolsWriter<T> get()
+      {
+        return &cabacSimpleSequenceEncoder::encodeSignedSymbolsBypassKernel<binId, T>;
+      }
+    };
+  };
+
+  template <typename T>
+  static signedSymbolsWriter<T> getSignedSymbolsWriter(const CodingConfig& config)
+  {
+    if (config.bypass) {
+      return getBypassWriter<signedSymbolsWriter<T>, SignedSymbolsKernels<T>::template BypassKernel>(config);
+    }
+    return getWriter<signedSymbolsWriter<T>, SignedSymbolsKernels<T>::template Kernel>(config);
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encoding kernels with adaptive remapping, see encodeSymbolsRemapped. Same as encodeSymbolsKernel, with the ranks
+  // of the symbols computed in the coding loop. The context selection uses the ranks of the previous symbols.
+  template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+  void encodeRemappedSymbolsKernel(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config,
+    remapping::SymbolRemapper& remapper)
+  {
+    uint64_t symbolsPrev[3] = {0, 0, 0};  // ranks of the previous symbols
+    contextSelector::TContextIdProvider<binId, ctxModelId0, order> ctxIds(config);
+    binarization::RiceParamAdaptation riceAdaptation(config.riceParam, config.maxLog2TrDynamicRange);
+
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      const uint64_t symbol = remapper.getRank(symbols[i]);
+      ctxIds.setSymbol(i, symbolsPrev);
+
+      if (binId == binarization::BinarizationId::RICE) {
+        const unsigned int set = binarization::RiceParamAdaptation::getSet(symbolsPrev[0]);
+        checkSymbolRICE(symbol, config);
+        encodeBinsRICE(symbol, ctxIds, riceAdaptation.getRiceParam(set), config.cutoff, config.maxLog2TrDynamicRange);
+        riceAdaptation.update(set, symbol);
+      } else {
+        encodeBins<binId>(symbol, config, ctxIds);
+      }
+
+      for (unsigned int o = order - 1; o > 0; o--) {
+        symbolsPrev[o] = symbolsPrev[o - 1];
+      }
+      symbolsPrev[0] = symbol;
+    }
+  }
+
+  template <binarization::BinarizationId binId>
+  void encodeRemappedSymbolsBypassKernel(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config,
+    remapping::SymbolRemapper& remapper)
+  {
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      encodeBinsBypass<binId>(remapper.getRank(symbols[i]), config);
+    }
+  }
+
+  template <binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId0, unsigned int order>
+  struct RemappedSymbolsKernel {
+    static remappedSymbolsWriter get()
+    {
+      return &cabacSimpleSequenceEncoder::encodeRemappedSymbolsKernel<binId, ctxModelId0, order>;
+    }
+  };
 
-      return func;
+  template <binarization::BinarizationId binId>
+  struct RemappedSymbolsBypassKernel {
+    static remappedSymbolsWriter get() { return &cabacSimpleSequenceEncoder::encodeRemappedSymbolsBypassKernel<binId>; }
+  };
+
+  static remappedSymbolsWriter getRemappedSymbolsWriter(const CodingConfig& config)
+  {
+    if (config.bypass) {
+      return getBypassWriter<remappedSymbolsWriter, RemappedSymbolsBypassKernel>(config);
+    }
+    return getWriter<remappedSymbolsWriter, RemappedSymbolsKernel>(config);
   }
 
   // ---------------------------------------------------------------------------------------------------------------------
   // This is a general method for encoding a sequence of symbols for given binarization and context model
   // binParams = {numMaxBins or numBins, [k, [riceParam, cuttoff, maxLog2TrDynamicRange]]}
   // ctxParams = {order, restPos, offset, symbolMax, symbolPosMode}
+  // RICE: the first cutoff prefix bins are context-coded and riceParam is only the initial Rice parameter, which is
+  // then adapted to the coded symbols (see binarization::RiceParamAdaptation). Symbols above
+  // CodingConfig::maxSymbolRICE are rejected.
+  // TB: numMaxBins is the largest symbol value cMax; UEGk: numMaxBins is the TU prefix cutoff
   void encodeSymbols(const uint64_t * symbols, unsigned int numSymbols, 
     binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId, 
-    const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams)
+    const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
+  {
+    encodeSymbols(symbols, numSymbols, CodingConfig(binId, ctxModelId, binParams, ctxParams));
+  }
+
+  // Same as above, with binarization and context model given by a (validated) coding configuration
+  // Context IDs are computed lazily, only for the bins actually coded
+  void encodeSymbols(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config)
+  {
+    const symbolsWriter kernel = getSymbolsWriter(config);
+    (this->*kernel)(symbols, numSymbols, config);
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Context IDs of a symbol within a block of precomputed context IDs, where the last entry is the rest context
+  struct PrecomputedContextIds {
+    const unsigned int * row;
+    unsigned int last;
+    unsigned int operator()(const unsigned int n) const {
+      return row[n < last ? n : last];
+    }
+  };
+
+  // Same as encodeSymbols, but the context IDs of all symbols are computed up front (in parallel, numThreads=0 uses all
+  // cores), such that the serial arithmetic coding loop only streams through the precomputed context IDs.
+  // Context IDs are computed block-wise: while one block is encoded, the context IDs of the next block are computed.
+  // parameter definition see encodeSymbols
+  void encodeSymbolsPrecomputed(const uint64_t * symbols, unsigned int numSymbols,
+    binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId,
+    const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams,
+    unsigned int numThreads=0)
+  {
+    encodeSymbolsPrecomputed(symbols, numSymbols, CodingConfig(binId, ctxModelId, binParams, ctxParams), numThreads);
+  }
+
+  void encodeSymbolsPrecomputed(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config,
+    unsigned int numThreads=0)
   {
-    auto order = ctxParams[0];
-    // Check order
-    if(order == 0 || order > 3) {
-      throw std::runtime_error("encodeSymbols: Order must be 1, 2 or 3"); // TODO: Add support for higher orders
+    const unsigned int stride = contextSelector::getContextIdsSequenceStride(config.binParams, config.ctxParams);
+    const unsigned int numSymbolsPerBlock = 1 << 16;
+    if (numThreads == 0) {
+      numThreads = std::max(1u, std::thread::hardware_concurrency());
     }
-    
-    std::vector<uint64_t> symbolsPrev(order, 0);
-    const unsigned int numMaxBins = binParams[0];
-    std::vector<unsigned int> ctxIds(numMaxBins, 0);
 
-    // Get writer
-    binWriter func = getWriter(binId);
+    // Double buffer for context IDs
+    std::vector<unsigned int> ctxIds[2];
+    const unsigned int numSymbolsFirstBlock = std::min(numSymbols, numSymbolsPerBlock);
+    ctxIds[0].resize((size_t)numSymbolsFirstBlock * stride);
+    ctxIds[1].resize(numSymbols > numSymbolsPerBlock ? (size_t)numSymbolsPerBlock * stride : 0);
+    contextSelector::getContextIdsSequence(ctxIds[0].data(), symbols, 0, numSymbolsFirstBlock, config, numThreads);
 
-    for (unsigned int i = 0; i < numSymbols; i++) {
-      // Get context ids for each bin
-      for (unsigned int o = 0; o < order; o++){
-        if (i > o) {
-          symbolsPrev[o] = symbols[i-o - 1];
-        }
+    for (unsigned int d0 = 0, b = 0; d0 < numSymbols; d0 += numSymbolsPerBlock, b ^= 1) {
+      const unsigned int d1 = std::min(numSymbols, d0 + numSymbolsPerBlock);
+
+      // Compute context IDs of next block while encoding the current one. The future waits for the computation when
+      // it goes out of scope, also if encodeBins throws.
+      std::future<void> nextBlock;
+      if (d1 < numSymbols) {
+        const unsigned int d2 = std::min(numSymbols, d1 + numSymbolsPerBlock);
+        nextBlock = std::async(std::launch::async, contextSelector::getContextIdsSequence, ctxIds[b ^ 1].data(),
+          symbols, d1, d2, std::cref(config), std::max(1u, numThreads - 1));
       }
-      contextSelector::getContextIds(ctxIds, i, symbolsPrev.data(), binId, ctxModelId, binParams, ctxParams);
 
-      // Encode symbol
-      (*this.*func)(symbols[i], ctxIds, binParams);
+      for (unsigned int d = d0; d < d1; d++) {
+        const PrecomputedContextIds row = {ctxIds[b].data() + (size_t)(d - d0) * stride, stride - 1};
+        encodeBins(symbols[d], config, row);
+      }
+
+      if (nextBlock.valid()) {
+        nextBlock.get();
+      }
     }
   }
 
@@ -106,49 +542,217 @@ public:
   // This is a general method for bypass-encoding a sequence of symbols for given binarization
   // parameter definition see encodeSymbols
   void encodeSymbolsBypass(const uint64_t * symbols, unsigned int numSymbols, 
-    binarization::BinarizationId binId, const std::vector<unsigned int> binParams)
+    binarization::BinarizationId binId, const std::vector<unsigned int>& binParams)
   {
-    // Get writer
-    binBypassWriter func = getBypassWriter(binId);
+    encodeSymbolsBypass(symbols, numSymbols, CodingConfig(binId, binParams));
+  }
 
-    for (unsigned int i = 0; i < numSymbols; i++) {
-      // Encode symbol
-      (*this.*func)(symbols[i], binParams);
+  void encodeSymbolsBypass(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config)
+  {
+    const symbolsWriter kernel = getSymbolsBypassWriter(config);
+    (this->*kernel)(symbols, numSymbols, config);
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encodes a sequence of signed symbols of type T (int8_t ... int64_t), bypass or context-adaptive depending on config.
+  // The binarization and context model of config apply to the unsigned values of the symbols, i.e. the zigzag-mapped
+  // values or the magnitudes (see binarization::SignMode), such that the context selection also accounts for the
+  // signs of the previous symbols with ZIGZAG. With SIGNCONTEXT, the sign bin is coded with one of
+  // CodingConfig::numSignContexts contexts (see CodingConfig::getSignContextId), selected by the sign of the previous
+  // symbol.
+  // With a predictor, the prediction residuals are coded instead of the symbols (see prediction::Predictor).
+  template <typename T>
+  void encodeSymbolsSigned(const T * symbols, unsigned int numSymbols, const CodingConfig& config,
+    const binarization::SignMode signMode, const prediction::Predictor& predictor = prediction::Predictor())
+  {
+    static_assert(std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) <= 8,
+      "encodeSymbolsSigned: Signed integer symbols required");
+    const signedSymbolsWriter<T> kernel = getSignedSymbolsWriter<T>(config);
+    (this->*kernel)(symbols, numSymbols, config, signMode, predictor);
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encodes a sequence of symbols after adaptive remapping (see remapping::SymbolRemapper), bypass or
+  // context-adaptive depending on config. The ranks of the symbols are coded instead of the symbols, such that the
+  // binarization and context model of config apply to the ranks. The remapper is updated by the coded symbols and has
+  // to be in the same state for decodeSymbolsRemapped.
+  void encodeSymbolsRemapped(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config,
+    remapping::SymbolRemapper& remapper)
+  {
+    const remappedSymbolsWriter kernel = getRemappedSymbolsWriter(config);
+    (this->*kernel)(symbols, numSymbols, config, remapper);
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encodes a sequence of symbols after one of the sequence transforms (see transform.h). The sub-streams are coded one
+  // after another, each with its own coding configuration (bypass or context-adaptive), such that they can use
+  // separate contexts via the ctxOffset of their context models. The numbers of symbols of the sub-streams are
+  // implied by the preceding sub-streams, or coded as EG0 bypass bins (run-length and match coding: number of lengths).
+  void encodeSymbolsEquality(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& flagConfig,
+    const CodingConfig& valueConfig)
+  {
+    const transform::EqualityStreams streams = transform::encodeEquality(symbols, numSymbols);
+    encodeSubstream(streams.flags, flagConfig);
+    encodeSubstream(streams.values, valueConfig);
+  }
+
+  // guard: maximum value of the run length entries, see transform::encodeRunLength
+  void encodeSymbolsRunLength(const uint64_t * symbols, unsigned int numSymbols, const uint64_t guard,
+    const CodingConfig& valueConfig, const CodingConfig& lengthConfig)
+  {
+    const transform::RunLengthStreams streams = transform::encodeRunLength(symbols, numSymbols, guard);
+    encodeBinsEGkbypass(streams.lengths.size(), 0);
+    encodeSubstream(streams.lengths, lengthConfig);
+    encodeSubstream(streams.values, valueConfig);
+  }
+
+  // windowSize: number of previous symbols searched for matches, see transform::encodeMatch
+  void encodeSymbolsMatch(const uint64_t * symbols, unsigned int numSymbols, const unsigned int windowSize,
+    const CodingConfig& lengthConfig, const CodingConfig& offsetConfig, const CodingConfig& literalConfig)
+  {
+    const transform::MatchStreams streams = transform::encodeMatch(symbols, numSymbols, windowSize);
+    encodeBinsEGkbypass(streams.lengths.size(), 0);
+    encodeSubstream(streams.lengths, lengthConfig);
+    encodeSubstream(streams.offsets, offsetConfig);
+    encodeSubstream(streams.literals, literalConfig);
+  }
+
+  void encodeSubstream(const std::vector<uint64_t>& symbols, const CodingConfig& config)
+  {
+    if (config.bypass) {
+      encodeSymbolsBypass(symbols.data(), static_cast<unsigned int>(symbols.size()), config);
+    } else {
+      encodeSymbols(symbols.data(), static_cast<unsigned int>(symbols.size()), config);
     }
   }
 
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Encodes a sequence of symbols in blocks, each with the candidate configuration of blockConfig with the fewest
+  // estimated bits (see BlockSwitchingConfig). The candidates are estimated per block by trial passes in the bit
+  // estimation mode (see estimateTrialFracBits), starting from the current context states and including the selection
+  // bins. The kernels of all candidates are selected once per sequence, such that switching only indexes a table.
+  // The context selection starts anew in each block, i.e. with previous symbols 0, as with separate encodeSymbols calls.
+  // Returns the selected candidate per block.
+  std::vector<unsigned int> encodeSymbolsBlockSwitching(const uint64_t * symbols, unsigned int numSymbols,
+    const BlockSwitchingConfig& blockConfig)
+  {
+    const std::vector<CodingConfig>& candidates = blockConfig.candidates;
+    const unsigned int numCandidates = static_cast<unsigned int>(candidates.size());
+    std::vector<symbolsWriter> kernels(numCandidates);
+    for (unsigned int c = 0; c < numCandidates; c++) {
+      kernels[c] = candidates[c].bypass ? getSymbolsBypassWriter(candidates[c]) : getSymbolsWriter(candidates[c]);
+    }
+
+    std::vector<unsigned int> selection;
+    selection.reserve((numSymbols + blockConfig.blockSize - 1) / blockConfig.blockSize);
+    for (unsigned int d0 = 0; d0 < numSymbols; d0 += blockConfig.blockSize) {
+      const uint64_t * block = symbols + d0;
+      const unsigned int n = std::min(blockConfig.blockSize, numSymbols - d0);
+      unsigned int cBest = 0;
+      if (numCandidates > 1) {
+        uint64_t bitsBest = UINT64_MAX;
+        for (unsigned int c = 0; c < numCandidates; c++) {
+          const CodingConfig& config = candidates[c];
+          const symbolsWriter kernel = kernels[c];
+          const unsigned int ctxEnd = config.bypass ? config.ctxOffset : config.ctxOffset + config.numContexts;
+          const uint64_t bits = estimateSelectionFracBits(blockConfig, c) +
+            estimateTrialFracBits(config.ctxOffset, ctxEnd, [&]() { (this->*kernel)(block, n, config); });
+          if (bits < bitsBest) {
+            bitsBest = bits;
+            cBest = c;
+          }
+        }
+        encodeSelection(blockConfig, cBest);
+      }
+      (this->*kernels[cBest])(block, n, candidates[cBest]);
+      selection.push_back(cBest);
+    }
+    return selection;
+  }
+
+  // Candidate index c, TU with one context per bin
+  void encodeSelection(const BlockSwitchingConfig& blockConfig, const unsigned int c)
+  {
+    const unsigned int numMaxBins = static_cast<unsigned int>(blockConfig.candidates.size()) - 1;
+    for (unsigned int i = 0; i < c; i++) {
+      encodeBin(1, blockConfig.ctxIdSelect + i);
+    }
+    if (c < numMaxBins) {
+      encodeBin(0, blockConfig.ctxIdSelect + c);
+    }
+  }
+
+  uint64_t estimateSelectionFracBits(const BlockSwitchingConfig& blockConfig, const unsigned int c) const
+  {
+    const unsigned int numMaxBins = static_cast<unsigned int>(blockConfig.candidates.size()) - 1;
+    uint64_t bits = 0;
+    for (unsigned int i = 0; i < c; i++) {
+      bits += estCtxFracBits(blockConfig.ctxIdSelect + i, 1);
+    }
+    if (c < numMaxBins) {
+      bits += estCtxFracBits(blockConfig.ctxIdSelect + c, 0);
+    }
+    return bits;
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Bypass-encodes a sequence of fixed-length symbols (BinarizationId::BI) after aligning the arithmetic coder once.
+  // The aligned bins are bit-packed directly, see encodeAlignedBinsEPArray. The sequence has to be read with
+  // decodeSymbolsBypassAligned, since align() changes the bitstream.
+  void encodeSymbolsBypassAligned(const uint64_t * symbols, unsigned int numSymbols,
+    binarization::BinarizationId binId, const std::vector<unsigned int>& binParams)
+  {
+    encodeSymbolsBypassAligned(symbols, numSymbols, CodingConfig(binId, binParams));
+  }
+
+  void encodeSymbolsBypassAligned(const uint64_t * symbols, unsigned int numSymbols, const CodingConfig& config)
+  {
+    if (config.binId != binarization::BinarizationId::BI) {
+      throw std::runtime_error("encodeSymbolsBypassAligned: Only supported for BinarizationId::BI");
+    }
+    encodeAlignedBinsEPArray(symbols, numSymbols, config.numMaxBins);
+  }
+
   // ---------------------------------------------------------------------------------------------------------------------
   // This is a general method for encoding a symbol for given binarization and context model
   // parameter definition see encodeSymbols
+  // Context-adaptive RICE is not supported, since its Rice parameter adapts to the previous symbols of a sequence
+  // (see encodeSymbols). Use encodeSymbolBypass for single RICE symbols.
   void encodeSymbol(const uint64_t symbol, const unsigned int d, const uint64_t * symbolsPrev, 
     binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId, 
-    const std::vector<unsigned int> binParams, const std::vector<unsigned int> ctxParams)
+    const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
   {   
-    // Get writer
-    binWriter func = getWriter(binId);
+    encodeSymbol(symbol, d, symbolsPrev, CodingConfig(binId, ctxModelId, binParams, ctxParams));
+  }
+
+  void encodeSymbol(const uint64_t symbol, const unsigned int d, const uint64_t * symbolsPrev,
+    const CodingConfig& config)
+  {
+    if (config.binId == binarization::BinarizationId::RICE) {
+      throw std::runtime_error("encodeSymbol: Context-adaptive RICE only supported for sequences (encodeSymbols)");
+    }
 
     // Get context id for each bin
-    const unsigned int numMaxBins = binParams[0];
-    std::vector<unsigned int> ctxIds(numMaxBins, 0);
-    contextSelector::getContextIds(ctxIds, d, symbolsPrev, binId, ctxModelId, binParams, ctxParams);
+    contextSelector::ContextIdProvider ctxIds(config);
+    ctxIds.setSymbol(d, symbolsPrev);
 
     // Encode symbol
-    (*this.*func)(symbol, ctxIds, binParams);
+    encodeBins(symbol, config, ctxIds);
   }
 
   // ---------------------------------------------------------------------------------------------------------------------
   // This is a general method for bypass-encoding a symbol for given binarization
   // parameter definition see encodeSymbols
   void encodeSymbolBypass(const uint64_t symbol, 
-    binarization::BinarizationId binId, const std::vector<unsigned int> binParams)
+    binarization::BinarizationId binId, const std::vector<unsigned int>& binParams)
   {
-    // Get writer
-    binBypassWriter func = getBypassWriter(binId);
+    encodeBinsBypass(symbol, CodingConfig(binId, binParams));
+  }
 
-    // Encode symbol
-    (*this.*func)(symbol, binParams);
+  void encodeSymbolBypass(const uint64_t symbol, const CodingConfig& config)
+  {
+    encodeBinsBypass(symbol, config);
   }
-  
 
 }; // class cabacSimpleSequenceEncoder
 
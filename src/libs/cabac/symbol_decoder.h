@@ -2,10 +2,12 @@
 
 #include "CommonDef.h"
 #include <cstdint>
+#include <stdexcept>
 #include <vector>
 
 #if RWTH_PYTHON_IF
 #include "bin_decoder.h"
+#include "binarization.h"
 
 class cabacSymbolDecoder : public cabacDecoder{
   public:
@@ -13,191 +15,192 @@ class cabacSymbolDecoder : public cabacDecoder{
 
     // ---------------------------------------------------------------------------------------------------------------------
     // Taken from GABAC/GENIE
+    // Up to 64 bins, read in chunks of 32 bins
     uint64_t decodeBinsBIbypass(const unsigned int numBins) {
-        return decodeBinsEP(numBins);
+        return decodeBinsEP64(numBins);
     }
 
     // ---------------------------------------------------------------------------------------------------------------------
     // Taken from GABAC/GENIE
-    uint64_t decodeBinsBI(CtxFunction &ctxFun, const unsigned int numBins) {
-        unsigned int bins = 0; // bins to decode
+    // Context IDs are given per bin by ctxIds, see getCtxId
+    template <class CtxProvider>
+    uint64_t decodeBinsBI(const CtxProvider &ctxIds, const unsigned int numBins) {
+        uint64_t bins = 0; // bins to decode
         unsigned int i = 0; // counter for context selection
         for (int exponent = numBins; exponent > 0; exponent--) {
-            bins = (bins << 1u) | decodeBin(ctxFun(i));
+            bins = (bins << 1u) | decodeBin(getCtxId(ctxIds, i));
             i++;
         }
-        return static_cast<uint64_t>(bins);
+        return bins;
+    }
+    // Slow path for context IDs given by a callback (e.g. from Python)
+    uint64_t decodeBinsBI(CtxFunction &ctxFun, const unsigned int numBins) {
+        return decodeBinsBI<CtxFunction>(ctxFun, numBins);
     }
     uint64_t decodeBinsBI(const unsigned int * ctxIds, const unsigned int numBins) {
-        // Create wrapper function for array ctxIds
-        CtxFunction ctxFun = [&ctxIds](unsigned int n) {
-            return ctxIds[n];
-        };
-        // Call decodeBinsBI with wrapper function
-        return decodeBinsBI(ctxFun, numBins);
+        return decodeBinsBI<const unsigned int *>(ctxIds, numBins);
     }
 
     // ---------------------------------------------------------------------------------------------------------------------
     // Taken from GABAC/GENIE
     uint64_t decodeBinsTUbypass(const unsigned int numMaxBins=512) {
-        unsigned int i = 0;
-        while (i < numMaxBins) {
-            if (decodeBinsEP(1) == 0) break;
-            i++;
-        }
-        return static_cast<uint64_t>(i);
+        return static_cast<uint64_t>(decodeOnesRunEP(numMaxBins));
     }
 
     // ---------------------------------------------------------------------------------------------------------------------
     // Taken from GABAC/GENIE
-    uint64_t decodeBinsTU(CtxFunction &ctxFun, const unsigned int numMaxBins=512) {
+    // Run mode from the rest position on, see cabacSymbolEncoder::encodeBinsTU
+    template <class CtxProvider>
+    uint64_t decodeBinsTU(const CtxProvider &ctxIds, const unsigned int numMaxBins=512) {
+        const unsigned int restPos = getRestPos(ctxIds);
         unsigned int i = 0;
 
         while (i < numMaxBins) {
-            if (decodeBin(ctxFun(i)) == 0) break;
+            const unsigned int ctxId = getCtxId(ctxIds, i);
+            if (i >= restPos && getMps(ctxId) == 1) {
+                i += static_cast<unsigned int>(decodeMPSRun(ctxId, numMaxBins - i));
+                if (i == numMaxBins) break;
+            }
+            if (decodeBin(ctxId) == 0) break;
             i++;
         }
         return static_cast<uint64_t>(i);
     }
+    // Slow path for context IDs given by a callback (e.g. from Python)
+    uint64_t decodeBinsTU(CtxFunction &ctxFun, const unsigned int numMaxBins=512) {
+        return decodeBinsTU<CtxFunction>(ctxFun, numMaxBins);
+    }
     uint64_t decodeBinsTU(const unsigned int * ctxIds, const unsigned int numMaxBins=512) {
-        CtxFunction ctxFun = [&ctxIds](unsigned int n) {
-            return ctxIds[n];
-        };
-        return decodeBinsTU(ctxFun, numMaxBins);
+        return decodeBinsTU<const unsigned int *>(ctxIds, numMaxBins);
     }
 
     // ---------------------------------------------------------------------------------------------------------------------
+    // EGk de-binarization for the full 64-bit range, see cabacSymbolEncoder::encodeBinsEGkbypass
     uint64_t decodeBinsEGkbypass(unsigned k) {
-
-        if (k == 0) { // Taken from GABAC/GENIE
-            unsigned int bins = 0;
-            unsigned int numBinsSuffix = 0;
-            while (decodeBinsBIbypass(1) == 0) {
-                numBinsSuffix++;
-            }
-            if (numBinsSuffix != 0) {
-                bins = (1u << numBinsSuffix) | decodeBinsEP(numBinsSuffix);
-                return static_cast<uint64_t>(bins - 1);
-            } else {
-                return 0;
-            }
-        } else {
-            unsigned int symbol = 0;
-
-            // Prefix
-            unsigned int numLeadZeros = 0;
-            while (decodeBinsBIbypass(1) == 0) {
-                numLeadZeros++;
-            }
-
-            // Suffix
-            auto m = (unsigned int)((1 << (numLeadZeros + k)) - (1 << k));
-            symbol = decodeBinsBIbypass(numLeadZeros + k);
-            symbol += m;
-
-            return static_cast<uint64_t>(symbol);
+        // Prefix
+        unsigned int numLeadZeros = 0;
+        while (decodeBinEP() == 0) {
+            numLeadZeros++;
         }
+
+        // Suffix
+        return decodeSuffixEGk(numLeadZeros, k);
     }
 
     // ---------------------------------------------------------------------------------------------------------------------
-    uint64_t decodeBinsEGk(unsigned k, CtxFunction &ctxFun) {
-
-        if (k == 0) { // Taken from GABAC/GENIE
-            // Prefix
-            unsigned int numBinsSuffix = 0;
-            while (decodeBin(ctxFun(numBinsSuffix)) == 0) {
-                numBinsSuffix++;
-            }
-
-            // Suffix
-            unsigned int bins = 0;
-            if (numBinsSuffix != 0) {
-                bins = (1u << numBinsSuffix) | decodeBinsEP(numBinsSuffix);
-                return static_cast<uint64_t>(bins - 1);
-            } else {
-                return 0;
-            }
-        } else {
-            unsigned int symbol = 0;
-
-            // Prefix
-            unsigned int numLeadZeros = 0;
-            while (decodeBin(ctxFun(numLeadZeros)) == 0) {
-                numLeadZeros++;
-            }
-
-            // Suffix
-            auto m = (unsigned int)((1 << (numLeadZeros + k)) - (1 << k));
-            symbol = decodeBinsBIbypass(numLeadZeros + k);
-            symbol += m;
-
-            return static_cast<uint64_t>(symbol);
+    template <class CtxProvider>
+    uint64_t decodeBinsEGk(unsigned k, const CtxProvider &ctxIds) {
+        // Prefix, context-coded
+        unsigned int numLeadZeros = 0;
+        while (decodeBin(getCtxId(ctxIds, numLeadZeros)) == 0) {
+            numLeadZeros++;
         }
+
+        // Suffix
+        return decodeSuffixEGk(numLeadZeros, k);
+    }
+    // Slow path for context IDs given by a callback (e.g. from Python)
+    uint64_t decodeBinsEGk(unsigned k, CtxFunction &ctxFun) {
+        return decodeBinsEGk<CtxFunction>(k, ctxFun);
     }
     uint64_t decodeBinsEGk(unsigned k, const unsigned int * ctxIds) {
-        CtxFunction ctxFun = [&ctxIds](unsigned int n) {
-            return ctxIds[n];
-        };
-        return decodeBinsEGk(k, ctxFun);
+        return decodeBinsEGk<const unsigned int *>(k, ctxIds);
     }
 
-
-    // ---------------------------------------------------------------------------------------------------------------------
-    // Overloaded functions for latter use in cabacSimpleSequenceDecoder
     // ---------------------------------------------------------------------------------------------------------------------
+    // Golomb-Rice de-binarization with context-coded prefix, see cabacSymbolEncoder::encodeBinsRICE
+    template <class CtxProvider>
+    uint64_t decodeBinsRICE(const CtxProvider &ctxIds, const unsigned int riceParam,
+        const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+        // Prefix, context-coded
+        unsigned int prefix = 0;
+        while (prefix < cutoff && decodeBin(getCtxId(ctxIds, prefix))) {
+            prefix++;
+        }
+        if (prefix == cutoff) {
+            return decodeRemAbsEscapeEP(riceParam, cutoff, maxLog2TrDynamicRange);
+        }
 
-    uint64_t decodeBinsBIbypass(const std::vector<unsigned int> binParams)
-    {
-        const unsigned int numBins = binParams[0];
-        return decodeBinsBIbypass(numBins);
+        // Suffix
+        return (static_cast<uint64_t>(prefix) << riceParam) + decodeBinsEP(riceParam);
     }
-
-    uint64_t decodeBinsBI(const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams)
-    {
-        const unsigned int numBins = binParams[0];
-        return decodeBinsBI(ctxIds.data(), numBins);
+    // Slow path for context IDs given by a callback (e.g. from Python)
+    uint64_t decodeBinsRICE(CtxFunction &ctxFun, const unsigned int riceParam,
+        const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+        return decodeBinsRICE<CtxFunction>(ctxFun, riceParam, cutoff, maxLog2TrDynamicRange);
     }
-
-    uint64_t decodeBinsTUbypass(const std::vector<unsigned int> binParams)
-    {
-        const unsigned int numMaxBins = binParams[0];
-        return decodeBinsTUbypass(numMaxBins);
+    uint64_t decodeBinsRICE(const unsigned int * ctxIds, const unsigned int riceParam,
+        const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+        return decodeBinsRICE<const unsigned int *>(ctxIds, riceParam, cutoff, maxLog2TrDynamicRange);
     }
 
-    uint64_t decodeBinsTU(const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams)
-    {
-        const unsigned int numMaxBins = binParams[0];
-        return decodeBinsTU(ctxIds.data(), numMaxBins);
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Truncated binary de-binarization, see cabacSymbolEncoder::encodeBinsTBbypass
+    uint64_t decodeBinsTBbypass(const unsigned int cMax) {
+        const binarization::TruncatedBinary tb(cMax);
+        const uint64_t value = decodeBinsEP64(tb.k);
+        if (value < tb.u) {
+            return value;
+        }
+        return ((value << 1) | decodeBinEP()) - tb.u;
     }
 
-    uint64_t decodeBinsEGkbypass(const std::vector<unsigned int> binParams)
-    {
-        const unsigned int k = binParams[1];
-        return decodeBinsEGkbypass(k);
+    template <class CtxProvider>
+    uint64_t decodeBinsTB(const CtxProvider &ctxIds, const unsigned int cMax) {
+        const binarization::TruncatedBinary tb(cMax);
+        uint64_t value = 0;
+        unsigned int i = 0;
+        for (; i < tb.k; i++) {
+            value = (value << 1) | decodeBin(getCtxId(ctxIds, i));
+        }
+        if (value < tb.u) {
+            return value;
+        }
+        return ((value << 1) | decodeBin(getCtxId(ctxIds, i))) - tb.u;
     }
-
-    uint64_t decodeBinsEGk(const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams)
-    {
-        const unsigned int k = binParams[1];
-        return decodeBinsEGk(k, ctxIds.data());
+    // Slow path for context IDs given by a callback (e.g. from Python)
+    uint64_t decodeBinsTB(CtxFunction &ctxFun, const unsigned int cMax) {
+        return decodeBinsTB<CtxFunction>(ctxFun, cMax);
+    }
+    uint64_t decodeBinsTB(const unsigned int * ctxIds, const unsigned int cMax) {
+        return decodeBinsTB<const unsigned int *>(ctxIds, cMax);
     }
 
-    uint64_t decodeBinsNAbypass(const std::vector<unsigned int> binParams)
-    {
-        return decodeBinEP();
+    // ---------------------------------------------------------------------------------------------------------------------
+    // UEGk de-binarization, see cabacSymbolEncoder::encodeBinsUEGkbypass
+    uint64_t decodeBinsUEGkbypass(const unsigned int cutoff, const unsigned int k) {
+        const uint64_t prefix = decodeBinsTUbypass(cutoff);
+        if (prefix < cutoff) {
+            return prefix;
+        }
+        return prefix + decodeBinsEGkbypass(k);
     }
 
-    uint64_t decodeBinsNA(const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams)
-    {
-        return decodeBin(ctxIds[0]);
+    template <class CtxProvider>
+    uint64_t decodeBinsUEGk(const CtxProvider &ctxIds, const unsigned int cutoff, const unsigned int k) {
+        const uint64_t prefix = decodeBinsTU(ctxIds, cutoff);
+        if (prefix < cutoff) {
+            return prefix;
+        }
+        return prefix + decodeBinsEGkbypass(k);
+    }
+    // Slow path for context IDs given by a callback (e.g. from Python)
+    uint64_t decodeBinsUEGk(CtxFunction &ctxFun, const unsigned int cutoff, const unsigned int k) {
+        return decodeBinsUEGk<CtxFunction>(ctxFun, cutoff, k);
+    }
+    uint64_t decodeBinsUEGk(const unsigned int * ctxIds, const unsigned int cutoff, const unsigned int k) {
+        return decodeBinsUEGk<const unsigned int *>(ctxIds, cutoff, k);
     }
 
-    uint64_t decodeBinsRicebypass(const std::vector<unsigned int> binParams)
-    {
-        const unsigned int riceParam = binParams[2];
-        const unsigned int cutoff = binParams[3];
-        const unsigned int maxLog2TrDynamicRange = binParams[4];
-        return decodeRemAbsEP(riceParam, cutoff, maxLog2TrDynamicRange);
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Bypass-decodes the EGk suffix of numLeadZeros+k bins and returns the symbol
+    uint64_t decodeSuffixEGk(const unsigned int numLeadZeros, const unsigned int k) {
+        if (numLeadZeros + k > 64) {
+            throw std::runtime_error("decodeBinsEGk: Prefix exceeds the 64-bit symbol range");
+        }
+        const uint64_t m = (numLeadZeros < 64 ? (uint64_t(1) << numLeadZeros) - 1 : ~uint64_t(0)) << k;
+        return m + decodeBinsEP64(numLeadZeros + k);
     }
 
 }; // class cabacSymbolDecoder
@@ -1,13 +1,16 @@
 #pragma once
 
 #include "CommonDef.h"
+#include <algorithm>
 #include <cstdint>
+#include <stdexcept>
 #include <vector>
 #include <cmath>
 
 
 #if RWTH_PYTHON_IF
 #include "bin_encoder.h"
+#include "binarization.h"
 
 
 // Here we binarize and encode integer symbols directly
@@ -17,171 +20,204 @@ public:
 
   // ---------------------------------------------------------------------------------------------------------------------
   // Taken from GABAC/GENIE
+  // Up to 64 bins, written in chunks of 32 bins
   void encodeBinsBIbypass(uint64_t symbol, const unsigned int numBins) {
-    encodeBinsEP(symbol, numBins);
+    encodeBinsEP64(symbol, numBins);
   }
 
   // ---------------------------------------------------------------------------------------------------------------------
   // Taken from GABAC/GENIE
-  void encodeBinsBI(uint64_t symbol, CtxFunction &ctxFun, const unsigned int numBins) {
+  // Context IDs are given per bin by ctxIds, see getCtxId
+  template <class CtxProvider>
+  void encodeBinsBI(uint64_t symbol, const CtxProvider &ctxIds, const unsigned int numBins) {
     unsigned int bin = 0;  // bin to encode
     unsigned int i = 0;  // counter for context selection
     for (int exponent = numBins - 1; exponent >= 0; exponent--) {  // i must be signed
       // 0x1u is the same as 0x1. (The u stands for unsigned.).
       bin = static_cast<unsigned int>(static_cast<uint64_t>(symbol) >> static_cast<uint8_t>(exponent)) & 0x1u;
-      encodeBin(bin, ctxFun(i));
+      encodeBin(bin, getCtxId(ctxIds, i));
       i++;
     }
   }
+  // Slow path for context IDs given by a callback (e.g. from Python)
+  void encodeBinsBI(uint64_t symbol, CtxFunction &ctxFun, const unsigned int numBins) {
+    encodeBinsBI<CtxFunction>(symbol, ctxFun, numBins);
+  }
   void encodeBinsBI(uint64_t symbol, const unsigned int * ctxIds, const unsigned int numBins) {
-    // Create wrapper function for array ctxIds
-    CtxFunction ctxFun = [&ctxIds](unsigned int n) {
-      return ctxIds[n];
-    };
-    // Call encodeBinsBI with wrapper function
-    encodeBinsBI(symbol, ctxFun, numBins);
+    encodeBinsBI<const unsigned int *>(symbol, ctxIds, numBins);
   }
 
   // ---------------------------------------------------------------------------------------------------------------------
   // Taken from GABAC/GENIE
+  // Runs of '1's are written in chunks of 16 bins
   void encodeBinsTUbypass(uint64_t symbol, const unsigned int numMaxBins=512) {
-    for (uint64_t i = 0; i < symbol; i++) {
-      encodeBinEP(1);
+    uint64_t numOnes = symbol;
+    for (; numOnes >= 16; numOnes -= 16) {
+      encodeBinsEP(0xffff, 16);
     }
+    const unsigned int ones = (1u << numOnes) - 1;
     if (numMaxBins > symbol) {  // symbol == numMaxBins is coded as all 1s
-      encodeBinEP(0); // terminating '0'
+      encodeBinsEP(ones << 1, (unsigned int)numOnes + 1); // terminating '0'
+    } else {
+      encodeBinsEP(ones, (unsigned int)numOnes);
     }
   }
 
   // ---------------------------------------------------------------------------------------------------------------------
   // Taken from GABAC/GENIE
-  void encodeBinsTU(uint64_t symbol, CtxFunction &ctxFun, const unsigned int numMaxBins=512) {
+  // The '1's from the rest position on (see getRestPos) share one context and are coded in run mode, while it has MPS 1
+  template <class CtxProvider>
+  void encodeBinsTU(uint64_t symbol, const CtxProvider &ctxIds, const unsigned int numMaxBins=512) {
     // Encode sequence of '1' bins of length 'symbol'
+    const uint64_t restPos = std::min<uint64_t>(getRestPos(ctxIds), symbol);
     uint64_t i;
-    for (i = 0; i < symbol; i++) {
-      encodeBin(1, ctxFun(i));
+    for (i = 0; i < restPos; i++) {
+      encodeBin(1, getCtxId(ctxIds, i));
+    }
+    for (; i < symbol; i++) {
+      const unsigned int ctxId = getCtxId(ctxIds, i);
+      if (getMps(ctxId) == 1) {
+        encodeMPSRun(ctxId, symbol - i);
+        i = symbol;
+        break;
+      }
+      encodeBin(1, ctxId);
     }
     // Encode terminating '0' bin
     if (symbol < numMaxBins) {  // symbol == numMaxBins is coded as all '1's
-      encodeBin(0, ctxFun(i)); // terminating '0'
+      encodeBin(0, getCtxId(ctxIds, i)); // terminating '0'
     }
   }
+  // Slow path for context IDs given by a callback (e.g. from Python)
+  void encodeBinsTU(uint64_t symbol, CtxFunction &ctxFun, const unsigned int numMaxBins=512) {
+    encodeBinsTU<CtxFunction>(symbol, ctxFun, numMaxBins);
+  }
   void encodeBinsTU(uint64_t symbol, const unsigned int * ctxIds, const unsigned int numMaxBins=512) {
-    CtxFunction ctxFun = [&ctxIds](unsigned int n) {
-      return ctxIds[n];
-    };
-    encodeBinsTU(symbol, ctxFun, numMaxBins);
+    encodeBinsTU<const unsigned int *>(symbol, ctxIds, numMaxBins);
   }
 
   // ---------------------------------------------------------------------------------------------------------------------
+  // EGk binarization for the full 64-bit range: numLeadZeros '0's and a terminating '1' (prefix), followed by
+  // symbol - (2^(numLeadZeros+k) - 2^k) in numLeadZeros+k bins (suffix)
   void encodeBinsEGkbypass(uint64_t symbol, unsigned k) {
-    if (k == 0) { // Taken from GABAC/GENIE
-      auto valuePlus1 = (unsigned int)(symbol + 1);
-      auto numLeadZeros = (unsigned int)floor(log2(valuePlus1));
-
-      // Prefix
-      encodeBinsBIbypass(1, numLeadZeros + 1); // TU encoding (numLeadZeros '0' and terminating '1')
-      if (numLeadZeros) {
-        // Suffix
-        encodeBinsBIbypass(valuePlus1 & ((1u << numLeadZeros) - 1), numLeadZeros);
-      }
-    } else {
-      auto numLeadZeros = (unsigned int)(floor(log2(symbol + (1 << k))) - k);
-      auto m = (unsigned int)((1 << (numLeadZeros + k)) - (1 << k));
+    const unsigned int numLeadZeros = binarization::getNumLeadZerosEGk(symbol, k);
+    const uint64_t m = (numLeadZeros < 64 ? (uint64_t(1) << numLeadZeros) - 1 : ~uint64_t(0)) << k;
 
-      // Prefix
-      encodeBinsBIbypass(1, numLeadZeros + 1); // TU encoding (numLeadZeros '0' and terminating '1')
-      // Suffix
-      encodeBinsBIbypass(symbol - m, numLeadZeros + k); // TU encoding of (symbol - m)
-    }
+    // Prefix
+    encodeBinsEP64(1, numLeadZeros + 1); // TU encoding (numLeadZeros '0' and terminating '1')
+    // Suffix
+    encodeBinsEP64(symbol - m, numLeadZeros + k);
   }
 
   // ---------------------------------------------------------------------------------------------------------------------
-  void encodeBinsEGk(uint64_t symbol, unsigned k, CtxFunction &ctxFun) {
-    if(k == 0){ // Taken from GABAC/GENIE
-      auto valuePlus1 = (unsigned int)(symbol + 1);
-      auto numLeadZeros = (unsigned int)floor(log2(valuePlus1));
-
-      // Prefix
-      encodeBinsBI(1, ctxFun, numLeadZeros + 1); // TU encoding (numLeadZeros '0' and terminating '1')
-      if (numLeadZeros) {
-        // Suffix
-        encodeBinsBIbypass(valuePlus1 & ((1u << numLeadZeros) - 1), numLeadZeros);
-      }
-    } else {
-      auto numLeadZeros = (unsigned int)(floor(log2(symbol + (1 << k))) - k);
-      auto m = (unsigned int)((1 << (numLeadZeros + k)) - (1 << k));
-
-      // Prefix
-      encodeBinsBI(1, ctxFun, numLeadZeros + 1); // TU encoding (numLeadZeros '0' and terminating '1')
-
-      // Suffix
-      encodeBinsBIbypass(symbol - m, numLeadZeros + k); // TU encoding of (symbol - m)
+  template <class CtxProvider>
+  void encodeBinsEGk(uint64_t symbol, unsigned k, const CtxProvider &ctxIds) {
+    const unsigned int numLeadZeros = binarization::getNumLeadZerosEGk(symbol, k);
+    const uint64_t m = (numLeadZeros < 64 ? (uint64_t(1) << numLeadZeros) - 1 : ~uint64_t(0)) << k;
+
+    // Prefix, context-coded
+    for (unsigned int i = 0; i < numLeadZeros; i++) {
+      encodeBin(0, getCtxId(ctxIds, i));
     }
+    encodeBin(1, getCtxId(ctxIds, numLeadZeros));
+
+    // Suffix
+    encodeBinsEP64(symbol - m, numLeadZeros + k);
+  }
+  // Slow path for context IDs given by a callback (e.g. from Python)
+  void encodeBinsEGk(uint64_t symbol, unsigned k, CtxFunction &ctxFun) {
+    encodeBinsEGk<CtxFunction>(symbol, k, ctxFun);
   }
   void encodeBinsEGk(uint64_t symbol, unsigned k, const unsigned int * ctxIds) {
-    CtxFunction ctxFun = [&ctxIds](unsigned int n) {
-      return ctxIds[n];
-    };
-    encodeBinsEGk(symbol, k, ctxFun);
+    encodeBinsEGk<const unsigned int *>(symbol, k, ctxIds);
   }
 
-
-  // ---------------------------------------------------------------------------------------------------------------------
-  // Overloaded functions for latter use in cabacSimpleSequenceEncoder
   // ---------------------------------------------------------------------------------------------------------------------
-  void encodeBinsBIbypass(uint64_t symbol, const std::vector<unsigned int> binParams) 
-  {
-    const unsigned int numBins = binParams[0];
-    encodeBinsBIbypass(symbol, numBins);
-  }
+  // Golomb-Rice binarization of encodeRemAbsEP, with the first cutoff bins of the unary prefix context-coded.
+  // The escape (prefix beyond cutoff and its suffix) and the riceParam LSBs are bypass-coded.
+  // Symbols above getMaxRemAbsEP(riceParam, cutoff, maxLog2TrDynamicRange) are rejected.
+  template <class CtxProvider>
+  void encodeBinsRICE(uint64_t symbol, const CtxProvider &ctxIds, const unsigned int riceParam,
+    const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+    if (symbol > getMaxRemAbsEP(riceParam, cutoff, maxLog2TrDynamicRange)) {
+      throw std::runtime_error("encodeBinsRICE: Symbol exceeds the range of the escape");
+    }
+    const unsigned int bins = static_cast<unsigned int>(symbol);
+    const unsigned int prefix = bins >> riceParam;
 
-  void encodeBinsBI(uint64_t symbol, const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams) 
-  {
-    const unsigned int numBins = binParams[0];
-    encodeBinsBI(symbol, ctxIds.data(), numBins);
-  }
+    // Prefix, context-coded
+    const unsigned int numOnes = std::min(prefix, cutoff);
+    for (unsigned int i = 0; i < numOnes; i++) {
+      encodeBin(1, getCtxId(ctxIds, i));
+    }
+    if (prefix >= cutoff) {
+      encodeRemAbsEscapeEP(bins, riceParam, cutoff, maxLog2TrDynamicRange, 0);
+      return;
+    }
+    encodeBin(0, getCtxId(ctxIds, prefix));
 
-  void encodeBinsTUbypass(uint64_t symbol, const std::vector<unsigned int> binParams) 
-  {
-    const unsigned int numMaxBins = binParams[0];
-    encodeBinsTUbypass(symbol, numMaxBins);
+    // Suffix
+    encodeBinsEP(bins & ((1u << riceParam) - 1), riceParam);
   }
-
-  void encodeBinsTU(uint64_t symbol, const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams) 
-  {
-    const unsigned int numMaxBins = binParams[0];
-    encodeBinsTU(symbol, ctxIds.data(), numMaxBins);
+  // Slow path for context IDs given by a callback (e.g. from Python)
+  void encodeBinsRICE(uint64_t symbol, CtxFunction &ctxFun, const unsigned int riceParam,
+    const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+    encodeBinsRICE<CtxFunction>(symbol, ctxFun, riceParam, cutoff, maxLog2TrDynamicRange);
   }
-
-  void encodeBinsEGkbypass(uint64_t symbol, const std::vector<unsigned int> binParams) 
-  {
-    const unsigned int k = binParams[1];
-    encodeBinsEGkbypass(symbol, k);
+  void encodeBinsRICE(uint64_t symbol, const unsigned int * ctxIds, const unsigned int riceParam,
+    const unsigned int cutoff, const unsigned int maxLog2TrDynamicRange) {
+    encodeBinsRICE<const unsigned int *>(symbol, ctxIds, riceParam, cutoff, maxLog2TrDynamicRange);
   }
 
-  void encodeBinsEGk(uint64_t symbol, const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams) 
-  {
-    const unsigned int k = binParams[1];
-    encodeBinsEGk(symbol, k, ctxIds.data());
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Truncated binary binarization of symbol in [0, cMax], see binarization::TruncatedBinary
+  void encodeBinsTBbypass(uint64_t symbol, const unsigned int cMax) {
+    const binarization::TruncatedBinary tb(cMax);
+    encodeBinsEP64(tb.getCodeword(symbol), tb.getNumBins(symbol));
+  }
+
+  template <class CtxProvider>
+  void encodeBinsTB(uint64_t symbol, const CtxProvider &ctxIds, const unsigned int cMax) {
+    const binarization::TruncatedBinary tb(cMax);
+    const uint64_t codeword = tb.getCodeword(symbol);
+    const unsigned int numBins = tb.getNumBins(symbol);
+    for (unsigned int i = 0; i < numBins; i++) {
+      encodeBin(static_cast<unsigned int>(codeword >> (numBins - 1 - i)) & 0x1u, getCtxId(ctxIds, i));
+    }
   }
-
-  void encodeBinsNAbypass(uint64_t symbol, const std::vector<unsigned int> binParams) 
-  {
-    encodeBinEP(symbol);
+  // Slow path for context IDs given by a callback (e.g. from Python)
+  void encodeBinsTB(uint64_t symbol, CtxFunction &ctxFun, const unsigned int cMax) {
+    encodeBinsTB<CtxFunction>(symbol, ctxFun, cMax);
+  }
+  void encodeBinsTB(uint64_t symbol, const unsigned int * ctxIds, const unsigned int cMax) {
+    encodeBinsTB<const unsigned int *>(symbol, ctxIds, cMax);
   }
 
-  void encodeBinsNA(uint64_t symbol, const std::vector<unsigned int>& ctxIds, const std::vector<unsigned int> binParams) 
-  {
-    encodeBin(symbol, ctxIds[0]);
+  // ---------------------------------------------------------------------------------------------------------------------
+  // Concatenated TU prefix and EGk suffix (UEGk), as for coefficient levels in H.264/AVC CABAC:
+  // TU prefix of min(symbol, cutoff) '1's (terminated by a '0' below cutoff), followed by the EGk-binarized
+  // escape symbol - cutoff for symbol >= cutoff
+  void encodeBinsUEGkbypass(uint64_t symbol, const unsigned int cutoff, const unsigned int k) {
+    encodeBinsTUbypass(std::min<uint64_t>(symbol, cutoff), cutoff);
+    if (symbol >= cutoff) {
+      encodeBinsEGkbypass(symbol - cutoff, k);
+    }
   }
 
-  void encodeBinsRicebypass(uint64_t symbol, const std::vector<unsigned int> binParams) 
-  {
-    const unsigned int riceParam = binParams[2];
-    const unsigned int cutoff = binParams[3];
-    const unsigned int maxLog2TrDynamicRange = binParams[4];
-    encodeRemAbsEP(symbol, riceParam, cutoff, maxLog2TrDynamicRange);
+  // Same as above, with context-coded prefix and bypass-coded escape
+  template <class CtxProvider>
+  void encodeBinsUEGk(uint64_t symbol, const CtxProvider &ctxIds, const unsigned int cutoff, const unsigned int k) {
+    encodeBinsTU(std::min<uint64_t>(symbol, cutoff), ctxIds, cutoff);
+    if (symbol >= cutoff) {
+      encodeBinsEGkbypass(symbol - cutoff, k);
+    }
+  }
+  // Slow path for context IDs given by a callback (e.g. from Python)
+  void encodeBinsUEGk(uint64_t symbol, CtxFunction &ctxFun, const unsigned int cutoff, const unsigned int k) {
+    encodeBinsUEGk<CtxFunction>(symbol, ctxFun, cutoff, k);
+  }
+  void encodeBinsUEGk(uint64_t symbol, const unsigned int * ctxIds, const unsigned int cutoff, const unsigned int k) {
+    encodeBinsUEGk<const unsigned int *>(symbol, ctxIds, cutoff, k);
   }
 
 };  // class cabacSymbolEncoder
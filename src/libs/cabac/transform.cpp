@@ -0,0 +1,203 @@
+#include "transform.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+#if RWTH_PYTHON_IF
+namespace transform{
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  EqualityStreams encodeEquality(const uint64_t * symbols, const unsigned int numSymbols) {
+    EqualityStreams streams;
+    streams.flags.resize(numSymbols);
+    uint64_t symbolPrev = 0;
+    for (unsigned int i = 0; i < numSymbols; i++) {
+      const uint64_t symbol = symbols[i];
+      streams.flags[i] = symbol == symbolPrev;
+      if (symbol != symbolPrev) {
+        streams.values.push_back(symbol > symbolPrev ? symbol - 1 : symbol);
+      }
+      symbolPrev = symbol;
+    }
+    return streams;
+  }
+
+  void decodeEquality(const EqualityStreams& streams, uint64_t * symbols) {
+    uint64_t symbolPrev = 0;
+    size_t v = 0;
+    for (size_t i = 0; i < streams.flags.size(); i++) {
+      if (!streams.flags[i]) {
+        if (v == streams.values.size()) {
+          throw std::runtime_error("decodeEquality: Not enough values");
+        }
+        const uint64_t value = streams.values[v++];
+        symbolPrev = value >= symbolPrev ? value + 1 : value;
+      }
+      symbols[i] = symbolPrev;
+    }
+    if (v != streams.values.size()) {
+      throw std::runtime_error("decodeEquality: Unused values");
+    }
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  RunLengthStreams encodeRunLength(const uint64_t * symbols, const unsigned int numSymbols, const uint64_t guard) {
+    RunLengthStreams streams;
+    unsigned int i = 0;
+    while (i < numSymbols) {
+      const uint64_t symbol = symbols[i];
+      uint64_t runLength = 1;
+      while (i + runLength < numSymbols && symbols[i + runLength] == symbol) {
+        runLength++;
+      }
+      i += static_cast<unsigned int>(runLength);
+
+      streams.values.push_back(symbol);
+      if (guard > 0) {
+        for (; runLength > guard; runLength -= guard) {
+          streams.lengths.push_back(guard);
+        }
+      }
+      streams.lengths.push_back(runLength - 1);
+    }
+    return streams;
+  }
+
+  unsigned int getNumRuns(const std::vector<uint64_t>& lengths, const uint64_t guard) {
+    if (guard == 0) {
+      return static_cast<unsigned int>(lengths.size());
+    }
+    return static_cast<unsigned int>(std::count_if(lengths.begin(), lengths.end(),
+      [guard](const uint64_t length) { return length < guard; }));
+  }
+
+  void decodeRunLength(const RunLengthStreams& streams, const uint64_t guard, const unsigned int numSymbols,
+    uint64_t * symbols) {
+    size_t i = 0;
+    size_t v = 0;
+    for (const uint64_t length : streams.lengths) {
+      if (v == streams.values.size()) {
+        throw std::runtime_error("decodeRunLength: Not enough values");
+      }
+      const bool continued = guard > 0 && length == guard;
+      const uint64_t runLength = continued ? guard : length + 1;
+      if (runLength > numSymbols - i) {
+        throw std::runtime_error("decodeRunLength: Invalid run length");
+      }
+      std::fill(symbols + i, symbols + i + runLength, streams.values[v]);
+      i += runLength;
+      if (!continued) {
+        v++;
+      }
+    }
+    if (i != numSymbols || v != streams.values.size()) {
+      throw std::runtime_error("decodeRunLength: Runs do not match the number of symbols");
+    }
+  }
+
+  // ---------------------------------------------------------------------------------------------------------------------
+  static const unsigned int hashBits = 16;
+
+  static unsigned int getMatchHash(const uint64_t * symbols) {
+    uint64_t hash = 0;
+    for (unsigned int n = 0; n < minMatchLength; n++) {
+      hash = (hash ^ symbols[n]) * 0x9E3779B97F4A7C15ull;
+    }
+    return static_cast<unsigned int>(hash >> (64 - hashBits));
+  }
+
+  MatchStreams encodeMatch(const uint64_t * symbols, const unsigned int numSymbols, const unsigned int windowSize) {
+    if (windowSize == 0) {
+      throw std::runtime_error("encodeMatch: Window size must be at least 1");
+    }
+    MatchStreams streams;
+
+    // Hash chains of the previous positions: head per hash, previous position with equal hash per position (+1, such
+    // that 0 terminates the chain)
+    std::vector<unsigned int> head(1u << hashBits, 0);
+    std::vector<unsigned int> chain(numSymbols, 0);
+    auto insert = [&](const unsigned int pos) {
+      if (pos + minMatchLength <= numSymbols) {
+        const unsigned int hash = getMatchHash(symbols + pos);
+        chain[pos] = head[hash];
+        head[hash] = pos + 1;
+      }
+    };
+
+    unsigned int i = 0;
+    while (i < numSymbols) {
+      unsigned int matchLength = 0;
+      unsigned int matchPos = 0;
+      if (i + minMatchLength <= numSymbols) {
+        unsigned int candidate = head[getMatchHash(symbols + i)];
+        for (unsigned int c = 0; candidate > 0 && i - (candidate - 1) <= windowSize && c < maxChainLength; c++) {
+          const unsigned int pos = candidate - 1;
+          unsigned int length = 0;
+          while (i + length < numSymbols && symbols[pos + length] == symbols[i + length]) {
+            length++;
+          }
+          if (length > matchLength) {
+            matchLength = length;
+            matchPos = pos;
+            if (i + length == numSymbols) {
+              break;
+            }
+          }
+          candidate = chain[pos];
+        }
+      }
+
+      if (matchLength >= minMatchLength) {
+        streams.lengths.push_back(matchLength - minMatchLength + 1);
+        streams.offsets.push_back(i - matchPos - 1);
+        for (unsigned int n = 0; n < matchLength; n++) {
+          insert(i + n);
+        }
+        i += matchLength;
+      } else {
+        streams.lengths.push_back(0);
+        streams.literals.push_back(symbols[i]);
+        insert(i);
+        i++;
+      }
+    }
+    return streams;
+  }
+
+  unsigned int getNumMatches(const std::vector<uint64_t>& lengths) {
+    return static_cast<unsigned int>(std::count_if(lengths.begin(), lengths.end(),
+      [](const uint64_t length) { return length > 0; }));
+  }
+
+  void decodeMatch(const MatchStreams& streams, const unsigned int numSymbols, uint64_t * symbols) {
+    size_t i = 0;
+    size_t m = 0;
+    size_t l = 0;
+    for (const uint64_t length : streams.lengths) {
+      if (length == 0) {
+        if (l == streams.literals.size() || i >= numSymbols) {
+          throw std::runtime_error("decodeMatch: Invalid literal");
+        }
+        symbols[i++] = streams.literals[l++];
+        continue;
+      }
+      if (m == streams.offsets.size()) {
+        throw std::runtime_error("decodeMatch: Not enough offsets");
+      }
+      const uint64_t offset = streams.offsets[m++] + 1;
+      const uint64_t matchLength = length + minMatchLength - 1;
+      if (offset > i || matchLength > numSymbols - i) {
+        throw std::runtime_error("decodeMatch: Invalid match");
+      }
+      for (uint64_t n = 0; n < matchLength; n++, i++) {  // element-wise, since matches may overlap
+        symbols[i] = symbols[i - offset];
+      }
+    }
+    if (i != numSymbols || l != streams.literals.size() || m != streams.offsets.size()) {
+      throw std::runtime_error("decodeMatch: Tokens do not match the number of symbols");
+    }
+  }
+
+};  // namespace transform
+
+#endif  // RWTH_PYTHON_IF
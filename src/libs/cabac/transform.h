@@ -0,0 +1,64 @@
+#ifndef __RWTH_TRANSFORM_H__
+#define __RWTH_TRANSFORM_H__
+
+#include "CommonDef.h"
+#include <cstdint>
+#include <vector>
+
+#if RWTH_PYTHON_IF
+namespace transform{
+
+    // ---------------------------------------------------------------------------------------------------------------------
+    // Sequence transforms (taken from GABAC/GENIE), applied before the CABAC stage. Each transform splits a sequence of
+    // symbols into sub-streams, which are coded with the existing binarizations and context models, see
+    // cabacSimpleSequenceEncoder::encodeSymbolsEquality, encodeSymbolsRunLength and encodeSymbolsMatch.
+    // The decode functions throw, unless the sub-streams yield exactly the expected number of symbols and are used up.
+
+    // Equality coding: flags[i] = 1, if symbols[i] equals the previous symbol (0 before the first symbol). Otherwise,
+    // the symbol is appended to values, reduced by one if it is larger than the previous symbol, since both can not be
+    // equal.
+    struct EqualityStreams {
+        std::vector<uint64_t> flags;
+        std::vector<uint64_t> values;
+    };
+
+    EqualityStreams encodeEquality(const uint64_t * symbols, const unsigned int numSymbols);
+    void decodeEquality(const EqualityStreams& streams, uint64_t * symbols);
+
+    // Run-length coding: one entry in values per run of equal symbols. The run length L is split into lengths entries
+    // of at most guard: guard is appended while L > guard (the run continues), followed by L - 1. Thus, lengths are in
+    // [0, guard], and guard = 0 disables the splitting.
+    struct RunLengthStreams {
+        std::vector<uint64_t> values;
+        std::vector<uint64_t> lengths;
+    };
+
+    RunLengthStreams encodeRunLength(const uint64_t * symbols, const unsigned int numSymbols, const uint64_t guard);
+    // Number of values, i.e. runs, of given lengths
+    unsigned int getNumRuns(const std::vector<uint64_t>& lengths, const uint64_t guard);
+    void decodeRunLength(const RunLengthStreams& streams, const uint64_t guard, const unsigned int numSymbols,
+        uint64_t * symbols);
+
+    // LZ-like match coding against a sliding window of the previous windowSize symbols: per token, lengths holds 0 for a
+    // literal (appended to literals) or L - minMatchLength + 1 for a match of L >= minMatchLength symbols, starting
+    // offset symbols before the current position (offsets holds offset - 1, in [0, windowSize)). Matches may overlap
+    // the current position, i.e. repeat a period shorter than L. The longest match is searched among the previous
+    // positions with equal hash of the next minMatchLength symbols (at most maxChainLength candidates).
+    struct MatchStreams {
+        std::vector<uint64_t> lengths;
+        std::vector<uint64_t> offsets;
+        std::vector<uint64_t> literals;
+    };
+
+    static const unsigned int minMatchLength = 3;
+    static const unsigned int maxChainLength = 64;
+
+    MatchStreams encodeMatch(const uint64_t * symbols, const unsigned int numSymbols, const unsigned int windowSize);
+    // Number of matches of given lengths. The number of literals is lengths.size() - getNumMatches(lengths).
+    unsigned int getNumMatches(const std::vector<uint64_t>& lengths);
+    void decodeMatch(const MatchStreams& streams, const unsigned int numSymbols, uint64_t * symbols);
+
+};  // namespace transform
+
+#endif  // RWTH_PYTHON_IF
+#endif  // __RWTH_TRANSFORM_H__
@@ -3,8 +3,10 @@
 
 #include "common.h"
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <new>
 #include <random>
 #include <vector>
 
@@ -42,3 +44,65 @@ void fillVectorRandomGeometric(std::vector<uint64_t> *const vector) {
     });
 }
 
+// Heap allocations are counted via replaced global operators new and delete. All forms are replaced together, so that
+// every allocation is released by the matching replacement. They are defined here rather than in the tests, since
+// inlining them into the code under test triggers -Wmismatched-new-delete (new and free of the same pointer). The
+// counter is per thread, since other tests of the same binary allocate from worker threads.
+static thread_local size_t numAllocations = 0;
+
+static void* countedAlloc(std::size_t size) noexcept {
+    numAllocations++;
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new(std::size_t size) {
+    void* ptr = countedAlloc(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    void* ptr = countedAlloc(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+size_t getNumAllocations() {
+    return numAllocations;
+}
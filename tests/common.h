@@ -2,10 +2,14 @@
 #define CABAC_TESTS_COMMON_H_
 
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 void fillVectorRandomUniform(uint64_t min, uint64_t max, std::vector<uint64_t> *vector);
 void fillVectorRandomGeometric(std::vector<uint64_t> *const vector);
 
+// Number of heap allocations (global operator new) of the calling thread so far
+size_t getNumAllocations();
+
 
 #endif  // GABAC_TESTS_COMMON_H_
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "catch/catch.hpp"
+
+
+#include "cabac/sequence_encoder.h"
+#include "cabac/sequence_decoder.h"
+#include "common.h"
+
+
+struct AllocationCount {
+    size_t encoder;
+    size_t decoder;
+};
+
+static AllocationCount countSequenceAllocations(const std::vector<uint64_t>& symbols, const bool bypass,
+    binarization::BinarizationId binId, contextSelector::ContextModelId ctxModelId,
+    const std::vector<unsigned int>& binParams, const std::vector<unsigned int>& ctxParams)
+{
+    AllocationCount count;
+    const unsigned int numCtx = bypass ? 0 : contextSelector::getNumContexts(binId, ctxModelId, binParams, ctxParams);
+
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(numCtx, 0.5, 8);
+    encoder.start();
+    size_t numAllocationsStart = getNumAllocations();
+    if (bypass) {
+        encoder.encodeSymbolsBypass(symbols.data(), symbols.size(), binId, binParams);
+    } else {
+        encoder.encodeSymbols(symbols.data(), symbols.size(), binId, ctxModelId, binParams, ctxParams);
+    }
+    count.encoder = getNumAllocations() - numAllocationsStart;
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    std::vector<uint64_t> symbolsDecoded(symbols.size(), 0);
+    cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(numCtx, 0.5, 8);
+    decoder.start();
+    numAllocationsStart = getNumAllocations();
+    if (bypass) {
+        decoder.decodeSymbolsBypass(symbolsDecoded.data(), symbols.size(), binId, binParams);
+    } else {
+        decoder.decodeSymbols(symbolsDecoded.data(), symbols.size(), binId, ctxModelId, binParams, ctxParams);
+    }
+    count.decoder = getNumAllocations() - numAllocationsStart;
+    decoder.decodeBinTrm();
+    decoder.finish();
+
+    REQUIRE(symbolsDecoded == symbols);
+    return count;
+}
+
+
+TEST_CASE("test_sequenceCodingAllocations")
+{
+    std::cout << "--- test_sequenceCodingAllocations" << std::endl;
+
+    std::vector<uint64_t> symbols(40000);
+    fillVectorRandomGeometric(&symbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 255);
+    }
+    const std::vector<uint64_t> symbolsShort(symbols.begin(), symbols.begin() + symbols.size() / 8);
+
+    struct Config {
+        bool bypass;
+        binarization::BinarizationId binId;
+        contextSelector::ContextModelId ctxModelId;
+        std::vector<unsigned int> binParams;
+    };
+    const std::vector<Config> configs = {
+        {false, binarization::BinarizationId::BI, contextSelector::ContextModelId::BINSORDERN, {8}},
+        {false, binarization::BinarizationId::TU, contextSelector::ContextModelId::BINSORDERNSYMBOLPOSITION, {255}},
+        {false, binarization::BinarizationId::TU, contextSelector::ContextModelId::SYMBOLORDERN, {255}},
+        {false, binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINSORDERN, {255, 1}},
+        {true, binarization::BinarizationId::TU, contextSelector::ContextModelId::BAC, {255}},
+        {true, binarization::BinarizationId::EGk, contextSelector::ContextModelId::BAC, {255, 1}},
+        {true, binarization::BinarizationId::RICE, contextSelector::ContextModelId::BAC, {0, 0, 1, 5, 15}},
+    };
+    // order, restPos, offset, symbolMax, symbolPosMode, idx1..3
+    const std::vector<unsigned int> ctxParams = {3, 8, 0, 4, 1, 10, 100, 1000};
+
+    for (const auto& config : configs) {
+        AllocationCount countShort = countSequenceAllocations(symbolsShort, config.bypass, config.binId,
+            config.ctxModelId, config.binParams, ctxParams);
+        AllocationCount countLong = countSequenceAllocations(symbols, config.bypass, config.binId,
+            config.ctxModelId, config.binParams, ctxParams);
+
+        // Decoder: constant setup cost, independent of the number of symbols
+        REQUIRE(countLong.decoder == countShort.decoder);
+        // Encoder: only the bitstream grows (geometrically), 8x the symbols may cost at most a few reallocations
+        REQUIRE(countLong.encoder <= countShort.encoder + 4);
+    }
+}
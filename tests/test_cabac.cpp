@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <tuple>
 #include <utility>
@@ -11,6 +16,11 @@
 #include "cabac/sequence_encoder.h"
 #include "cabac/sequence_decoder.h"
 #include "cabac/bitstream.h"
+#include "cabac/coding_config.h"
+#include "cabac/multi_symbol_coder.h"
+#include "cabac/rans_coder.h"
+#include "cabac/context_training.h"
+#include "cabac/autotune.h"
 #include "common.h"
 
 
@@ -527,3 +537,2440 @@ TEST_CASE("test_encodeRemAbsEP")
     
     REQUIRE_THAT(symbols, Catch::Matchers::UnorderedEquals(symbolsDecoded));
 }
+
+
+TEST_CASE("test_encodeRemAbsEPArray")
+{
+    std::cout << "--- test_encodeRemAbsEPArray" << std::endl;
+
+    const unsigned int cutoff = 5;
+    const int maxLog2TrDynamicRange = 15;
+    std::vector<uint64_t> symbols;
+    std::vector<unsigned int> ricePars;
+    for (uint64_t symbol = 0; symbol < 300; symbol++) {
+        symbols.push_back(symbol);
+    }
+    for (unsigned int e = 9; e <= maxLog2TrDynamicRange; e++) {  // escape codes, up to the maximum prefix length
+        symbols.push_back((uint64_t(1) << e) - 1);
+        symbols.push_back(uint64_t(1) << e);
+    }
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        ricePars.push_back(i % 4);
+    }
+
+    // Array coding must be identical to coding each symbol
+    cabacEncoder encoderRef;
+    encoderRef.start();
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        encoderRef.encodeRemAbsEP(symbols[i], 1, cutoff, maxLog2TrDynamicRange);
+    }
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        encoderRef.encodeRemAbsEP(symbols[i], ricePars[i], cutoff, maxLog2TrDynamicRange);
+    }
+    encoderRef.encodeBinTrm(1);
+    encoderRef.finish();
+    encoderRef.writeByteAlignment();
+
+    cabacEncoder encoder;
+    encoder.start();
+    encoder.encodeRemAbsEPArray(symbols.data(), symbols.size(), 1, cutoff, maxLog2TrDynamicRange);
+    encoder.encodeRemAbsEPArray(symbols.data(), symbols.size(), ricePars.data(), cutoff, maxLog2TrDynamicRange);
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+    REQUIRE(encoder.getBitstream() == encoderRef.getBitstream());
+
+    cabacDecoder decoder(encoder.getBitstream());
+    decoder.start();
+    std::vector<uint64_t> symbolsDecoded(symbols.size());
+    decoder.decodeRemAbsEPArray(symbolsDecoded.data(), symbolsDecoded.size(), 1, cutoff, maxLog2TrDynamicRange);
+    REQUIRE(symbolsDecoded == symbols);
+    decoder.decodeRemAbsEPArray(symbolsDecoded.data(), symbolsDecoded.size(), ricePars.data(), cutoff, maxLog2TrDynamicRange);
+    REQUIRE(symbolsDecoded == symbols);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+
+    // Symbols beyond the range of the escape (also beyond 32 bits) are rejected instead of truncated
+    const uint64_t maxSymbol = getMaxRemAbsEP(1, cutoff, maxLog2TrDynamicRange);
+    for (const uint64_t symbolOutside : {maxSymbol + 1, uint64_t(1) << 33}) {
+        const std::vector<uint64_t> symbolsOutside = {0, symbolOutside};
+        const std::vector<unsigned int> ricePar1 = {1, 1};
+        REQUIRE_THROWS(encoder.encodeRemAbsEPArray(symbolsOutside.data(), 2, 1, cutoff, maxLog2TrDynamicRange));
+        REQUIRE_THROWS(encoder.encodeRemAbsEPArray(symbolsOutside.data(), 2, ricePar1.data(), cutoff,
+            maxLog2TrDynamicRange));
+    }
+    const std::vector<uint64_t> symbolMax = {maxSymbol};
+    cabacEncoder encoderMax;
+    encoderMax.start();
+    encoderMax.encodeRemAbsEPArray(symbolMax.data(), 1, 1, cutoff, maxLog2TrDynamicRange);
+    encoderMax.encodeBinTrm(1);
+    encoderMax.finish();
+    encoderMax.writeByteAlignment();
+    cabacDecoder decoderMax(encoderMax.getBitstream());
+    decoderMax.start();
+    std::vector<uint64_t> symbolMaxDecoded(1);
+    decoderMax.decodeRemAbsEPArray(symbolMaxDecoded.data(), 1, 1, cutoff, maxLog2TrDynamicRange);
+    REQUIRE(symbolMaxDecoded == symbolMax);
+    REQUIRE(decoderMax.decodeBinTrm() == 1);
+}
+
+
+TEST_CASE("test_encodeSymbolsPrecomputed")
+{
+    std::cout << "--- test_encodeSymbolsPrecomputed" << std::endl;
+
+    const int numSymbols = 70000;  // more than one block of precomputed context IDs
+    std::vector<uint64_t> symbols(numSymbols);
+    fillVectorRandomGeometric(&symbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 255);
+    }
+
+    const std::vector<std::tuple<binarization::BinarizationId, std::vector<unsigned int>>> binarizations = {
+        std::make_tuple(binarization::BinarizationId::BI, std::vector<unsigned int>{8}),
+        std::make_tuple(binarization::BinarizationId::TU, std::vector<unsigned int>{255}),
+        std::make_tuple(binarization::BinarizationId::EGk, std::vector<unsigned int>{255, 1}),
+        std::make_tuple(binarization::BinarizationId::TB, std::vector<unsigned int>{299}),
+        std::make_tuple(binarization::BinarizationId::UEGk, std::vector<unsigned int>{4, 1}),
+    };
+    const std::vector<contextSelector::ContextModelId> ctxModelIds = {
+        contextSelector::ContextModelId::BAC,
+        contextSelector::ContextModelId::BINPOSITION,
+        contextSelector::ContextModelId::BINSORDERN,
+        contextSelector::ContextModelId::SYMBOLORDERN,
+        contextSelector::ContextModelId::SYMBOLPOSITION,
+        contextSelector::ContextModelId::BINSYMBOLPOSITION,
+        contextSelector::ContextModelId::BINSORDERNSYMBOLPOSITION,
+        contextSelector::ContextModelId::SYMBOLORDERNSYMBOLPOSITION,
+    };
+
+    for (const auto& binarization : binarizations) {
+        for (const auto ctxModelId : ctxModelIds) {
+            for (unsigned int order = 1; order <= 3; order++) {
+                for (const unsigned int restPos : {6u, 12u}) {  // 12: beyond the longest TB codeword
+                    const binarization::BinarizationId binId = std::get<0>(binarization);
+                    const std::vector<unsigned int>& binParams = std::get<1>(binarization);
+                    // order, restPos, offset, symbolMax, symbolPosMode, idx1..3
+                    const std::vector<unsigned int> ctxParams = {order, restPos, 2, 4, 1, 10, 100, 1000};
+                    const unsigned int numCtx = contextSelector::getNumContexts(binId, ctxModelId, binParams, ctxParams) + 2;
+
+                    cabacSimpleSequenceEncoder encoderRef;
+                    encoderRef.initCtx(numCtx, 0.5, 8);
+                    encoderRef.start();
+                    encoderRef.encodeSymbols(symbols.data(), symbols.size(), binId, ctxModelId, binParams, ctxParams);
+                    encoderRef.encodeBinTrm(1);
+                    encoderRef.finish();
+                    encoderRef.writeByteAlignment();
+
+                    cabacSimpleSequenceEncoder encoder;
+                    encoder.initCtx(numCtx, 0.5, 8);
+                    encoder.start();
+                    encoder.encodeSymbolsPrecomputed(symbols.data(), symbols.size(), binId, ctxModelId, binParams, ctxParams, 4);
+                    encoder.encodeBinTrm(1);
+                    encoder.finish();
+                    encoder.writeByteAlignment();
+
+                    REQUIRE(encoderRef.getBitstream() == encoder.getBitstream());
+                }
+            }
+        }
+    }
+}
+
+
+TEST_CASE("test_sequenceKernels")
+{
+    std::cout << "--- test_sequenceKernels" << std::endl;
+
+    const int numSymbols = 5000;
+    std::vector<uint64_t> symbols(numSymbols);
+    fillVectorRandomGeometric(&symbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 255);
+    }
+
+    const std::vector<std::tuple<binarization::BinarizationId, std::vector<unsigned int>>> binarizations = {
+        std::make_tuple(binarization::BinarizationId::BI, std::vector<unsigned int>{8}),
+        std::make_tuple(binarization::BinarizationId::TU, std::vector<unsigned int>{255}),
+        std::make_tuple(binarization::BinarizationId::EGk, std::vector<unsigned int>{255, 0}),
+        std::make_tuple(binarization::BinarizationId::EGk, std::vector<unsigned int>{255, 2}),
+        std::make_tuple(binarization::BinarizationId::TB, std::vector<unsigned int>{299}),
+        std::make_tuple(binarization::BinarizationId::UEGk, std::vector<unsigned int>{4, 1}),
+    };
+    const std::vector<contextSelector::ContextModelId> ctxModelIds = {
+        contextSelector::ContextModelId::BAC,
+        contextSelector::ContextModelId::BINPOSITION,
+        contextSelector::ContextModelId::BINSORDERN,
+        contextSelector::ContextModelId::SYMBOLORDERN,
+        contextSelector::ContextModelId::SYMBOLPOSITION,
+        contextSelector::ContextModelId::BINSYMBOLPOSITION,
+        contextSelector::ContextModelId::BINSORDERNSYMBOLPOSITION,
+        contextSelector::ContextModelId::SYMBOLORDERNSYMBOLPOSITION,
+    };
+
+    // Context-adaptive kernels: round trip for each (binarization, context model, order)
+    for (const auto& binarization : binarizations) {
+        for (const auto ctxModelId : ctxModelIds) {
+            for (unsigned int order = 1; order <= 3; order++) {
+                const binarization::BinarizationId binId = std::get<0>(binarization);
+                const std::vector<unsigned int>& binParams = std::get<1>(binarization);
+                const std::vector<unsigned int> ctxParams = {order, 6, 2, 4, 1, 10, 100, 1000};
+                const CodingConfig config(binId, ctxModelId, binParams, ctxParams);
+
+                cabacSimpleSequenceEncoder encoder;
+                encoder.initCtx(config.numContexts + config.ctxOffset, 0.5, 8);
+                encoder.start();
+                encoder.encodeSymbols(symbols.data(), symbols.size(), config);
+                encoder.encodeBinTrm(1);
+                encoder.finish();
+                encoder.writeByteAlignment();
+
+                cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+                decoder.initCtx(config.numContexts + config.ctxOffset, 0.5, 8);
+                decoder.start();
+                std::vector<uint64_t> symbolsDecoded = decoder.decodeSymbols(symbols.size(), binId, ctxModelId, binParams, ctxParams);
+                decoder.decodeBinTrm();
+                decoder.finish();
+
+                REQUIRE(symbolsDecoded == symbols);
+            }
+        }
+    }
+
+    // Bypass kernels
+    const std::vector<std::tuple<binarization::BinarizationId, std::vector<unsigned int>>> bypassBinarizations = {
+        std::make_tuple(binarization::BinarizationId::BI, std::vector<unsigned int>{8}),
+        std::make_tuple(binarization::BinarizationId::TU, std::vector<unsigned int>{255}),
+        std::make_tuple(binarization::BinarizationId::EGk, std::vector<unsigned int>{255, 1}),
+        std::make_tuple(binarization::BinarizationId::RICE, std::vector<unsigned int>{0, 0, 1, 5, 15}),
+        std::make_tuple(binarization::BinarizationId::TB, std::vector<unsigned int>{299}),
+        std::make_tuple(binarization::BinarizationId::UEGk, std::vector<unsigned int>{4, 1}),
+    };
+    for (const auto& binarization : bypassBinarizations) {
+        const CodingConfig config(std::get<0>(binarization), std::get<1>(binarization));
+
+        cabacSimpleSequenceEncoder encoder;
+        encoder.start();
+        encoder.encodeSymbolsBypass(symbols.data(), symbols.size(), config);
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+
+        cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+        decoder.start();
+        std::vector<uint64_t> symbolsDecoded(symbols.size());
+        decoder.decodeSymbolsBypass(symbolsDecoded.data(), symbolsDecoded.size(), config);
+        decoder.decodeBinTrm();
+        decoder.finish();
+
+        REQUIRE(symbolsDecoded == symbols);
+    }
+}
+
+
+TEST_CASE("test_contextProviders")
+{
+    std::cout << "--- test_contextProviders" << std::endl;
+
+    const int numSymbols = 1000;
+    std::vector<uint64_t> symbols(numSymbols);
+    fillVectorRandomGeometric(&symbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 63);
+    }
+    std::vector<unsigned int> ctxIds(64);
+    for (unsigned int n = 0; n < ctxIds.size(); n++) {
+        ctxIds[n] = std::min(n, 7u);
+    }
+    const unsigned int * ctxIdsPtr = ctxIds.data();
+    auto ctxLambda = [](unsigned int n) { return std::min(n, 7u); };
+    CtxFunction ctxFun = ctxLambda;
+
+    // Array, lambda and std::function context providers must produce identical bitstreams
+    std::vector<std::vector<uint8_t>> bitstreams;
+    for (int provider = 0; provider < 3; provider++) {
+        cabacSymbolEncoder encoder;
+        encoder.initCtx(8, 0.5, 8);
+        encoder.start();
+        for (auto symbol : symbols) {
+            switch (provider) {
+                case 0: {
+                    encoder.encodeBinsTU(symbol, ctxIdsPtr, 63);
+                    encoder.encodeBinsBI(symbol, ctxIdsPtr, 6);
+                    encoder.encodeBinsEGk(symbol, 1, ctxIdsPtr);
+                } break;
+                case 1: {
+                    encoder.encodeBinsTU(symbol, ctxLambda, 63);
+                    encoder.encodeBinsBI(symbol, ctxLambda, 6);
+                    encoder.encodeBinsEGk(symbol, 1, ctxLambda);
+                } break;
+                default: {
+                    encoder.encodeBinsTU(symbol, ctxFun, 63);
+                    encoder.encodeBinsBI(symbol, ctxFun, 6);
+                    encoder.encodeBinsEGk(symbol, 1, ctxFun);
+                }
+            }
+        }
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        bitstreams.push_back(encoder.getBitstream());
+    }
+    REQUIRE(bitstreams[0] == bitstreams[1]);
+    REQUIRE(bitstreams[0] == bitstreams[2]);
+
+    cabacSymbolDecoder decoder(bitstreams[0]);
+    decoder.initCtx(8, 0.5, 8);
+    decoder.start();
+    for (auto symbol : symbols) {
+        REQUIRE(decoder.decodeBinsTU(ctxLambda, 63) == symbol);
+        REQUIRE(decoder.decodeBinsBI(ctxIdsPtr, 6) == symbol);
+        REQUIRE(decoder.decodeBinsEGk(1, ctxFun) == symbol);
+    }
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+}
+
+
+TEST_CASE("test_EGk64")
+{
+    std::cout << "--- test_EGk64" << std::endl;
+
+    // Prefix length against the definition floor(log2(symbol + 2^k)) - k
+    unsigned int numMismatches = 0;
+    for (unsigned int k = 0; k < 4; k++) {
+        for (uint64_t symbol = 0; symbol < 5000; symbol++) {
+            numMismatches += binarization::getNumLeadZerosEGk(symbol, k) != (unsigned int)(floor(log2(symbol + (1 << k))) - k);
+        }
+    }
+    REQUIRE(numMismatches == 0);
+    REQUIRE(binarization::getNumLeadZerosEGk(UINT64_MAX, 0) == 64);
+    REQUIRE(binarization::getNumLeadZerosEGk(UINT64_MAX - 1, 0) == 63);
+    REQUIRE(binarization::getNumLeadZerosEGk(UINT64_MAX, 1) == 63);
+    REQUIRE(binarization::getNumLeadZerosEGk(uint64_t(1) << 53, 0) == 53);
+    REQUIRE(binarization::getNumLeadZerosEGk((uint64_t(1) << 53) - 2, 0) == 52);  // floor(log2(double)) rounds up
+
+    // Round trip at the boundaries of the 32-bit, double and 64-bit ranges
+    const std::vector<uint64_t> symbols = {
+        0, 1, 2, 3, 254, 255, 256,
+        (uint64_t(1) << 31) - 1, uint64_t(1) << 31, (uint64_t(1) << 32) - 1, uint64_t(1) << 32, (uint64_t(1) << 32) + 1,
+        (uint64_t(1) << 53) - 1, uint64_t(1) << 53, (uint64_t(1) << 53) + 1,
+        (uint64_t(1) << 63) - 1, uint64_t(1) << 63, UINT64_MAX - 1, UINT64_MAX,
+    };
+    const std::vector<unsigned int> ks = {0, 1, 2, 5, 31};
+    std::vector<unsigned int> ctxIds(65);
+    for (unsigned int n = 0; n < ctxIds.size(); n++) {
+        ctxIds[n] = std::min(n, 15u);
+    }
+
+    cabacSymbolEncoder encoder;
+    encoder.initCtx(16, 0.5, 8);
+    encoder.start();
+    for (auto k : ks) {
+        for (auto symbol : symbols) {
+            encoder.encodeBinsEGkbypass(symbol, k);
+            encoder.encodeBinsEGk(symbol, k, ctxIds.data());
+        }
+    }
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    cabacSymbolDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(16, 0.5, 8);
+    decoder.start();
+    for (auto k : ks) {
+        for (auto symbol : symbols) {
+            REQUIRE(decoder.decodeBinsEGkbypass(k) == symbol);
+            REQUIRE(decoder.decodeBinsEGk(k, ctxIds.data()) == symbol);
+        }
+    }
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+}
+
+
+TEST_CASE("test_BI64")
+{
+    std::cout << "--- test_BI64" << std::endl;
+
+    const std::vector<unsigned int> widths = {1, 8, 16, 31, 32, 33, 48, 63, 64};
+    std::vector<unsigned int> ctxIds(64);
+    for (unsigned int n = 0; n < ctxIds.size(); n++) {
+        ctxIds[n] = n;
+    }
+
+    // Reference: bin-wise bypass coding
+    cabacSymbolEncoder encoderRef;
+    encoderRef.start();
+    cabacSymbolEncoder encoder;
+    encoder.initCtx(64, 0.5, 8);
+    encoder.start();
+    std::vector<std::vector<uint64_t>> symbols;
+    for (auto numBins : widths) {
+        const uint64_t maxVal = numBins < 64 ? (uint64_t(1) << numBins) - 1 : UINT64_MAX;
+        std::vector<uint64_t> values(100);
+        fillVectorRandomUniform(0, maxVal, &values);
+        values.push_back(0);
+        values.push_back(maxVal);
+        values.push_back(uint64_t(1) << (numBins - 1));
+        for (auto symbol : values) {
+            for (int i = numBins - 1; i >= 0; i--) {
+                encoderRef.encodeBinEP((symbol >> i) & 1);
+            }
+            encoder.encodeBinsBIbypass(symbol, numBins);
+        }
+        symbols.push_back(values);
+    }
+    encoderRef.encodeBinTrm(1);
+    encoderRef.finish();
+    encoderRef.writeByteAlignment();
+    for (unsigned int w = 0; w < widths.size(); w++) {
+        for (auto symbol : symbols[w]) {
+            encoder.encodeBinsBI(symbol, ctxIds.data(), widths[w]);
+        }
+    }
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    // The bypass part equals the bin-wise reference
+    const std::vector<uint8_t> bsRef = encoderRef.getBitstream();
+    std::vector<uint8_t> bs = encoder.getBitstream();
+    cabacSymbolDecoder decoderRef(bsRef);
+    decoderRef.start();
+    cabacSymbolDecoder decoder(bs);
+    decoder.initCtx(64, 0.5, 8);
+    decoder.start();
+    unsigned int numMismatches = 0;
+    for (unsigned int w = 0; w < widths.size(); w++) {
+        for (auto symbol : symbols[w]) {
+            numMismatches += decoder.decodeBinsBIbypass(widths[w]) != symbol;
+            numMismatches += decoderRef.decodeBinsEP64(widths[w]) != symbol;
+        }
+    }
+    for (unsigned int w = 0; w < widths.size(); w++) {
+        for (auto symbol : symbols[w]) {
+            numMismatches += decoder.decodeBinsBI(ctxIds.data(), widths[w]) != symbol;
+        }
+    }
+    REQUIRE(numMismatches == 0);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+    REQUIRE(decoderRef.decodeBinTrm() == 1);
+    decoderRef.finish();
+
+    // Sequence coders
+    std::vector<uint64_t> values(1000);
+    fillVectorRandomUniform(0, UINT64_MAX, &values);
+    const CodingConfig config(binarization::BinarizationId::BI, contextSelector::ContextModelId::BINPOSITION, {64}, {1, 64, 0});
+    cabacSimpleSequenceEncoder seqEncoder;
+    seqEncoder.initCtx(config.numContexts, 0.5, 8);
+    seqEncoder.start();
+    seqEncoder.encodeSymbols(values.data(), values.size(), config);
+    seqEncoder.encodeSymbolsBypass(values.data(), values.size(), CodingConfig(binarization::BinarizationId::BI, {64}));
+    seqEncoder.encodeBinTrm(1);
+    seqEncoder.finish();
+    seqEncoder.writeByteAlignment();
+
+    cabacSimpleSequenceDecoder seqDecoder(seqEncoder.getBitstream());
+    seqDecoder.initCtx(config.numContexts, 0.5, 8);
+    seqDecoder.start();
+    std::vector<uint64_t> decoded(values.size());
+    seqDecoder.decodeSymbols(decoded.data(), decoded.size(), config);
+    REQUIRE(decoded == values);
+    seqDecoder.decodeSymbolsBypass(decoded.data(), decoded.size(), CodingConfig(binarization::BinarizationId::BI, {64}));
+    REQUIRE(decoded == values);
+    REQUIRE(seqDecoder.decodeBinTrm() == 1);
+    seqDecoder.finish();
+
+    REQUIRE_THROWS(CodingConfig(binarization::BinarizationId::BI, {65}));
+}
+
+
+TEST_CASE("test_RICEcontextCoded")
+{
+    std::cout << "--- test_RICEcontextCoded" << std::endl;
+
+    // Symbol level, with escapes up to the range limit of maxLog2TrDynamicRange
+    const unsigned int cutoff = 5;
+    const unsigned int maxLog2TrDynamicRange = 15;
+    std::vector<uint64_t> values;
+    for (uint64_t symbol = 0; symbol < 300; symbol++) {
+        values.push_back(symbol);
+    }
+    for (unsigned int e = 9; e <= maxLog2TrDynamicRange; e++) {
+        values.push_back((uint64_t(1) << e) - 1);
+        values.push_back(uint64_t(1) << e);
+    }
+    std::vector<unsigned int> ctxIds(cutoff);
+    for (unsigned int n = 0; n < ctxIds.size(); n++) {
+        ctxIds[n] = n;
+    }
+
+    cabacSymbolEncoder encoder;
+    encoder.initCtx(cutoff, 0.5, 8);
+    encoder.start();
+    for (unsigned int riceParam = 0; riceParam < 4; riceParam++) {
+        for (auto symbol : values) {
+            encoder.encodeBinsRICE(symbol, ctxIds.data(), riceParam, cutoff, maxLog2TrDynamicRange);
+        }
+    }
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    cabacSymbolDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(cutoff, 0.5, 8);
+    decoder.start();
+    unsigned int numMismatches = 0;
+    for (unsigned int riceParam = 0; riceParam < 4; riceParam++) {
+        for (auto symbol : values) {
+            numMismatches += decoder.decodeBinsRICE(ctxIds.data(), riceParam, cutoff, maxLog2TrDynamicRange) != symbol;
+        }
+    }
+    REQUIRE(numMismatches == 0);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+
+    // Sequence level with adaptive Rice parameter, on heavy-tailed symbols
+    std::vector<uint64_t> symbols(100000);
+    fillVectorRandomGeometric(&symbols);
+    std::mt19937 gen(0);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol << (gen() % 6), (1 << maxLog2TrDynamicRange) - 1);
+    }
+    const std::vector<unsigned int> binParams = {0, 0, 0, cutoff, maxLog2TrDynamicRange};
+
+    cabacSimpleSequenceEncoder encoderBypass;
+    encoderBypass.start();
+    encoderBypass.encodeSymbolsBypass(symbols.data(), symbols.size(), CodingConfig(binarization::BinarizationId::RICE, binParams));
+    encoderBypass.encodeBinTrm(1);
+    encoderBypass.finish();
+    encoderBypass.writeByteAlignment();
+    const size_t sizeBypass = encoderBypass.getBitstream().size();
+
+    const std::vector<std::pair<contextSelector::ContextModelId, std::vector<unsigned int>>> ctxModels = {
+        {contextSelector::ContextModelId::BAC, {1, cutoff, 0}},
+        {contextSelector::ContextModelId::BINPOSITION, {1, cutoff, 0}},
+        {contextSelector::ContextModelId::SYMBOLORDERN, {2, cutoff, 0, 3}},
+        {contextSelector::ContextModelId::BINSYMBOLPOSITION, {1, cutoff, 0, 0, 2}},
+    };
+    for (const auto& ctxModel : ctxModels) {
+        const CodingConfig config(binarization::BinarizationId::RICE, ctxModel.first, binParams, ctxModel.second);
+
+        cabacSimpleSequenceEncoder seqEncoder;
+        seqEncoder.initCtx(config.numContexts, 0.5, 8);
+        seqEncoder.start();
+        seqEncoder.encodeSymbols(symbols.data(), symbols.size(), config);
+        seqEncoder.encodeBinTrm(1);
+        seqEncoder.finish();
+        seqEncoder.writeByteAlignment();
+        const size_t size = seqEncoder.getBitstream().size();
+        std::cout << "Context model " << static_cast<int>(ctxModel.first) << ": " << size << " bytes, bypass with fixed Rice parameter: "
+            << sizeBypass << " bytes" << std::endl;
+        REQUIRE(size < sizeBypass);
+
+        cabacSimpleSequenceDecoder seqDecoder(seqEncoder.getBitstream());
+        seqDecoder.initCtx(config.numContexts, 0.5, 8);
+        seqDecoder.start();
+        std::vector<uint64_t> decoded(symbols.size());
+        seqDecoder.decodeSymbols(decoded.data(), decoded.size(), config);
+        REQUIRE(decoded == symbols);
+        REQUIRE(seqDecoder.decodeBinTrm() == 1);
+        seqDecoder.finish();
+    }
+
+    REQUIRE_THROWS(CodingConfig(binarization::BinarizationId::RICE, contextSelector::ContextModelId::BINSORDERN, binParams, {1, cutoff, 0}));
+    REQUIRE_THROWS(CodingConfig(binarization::BinarizationId::RICE, {0, 0, 0, 20, 15}));
+
+    // The largest codable symbol round-trips, larger ones (also beyond 32 bits) are rejected instead of truncated
+    for (const auto& params : std::vector<std::vector<unsigned int>>{{0, 0, 0, 8, 15}, {0, 0, 3, 4, 10},
+        {0, 0, 2, 0, 16}, {0, 0, 0, 17, 15}}) {
+        const CodingConfig configBypass(binarization::BinarizationId::RICE, params);
+        const CodingConfig configCtx(binarization::BinarizationId::RICE, contextSelector::ContextModelId::BAC, params,
+            {1, params[3], 0});
+        REQUIRE(configBypass.maxSymbolRICE == getMaxRemAbsEP(params[2], params[3], params[4]));
+        REQUIRE(configCtx.maxSymbolRICE == getMaxRemAbsEP(0, params[3], params[4]));
+        REQUIRE(configCtx.maxSymbolRICE <= configBypass.maxSymbolRICE);
+
+        const std::vector<uint64_t> symbolsMax = {0, configCtx.maxSymbolRICE, 7, configCtx.maxSymbolRICE, 1};
+        for (const CodingConfig* c : {&configBypass, &configCtx}) {
+            cabacSimpleSequenceEncoder encoderMax;
+            encoderMax.initCtx(std::max(1u, c->numContexts), 0.5, 8);
+            encoderMax.start();
+            encoderMax.encodeSubstream(symbolsMax, *c);
+            encoderMax.encodeBinTrm(1);
+            encoderMax.finish();
+            encoderMax.writeByteAlignment();
+            cabacSimpleSequenceDecoder decoderMax(encoderMax.getBitstream());
+            decoderMax.initCtx(std::max(1u, c->numContexts), 0.5, 8);
+            decoderMax.start();
+            std::vector<uint64_t> decodedMax;
+            decoderMax.decodeSubstream(decodedMax, symbolsMax.size(), *c);
+            REQUIRE(decoderMax.decodeBinTrm() == 1);
+            REQUIRE(decodedMax == symbolsMax);
+
+            for (const uint64_t symbolOutside : {c->maxSymbolRICE + 1, uint64_t(1) << 33}) {
+                const std::vector<uint64_t> symbolsOutside = {0, symbolOutside, 7};
+                cabacSimpleSequenceEncoder encoderOutside;
+                encoderOutside.initCtx(std::max(1u, c->numContexts), 0.5, 8);
+                encoderOutside.start();
+                REQUIRE_THROWS(encoderOutside.encodeSubstream(symbolsOutside, *c));
+            }
+        }
+        REQUIRE_THROWS(encoder.encodeBinsRICE(configBypass.maxSymbolRICE + 1, ctxIds.data(), params[2], params[3],
+            params[4]));
+    }
+
+    // Single symbols cannot follow the Rice parameter adaptation of a sequence
+    const CodingConfig config(binarization::BinarizationId::RICE, contextSelector::ContextModelId::BAC, binParams,
+        {1, cutoff, 0});
+    const uint64_t symbolsPrev[3] = {0, 0, 0};
+    cabacSimpleSequenceEncoder symbolEncoder;
+    symbolEncoder.initCtx(config.numContexts, 0.5, 8);
+    symbolEncoder.start();
+    REQUIRE_THROWS(symbolEncoder.encodeSymbol(symbols[0], 0, symbolsPrev, config));
+    symbolEncoder.encodeSymbols(symbols.data(), symbols.size(), config);
+    symbolEncoder.encodeBinTrm(1);
+    symbolEncoder.finish();
+    symbolEncoder.writeByteAlignment();
+    cabacSimpleSequenceDecoder symbolDecoder(symbolEncoder.getBitstream());
+    symbolDecoder.initCtx(config.numContexts, 0.5, 8);
+    symbolDecoder.start();
+    REQUIRE_THROWS(symbolDecoder.decodeSymbol(0, symbolsPrev, config));
+}
+
+
+TEST_CASE("test_TBandUEGk")
+{
+    std::cout << "--- test_TBandUEGk" << std::endl;
+
+    // TB codeword lengths: k or k+1 bins, complete prefix code (Kraft sum of 1)
+    for (unsigned int cMax = 0; cMax < 300; cMax++) {
+        const binarization::TruncatedBinary tb(cMax);
+        uint64_t kraftSum = 0;  // in units of 2^-(k+1)
+        for (uint64_t symbol = 0; symbol <= cMax; symbol++) {
+            const unsigned int numBins = tb.getNumBins(symbol);
+            REQUIRE((numBins == tb.k || numBins == tb.k + 1));
+            REQUIRE(numBins <= tb.getNumMaxBins());
+            kraftSum += uint64_t(1) << (tb.k + 1 - numBins);
+        }
+        REQUIRE(kraftSum == (uint64_t(2) << tb.k));
+    }
+
+    // Symbol level round trip, bypass and context-coded
+    const std::vector<unsigned int> cMaxs = {0, 1, 2, 4, 5, 7, 8, 199, 255, 1000};
+    const std::vector<std::pair<unsigned int, unsigned int>> uegkParams = {{0, 0}, {1, 0}, {4, 1}, {14, 0}, {3, 5}};
+    std::vector<uint64_t> escapes = {0, 1, 2, 3, 13, 14, 15, 16, 100, 1000};
+    for (unsigned int e = 20; e < 64; e += 7) {
+        escapes.push_back(uint64_t(1) << e);
+    }
+    std::vector<unsigned int> ctxIds(32);
+    for (unsigned int n = 0; n < ctxIds.size(); n++) {
+        ctxIds[n] = n;
+    }
+
+    cabacSymbolEncoder encoder;
+    encoder.initCtx(ctxIds.size(), 0.5, 8);
+    encoder.start();
+    for (auto cMax : cMaxs) {
+        for (uint64_t symbol = 0; symbol <= cMax; symbol++) {
+            encoder.encodeBinsTBbypass(symbol, cMax);
+            encoder.encodeBinsTB(symbol, ctxIds.data(), cMax);
+        }
+    }
+    for (const auto& params : uegkParams) {
+        for (auto symbol : escapes) {
+            encoder.encodeBinsUEGkbypass(symbol, params.first, params.second);
+            encoder.encodeBinsUEGk(symbol, ctxIds.data(), params.first, params.second);
+        }
+    }
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    cabacSymbolDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(ctxIds.size(), 0.5, 8);
+    decoder.start();
+    unsigned int numMismatches = 0;
+    for (auto cMax : cMaxs) {
+        for (uint64_t symbol = 0; symbol <= cMax; symbol++) {
+            numMismatches += decoder.decodeBinsTBbypass(cMax) != symbol;
+            numMismatches += decoder.decodeBinsTB(ctxIds.data(), cMax) != symbol;
+        }
+    }
+    for (const auto& params : uegkParams) {
+        for (auto symbol : escapes) {
+            numMismatches += decoder.decodeBinsUEGkbypass(params.first, params.second) != symbol;
+            numMismatches += decoder.decodeBinsUEGk(ctxIds.data(), params.first, params.second) != symbol;
+        }
+    }
+    REQUIRE(numMismatches == 0);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+
+    // Sequence level: uniform symbols of a non-power-of-two alphabet with TB vs. BI, heavy-tailed symbols with
+    // UEGk vs. EGk
+    const unsigned int numSymbols = 50000;
+    std::mt19937 gen(0);
+    std::vector<uint64_t> symbolsUniform(numSymbols);
+    for (auto& symbol : symbolsUniform) {
+        symbol = gen() % 200;
+    }
+    std::vector<uint64_t> symbolsHeavy(numSymbols);  // binomial(8, 0.5), with 1/32 uniform escapes in [0, 1023]
+    for (auto& symbol : symbolsHeavy) {
+        const uint32_t bits = gen();
+        symbol = gen() % 32 ? std::bitset<8>(bits).count() : bits % (1 << 10);
+    }
+
+    auto encodedSize = [](const std::vector<uint64_t>& symbols, const CodingConfig& config) {
+        cabacSimpleSequenceEncoder seqEncoder;
+        seqEncoder.initCtx(config.numContexts, 0.5, 8);
+        seqEncoder.start();
+        if (config.bypass) {
+            seqEncoder.encodeSymbolsBypass(symbols.data(), symbols.size(), config);
+        } else {
+            seqEncoder.encodeSymbols(symbols.data(), symbols.size(), config);
+        }
+        seqEncoder.encodeBinTrm(1);
+        seqEncoder.finish();
+        seqEncoder.writeByteAlignment();
+
+        cabacSimpleSequenceDecoder seqDecoder(seqEncoder.getBitstream());
+        seqDecoder.initCtx(config.numContexts, 0.5, 8);
+        seqDecoder.start();
+        std::vector<uint64_t> decoded(symbols.size());
+        if (config.bypass) {
+            seqDecoder.decodeSymbolsBypass(decoded.data(), decoded.size(), config);
+        } else {
+            seqDecoder.decodeSymbols(decoded.data(), decoded.size(), config);
+        }
+        REQUIRE(decoded == symbols);
+        REQUIRE(seqDecoder.decodeBinTrm() == 1);
+        seqDecoder.finish();
+        return seqEncoder.getBitstream().size();
+    };
+
+    const auto TB = binarization::BinarizationId::TB;
+    const auto UEGk = binarization::BinarizationId::UEGk;
+    const size_t sizeBI = encodedSize(symbolsUniform, CodingConfig(binarization::BinarizationId::BI, {8}));
+    const size_t sizeTB = encodedSize(symbolsUniform, CodingConfig(TB, {199}));
+    std::cout << "Uniform symbols in [0, 199]: TB " << sizeTB << " bytes, BI " << sizeBI << " bytes" << std::endl;
+    REQUIRE(sizeTB < sizeBI);
+    for (auto ctxModelId : {contextSelector::ContextModelId::BINSORDERN, contextSelector::ContextModelId::SYMBOLORDERN,
+        contextSelector::ContextModelId::BINPOSITION}) {
+        const size_t sizeTBctx = encodedSize(symbolsUniform, CodingConfig(TB, ctxModelId, {199}, {2, 8, 0, 3}));
+        REQUIRE(sizeTBctx < sizeBI);
+    }
+
+    const size_t sizeEGk = encodedSize(symbolsHeavy, CodingConfig(binarization::BinarizationId::EGk,
+        contextSelector::ContextModelId::BINPOSITION, {1 << 10, 0}, {1, 8, 0}));
+    const size_t sizeTU = encodedSize(symbolsHeavy, CodingConfig(binarization::BinarizationId::TU,
+        contextSelector::ContextModelId::BINPOSITION, {1 << 10}, {1, 12, 0}));
+    const size_t sizeUEGk = encodedSize(symbolsHeavy, CodingConfig(UEGk,
+        contextSelector::ContextModelId::BINPOSITION, {12, 3}, {1, 12, 0}));
+    std::cout << "Heavy-tailed symbols: UEGk " << sizeUEGk << " bytes, EGk " << sizeEGk << " bytes, TU " << sizeTU << " bytes" << std::endl;
+    REQUIRE(sizeUEGk < sizeEGk);
+    REQUIRE(sizeUEGk < sizeTU);
+    encodedSize(symbolsHeavy, CodingConfig(UEGk, {14, 0}));
+    encodedSize(symbolsHeavy, CodingConfig(UEGk, contextSelector::ContextModelId::BINSORDERN, {14, 0}, {2, 14, 0}));
+    encodedSize(symbolsHeavy, CodingConfig(UEGk, contextSelector::ContextModelId::SYMBOLORDERNSYMBOLPOSITION,
+        {14, 0}, {1, 14, 0, 4, 2}));
+
+    REQUIRE(contextSelector::getNumContexts(TB, contextSelector::ContextModelId::BINSORDERN, {199}, {2, 8, 0}) == 4 * 8 + 1);
+    REQUIRE_THROWS(CodingConfig(UEGk, {14}));
+    REQUIRE_THROWS(CodingConfig(UEGk, {14, 32}));
+}
+
+
+TEST_CASE("test_TUbypassRuns")
+{
+    std::cout << "--- test_TUbypassRuns" << std::endl;
+
+    std::vector<std::pair<uint64_t, unsigned int>> symbols;  // symbol, numMaxBins
+    for (uint64_t symbol = 0; symbol <= 70; symbol++) {
+        symbols.push_back(std::make_pair(symbol, 512u));
+        symbols.push_back(std::make_pair(symbol, (unsigned int)symbol));  // symbol == numMaxBins: no terminating '0'
+        symbols.push_back(std::make_pair(symbol, (unsigned int)symbol + 1));
+    }
+    symbols.push_back(std::make_pair(uint64_t(1000), 2000u));
+    symbols.push_back(std::make_pair(uint64_t(37), 512u));  // runs close to the end of the bitstream
+    symbols.push_back(std::make_pair(uint64_t(5), 512u));
+
+    // Reference: bin-wise coding
+    cabacSymbolEncoder encoderRef;
+    encoderRef.start();
+    for (const auto& s : symbols) {
+        for (uint64_t i = 0; i < s.first; i++) {
+            encoderRef.encodeBinEP(1);
+        }
+        if (s.second > s.first) {
+            encoderRef.encodeBinEP(0);
+        }
+    }
+    encoderRef.encodeBinTrm(1);
+    encoderRef.finish();
+    encoderRef.writeByteAlignment();
+
+    cabacSymbolEncoder encoder;
+    encoder.start();
+    for (const auto& s : symbols) {
+        encoder.encodeBinsTUbypass(s.first, s.second);
+    }
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+    REQUIRE(encoder.getBitstream() == encoderRef.getBitstream());
+
+    cabacSymbolDecoder decoder(encoder.getBitstream());
+    decoder.start();
+    unsigned int numMismatches = 0;
+    for (const auto& s : symbols) {
+        numMismatches += decoder.decodeBinsTUbypass(s.second) != s.first;
+    }
+    REQUIRE(numMismatches == 0);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+}
+
+
+TEST_CASE("test_MPSrun")
+{
+    std::cout << "--- test_MPSrun" << std::endl;
+
+    // Bin level: runs of MPS bins, each followed by an LPS, with converging and adapting contexts
+    std::mt19937 gen(7);
+    std::geometric_distribution<uint64_t> runDist(0.01);
+    std::vector<uint64_t> runs(2000);
+    for (auto& run : runs) {
+        run = runDist(gen);
+    }
+    const std::vector<std::tuple<double, uint8_t>> ctxInit {{0.5, 0}, {0.02, 8}, {0.97, 13}};
+    for (unsigned int ctxId = 0; ctxId < ctxInit.size(); ctxId++) {
+        cabacEncoder encoderRef;
+        encoderRef.initCtx(ctxInit);
+        encoderRef.start();
+        cabacEncoder encoder;
+        encoder.initCtx(ctxInit);
+        encoder.start();
+        for (auto run : runs) {
+            const unsigned int mps = encoderRef.getMps(ctxId);
+            for (uint64_t i = 0; i < run; i++) {
+                encoderRef.encodeBin(mps, ctxId);
+            }
+            encoderRef.encodeBin(1 - encoderRef.getMps(ctxId), ctxId);
+            encoder.encodeMPSRun(ctxId, run);
+            encoder.encodeBin(1 - encoder.getMps(ctxId), ctxId);
+        }
+        for (cabacEncoder* e : {&encoderRef, &encoder}) {
+            e->encodeBinTrm(1);
+            e->finish();
+            e->writeByteAlignment();
+        }
+        REQUIRE(encoder.getBitstream() == encoderRef.getBitstream());
+
+        cabacDecoder decoder(encoder.getBitstream());
+        decoder.initCtx(ctxInit);
+        decoder.start();
+        unsigned int numMismatches = 0;
+        for (auto run : runs) {
+            const unsigned int mps = decoder.getMps(ctxId);
+            numMismatches += decoder.decodeMPSRun(ctxId, UINT64_MAX) != run;
+            numMismatches += decoder.decodeBin(ctxId) == mps;
+        }
+        REQUIRE(numMismatches == 0);
+        REQUIRE(decoder.decodeBinTrm() == 1);
+        decoder.finish();
+    }
+
+    // TU: run mode from the rest position on (ContextIdProvider) against the same context IDs as array (bin by bin)
+    const unsigned int numMaxBins = 300;
+    std::vector<uint64_t> symbols(20000);
+    std::binomial_distribution<uint64_t> symbolDist(numMaxBins, 0.7);
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        symbols[i] = i % 10 == 0 ? i % numMaxBins : symbolDist(gen);
+    }
+    symbols.push_back(numMaxBins);
+    const CodingConfig config(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINSORDERN,
+        {numMaxBins}, {1, 4, 0});
+    contextSelector::ContextIdProvider ctxIds(config);
+    std::vector<std::vector<unsigned int>> ctxIdArrays(symbols.size(), std::vector<unsigned int>(numMaxBins + 1));
+    uint64_t symbolPrev = 0;
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        ctxIds.setSymbol(i, &symbolPrev);
+        for (unsigned int n = 0; n <= numMaxBins; n++) {
+            ctxIdArrays[i][n] = ctxIds(n);
+        }
+        symbolPrev = symbols[i];
+    }
+
+    std::vector<std::vector<uint8_t>> bitstreams;
+    for (int runMode = 0; runMode < 2; runMode++) {
+        cabacSymbolEncoder encoder;
+        encoder.initCtx(config.numContexts, 0.5, 8);
+        encoder.start();
+        symbolPrev = 0;
+        for (unsigned int i = 0; i < symbols.size(); i++) {
+            if (runMode) {
+                ctxIds.setSymbol(i, &symbolPrev);
+                encoder.encodeBinsTU(symbols[i], ctxIds, numMaxBins);
+            } else {
+                encoder.encodeBinsTU(symbols[i], ctxIdArrays[i].data(), numMaxBins);
+            }
+            symbolPrev = symbols[i];
+        }
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        bitstreams.push_back(encoder.getBitstream());
+    }
+    REQUIRE(bitstreams[0] == bitstreams[1]);
+
+    for (int runMode = 0; runMode < 2; runMode++) {
+        cabacSymbolDecoder decoder(bitstreams[0]);
+        decoder.initCtx(config.numContexts, 0.5, 8);
+        decoder.start();
+        unsigned int numMismatches = 0;
+        symbolPrev = 0;
+        for (unsigned int i = 0; i < symbols.size(); i++) {
+            if (runMode) {
+                ctxIds.setSymbol(i, &symbolPrev);
+                symbolPrev = decoder.decodeBinsTU(ctxIds, numMaxBins);
+            } else {
+                symbolPrev = decoder.decodeBinsTU(ctxIdArrays[i].data(), numMaxBins);
+            }
+            numMismatches += symbolPrev != symbols[i];
+        }
+        REQUIRE(numMismatches == 0);
+        REQUIRE(decoder.decodeBinTrm() == 1);
+        decoder.finish();
+    }
+}
+
+
+TEST_CASE("test_frozenContexts")
+{
+    std::cout << "--- test_frozenContexts" << std::endl;
+
+    const unsigned int numSymbols = 20000;
+    const unsigned int numSymbolsTraining = 2000;
+    std::vector<uint64_t> symbols(numSymbols);
+    fillVectorRandomGeometric(&symbols);
+    const CodingConfig config(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINSORDERN,
+        {63}, {1, 8, 0});
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 63);
+    }
+
+    auto getStates = [](const FrozenContexts& ctx) {
+        std::vector<uint16_t> states(ctx.size());
+        for (unsigned int i = 0; i < ctx.size(); i++) {
+            states[i] = ctx[i].getState();
+        }
+        return states;
+    };
+
+    // Training phase with adaptive contexts, frozen afterwards on both sides
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(config.numContexts, 0.5, 8);
+    encoder.start();
+    encoder.encodeSymbols(symbols.data(), numSymbolsTraining, config);
+    encoder.freezeCtx();
+    const FrozenContexts frozenCtx = encoder.getFrozenContexts();
+    encoder.encodeSymbols(symbols.data() + numSymbolsTraining, numSymbols - numSymbolsTraining, config);
+    REQUIRE(getStates(encoder.getFrozenContexts()) == getStates(frozenCtx));
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(config.numContexts, 0.5, 8);
+    decoder.start();
+    std::vector<uint64_t> symbolsDecoded(numSymbols);
+    decoder.decodeSymbols(symbolsDecoded.data(), numSymbolsTraining, config);
+    decoder.freezeCtx();
+    REQUIRE(decoder.isCtxFrozen(0));
+    REQUIRE(getStates(decoder.getFrozenContexts()) == getStates(frozenCtx));
+    decoder.decodeSymbols(symbolsDecoded.data() + numSymbolsTraining, numSymbols - numSymbolsTraining, config);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+    REQUIRE(symbolsDecoded == symbols);
+
+    // Frozen set shared by several coders, frozen at initCtx time
+    std::vector<uint8_t> bitstreamFrozen;
+    for (int i = 0; i < 2; i++) {
+        cabacSimpleSequenceEncoder encoderFrozen;
+        encoderFrozen.initCtx(frozenCtx);
+        encoderFrozen.start();
+        encoderFrozen.encodeSymbols(symbols.data(), numSymbols, config);
+        encoderFrozen.encodeBinTrm(1);
+        encoderFrozen.finish();
+        encoderFrozen.writeByteAlignment();
+        REQUIRE((i == 0 || encoderFrozen.getBitstream() == bitstreamFrozen));
+        bitstreamFrozen = encoderFrozen.getBitstream();
+    }
+    for (int i = 0; i < 2; i++) {
+        cabacSimpleSequenceDecoder decoderFrozen(bitstreamFrozen);
+        decoderFrozen.initCtx(frozenCtx);
+        decoderFrozen.start();
+        std::fill(symbolsDecoded.begin(), symbolsDecoded.end(), 0);
+        decoderFrozen.decodeSymbols(symbolsDecoded.data(), numSymbols, config);
+        REQUIRE(decoderFrozen.decodeBinTrm() == 1);
+        decoderFrozen.finish();
+        REQUIRE(symbolsDecoded == symbols);
+    }
+
+    // Partially frozen contexts and frozen sets from probabilities
+    const FrozenContexts frozenInit({{0.1, 4}, {0.9, 4}});
+    REQUIRE(frozenInit.size() == 2);
+    cabacEncoder binEncoder;
+    binEncoder.initCtx({{0.1, 4}, {0.9, 4}});
+    binEncoder.freezeCtx({1});
+    REQUIRE(!binEncoder.isCtxFrozen(0));
+    REQUIRE(binEncoder.isCtxFrozen(1));
+    binEncoder.start();
+    for (unsigned int i = 0; i < 100; i++) {
+        binEncoder.encodeBin(i % 3 == 0, 0);
+        binEncoder.encodeBin(i % 3 == 0, 1);
+    }
+    REQUIRE(binEncoder.getFrozenContexts()[1].getState() == frozenInit[1].getState());
+    REQUIRE(binEncoder.getFrozenContexts()[0].getState() != frozenInit[0].getState());
+}
+
+
+TEST_CASE("test_exportImportContexts")
+{
+    std::cout << "--- test_exportImportContexts" << std::endl;
+
+    std::vector<uint64_t> symbols(4000);
+    fillVectorRandomGeometric(&symbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 31);
+    }
+    const unsigned int numSymbolsTraining = 3000;
+    const CodingConfig config(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINPOSITION,
+        {31}, {1, 31, 0});
+
+    cabacSimpleSequenceEncoder encoderTraining;
+    encoderTraining.initCtx(config.numContexts, 0.5, 8);
+    encoderTraining.start();
+    encoderTraining.encodeSymbols(symbols.data(), numSymbolsTraining, config);
+    encoderTraining.freezeCtx({0});
+    const std::vector<uint16_t> words = encoderTraining.exportContexts();
+    REQUIRE(words.size() == BinProbModel_Std::numStateWords * config.numContexts);
+
+    // Warm start from the trained states against a cold start, for the remaining (short) stream
+    std::vector<std::vector<uint8_t>> bitstreams;
+    for (int warm = 0; warm < 2; warm++) {
+        cabacSimpleSequenceEncoder encoder;
+        if (warm) {
+            encoder.importContexts(words);
+            REQUIRE(encoder.exportContexts() == words);
+            REQUIRE(encoder.isCtxFrozen(0));
+        } else {
+            encoder.initCtx(config.numContexts, 0.5, 8);
+        }
+        encoder.start();
+        encoder.encodeSymbols(symbols.data() + numSymbolsTraining, symbols.size() - numSymbolsTraining, config);
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        bitstreams.push_back(encoder.getBitstream());
+    }
+    REQUIRE(bitstreams[1].size() < bitstreams[0].size());
+
+    cabacSimpleSequenceDecoder decoder(bitstreams[1]);
+    decoder.importContexts(words);
+    decoder.start();
+    std::vector<uint64_t> symbolsDecoded(symbols.size() - numSymbolsTraining);
+    decoder.decodeSymbols(symbolsDecoded.data(), symbolsDecoded.size(), config);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+    REQUIRE(std::equal(symbolsDecoded.begin(), symbolsDecoded.end(), symbols.begin() + numSymbolsTraining));
+
+    // Invalid blobs
+    cabacEncoder encoder;
+    REQUIRE_THROWS(encoder.importContexts(std::vector<uint16_t>(4)));
+    REQUIRE_THROWS(encoder.importContexts({1, 0, 0x48}));
+    REQUIRE_THROWS(encoder.importContexts({0, 0, 0x100}));
+    // Only window sizes of setLog2WindowSize (shiftIdx) and the frozen value are accepted
+    unsigned int numValidRates = 0;
+    for (uint16_t rate = 0; rate <= 0xff; rate++) {
+        bool valid = rate == 0xff;
+        for (uint8_t shiftIdx : contextTraining::getValidShiftIdxs()) {
+            BinProbModel_Std ctx;
+            ctx.setLog2WindowSize(shiftIdx);
+            uint16_t words[BinProbModel_Std::numStateWords];
+            ctx.getStateWords(words);
+            valid |= words[2] == rate;
+        }
+        numValidRates += valid;
+        if (valid) {
+            encoder.importContexts({0, 0, rate});
+        } else {
+            REQUIRE_THROWS(encoder.importContexts({0, 0, rate}));
+        }
+    }
+    REQUIRE(numValidRates == contextTraining::getValidShiftIdxs().size() + 1);
+    encoder.importContexts({});
+}
+
+
+TEST_CASE("test_contextTraining")
+{
+    std::cout << "--- test_contextTraining" << std::endl;
+
+    // Short, skewed samples, where the initialization matters
+    std::mt19937 gen(3);
+    std::geometric_distribution<uint64_t> dist(0.6);
+    std::vector<std::vector<uint64_t>> samples(20, std::vector<uint64_t>(200));
+    for (auto& sample : samples) {
+        for (auto& symbol : sample) {
+            symbol = std::min<uint64_t>(dist(gen), 15);
+        }
+    }
+    const CodingConfig config(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINSORDERN,
+        {15}, {1, 4, 0});
+
+    const std::vector<contextTraining::ContextBins> ctxBins = contextTraining::recordBins(samples, config);
+    REQUIRE(ctxBins.size() == config.numContexts);
+    size_t numBins = 0;
+    for (const auto& c : ctxBins) {
+        REQUIRE(c.sampleEnds.size() == samples.size());
+        numBins += c.bins.size();
+    }
+    uint64_t numBinsExpected = 0;
+    for (const auto& sample : samples) {
+        for (auto symbol : sample) {
+            numBinsExpected += symbol + (symbol < 15);
+        }
+    }
+    REQUIRE(numBins == numBinsExpected);
+
+    // With a context offset, entry i holds the bins of context ctxOffset + i
+    {
+        const CodingConfig configOffset(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINPOSITION,
+            {15}, {1, 3, 40});
+        const CodingConfig configNoOffset(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINPOSITION,
+            {15}, {1, 3, 0});
+        const auto ctxBinsOffset = contextTraining::recordBins(samples, configOffset);
+        const auto ctxBinsNoOffset = contextTraining::recordBins(samples, configNoOffset);
+        REQUIRE(ctxBinsOffset.size() == configOffset.numContexts);
+        for (unsigned int i = 0; i < ctxBinsOffset.size(); i++) {
+            REQUIRE(!ctxBinsOffset[i].bins.empty());
+            REQUIRE(ctxBinsOffset[i].bins == ctxBinsNoOffset[i].bins);
+            REQUIRE(ctxBinsOffset[i].sampleEnds == ctxBinsNoOffset[i].sampleEnds);
+        }
+    }
+
+    // maxNumBins limits the recorded bins per context and sample, also beyond the default bin storage size
+    {
+        const std::vector<std::vector<uint64_t>> longSamples(1, std::vector<uint64_t>(150000, 1));
+        const CodingConfig configBI(binarization::BinarizationId::BI, contextSelector::ContextModelId::BAC, {1},
+            {1, 1, 0});
+        REQUIRE(contextTraining::recordBins(longSamples, configBI, 200000)[0].bins.size() == 150000);
+        REQUIRE(contextTraining::recordBins(longSamples, configBI, 1000)[0].bins.size() == 1000);
+    }
+
+    const auto initCtx = contextTraining::trainContextInit(ctxBins, 4);
+    REQUIRE(initCtx == contextTraining::trainContextInit(ctxBins, 1));
+    REQUIRE(initCtx == contextTraining::trainContextInit(samples, config, 3));
+    const std::vector<uint8_t> shiftIdxs = contextTraining::getValidShiftIdxs();
+    for (unsigned int ctxId = 0; ctxId < ctxBins.size(); ctxId++) {
+        REQUIRE(std::find(shiftIdxs.begin(), shiftIdxs.end(), std::get<1>(initCtx[ctxId])) != shiftIdxs.end());
+        REQUIRE(contextTraining::estimateBits(ctxBins[ctxId], std::get<0>(initCtx[ctxId]), std::get<1>(initCtx[ctxId]))
+            <= contextTraining::estimateBits(ctxBins[ctxId], 0.5, 8));
+    }
+
+    // The trained initialization plugs into initCtx and beats the default on the samples
+    size_t sizeDefault = 0;
+    size_t sizeTrained = 0;
+    for (const auto& sample : samples) {
+        for (int trained = 0; trained < 2; trained++) {
+            cabacSimpleSequenceEncoder encoder;
+            if (trained) {
+                encoder.initCtx(initCtx);
+            } else {
+                encoder.initCtx(config.numContexts, 0.5, 8);
+            }
+            encoder.start();
+            encoder.encodeSymbols(sample.data(), sample.size(), config);
+            encoder.encodeBinTrm(1);
+            encoder.finish();
+            encoder.writeByteAlignment();
+            (trained ? sizeTrained : sizeDefault) += encoder.getBitstream().size();
+
+            if (trained) {
+                cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+                decoder.initCtx(initCtx);
+                decoder.start();
+                std::vector<uint64_t> symbolsDecoded(sample.size());
+                decoder.decodeSymbols(symbolsDecoded.data(), symbolsDecoded.size(), config);
+                REQUIRE(decoder.decodeBinTrm() == 1);
+                decoder.finish();
+                REQUIRE(symbolsDecoded == sample);
+            }
+        }
+    }
+    REQUIRE(sizeTrained < sizeDefault);
+}
+
+
+TEST_CASE("test_autotune")
+{
+    std::cout << "--- test_autotune" << std::endl;
+
+    std::mt19937 gen(5);
+    std::geometric_distribution<uint64_t> dist(0.3);
+    std::vector<uint64_t> symbols(20000);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(dist(gen), 40);
+    }
+
+    // The estimation mode writes no bitstream and matches the coded size
+    {
+        const CodingConfig config(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINSORDERN,
+            {40, 1}, {1, 4, 0});
+        cabacSimpleSequenceEncoder estimator;
+        estimator.initCtx(config.numContexts, 0.5, 8);
+        estimator.setBitEstimation(true);
+        estimator.start();
+        estimator.resetBits();
+        estimator.encodeSymbols(symbols.data(), symbols.size(), config);
+        estimator.encodeBinsEP(5, 3);
+        estimator.encodeBinTrm(1);
+        estimator.finish();
+        REQUIRE(estimator.getBitstream().empty());
+
+        cabacSimpleSequenceEncoder encoder;
+        encoder.initCtx(config.numContexts, 0.5, 8);
+        encoder.start();
+        encoder.encodeSymbols(symbols.data(), symbols.size(), config);
+        encoder.encodeBinsEP(5, 3);
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        const double bitsEstimated = static_cast<double>(estimator.getEstFracBits()) / (1 << SCALE_BITS);
+        const double bitsCoded = static_cast<double>(encoder.getBitstream().size() * 8);
+        REQUIRE(std::abs(bitsEstimated - bitsCoded) < 0.01 * bitsCoded);
+    }
+
+    const autotune::SearchSpace searchSpace;
+    const auto results = autotune::autotune(symbols.data(), symbols.size(), searchSpace, 4);
+    REQUIRE(results.size() == searchSpace.getCandidates(40).size());
+    for (size_t i = 0; i < results.size(); i++) {
+        REQUIRE(results[i].symbolsPerSecond > 0);
+        if (i > 0) {
+            REQUIRE(results[i - 1].bitsPerSymbol <= results[i].bitsPerSymbol);
+        }
+    }
+    REQUIRE(!results[0].config.bypass);
+
+    // The ranking does not depend on the number of threads
+    const auto results1 = autotune::autotune(symbols.data(), symbols.size(), searchSpace, 1);
+    for (size_t i = 0; i < results.size(); i++) {
+        REQUIRE(results[i].bitsPerSymbol == results1[i].bitsPerSymbol);
+        REQUIRE(results[i].config.binParams == results1[i].config.binParams);
+        REQUIRE(results[i].config.ctxParams == results1[i].config.ctxParams);
+    }
+
+    // A context offset does not change the estimate
+    {
+        const std::vector<CodingConfig> candidates{
+            CodingConfig(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINSORDERN, {40, 1},
+                {1, 4, 0}),
+            CodingConfig(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINSORDERN, {40, 1},
+                {1, 4, 100})};
+        const auto resultsOffset = autotune::autotune(symbols.data(), symbols.size(), candidates, 2);
+        REQUIRE(resultsOffset.size() == 2);
+        REQUIRE(resultsOffset[0].bitsPerSymbol == resultsOffset[1].bitsPerSymbol);
+    }
+
+    // The best configuration plugs into encodeSymbols
+    const CodingConfig& config = results[0].config;
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(config.numContexts, 0.5, 8);
+    encoder.start();
+    encoder.encodeSymbols(symbols.data(), symbols.size(), config);
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+    const double bitsPerSymbol = static_cast<double>(encoder.getBitstream().size() * 8) / symbols.size();
+    REQUIRE(std::abs(bitsPerSymbol - results[0].bitsPerSymbol) < 0.01 * bitsPerSymbol);
+
+    cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(config.numContexts, 0.5, 8);
+    decoder.start();
+    std::vector<uint64_t> symbolsDecoded(symbols.size());
+    decoder.decodeSymbols(symbolsDecoded.data(), symbolsDecoded.size(), config);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+    REQUIRE(symbolsDecoded == symbols);
+
+    // Wide-range symbols: no TU/TB candidates (maxSymbolTU), no candidates which cannot represent the largest symbol
+    autotune::SearchSpace searchSpaceAll;
+    searchSpaceAll.binIds = {binarization::BinarizationId::BI, binarization::BinarizationId::TU,
+        binarization::BinarizationId::EGk, binarization::BinarizationId::TB, binarization::BinarizationId::UEGk};
+    for (const uint64_t maxSymbol : {uint64_t(1) << 20, uint64_t(1) << 40}) {
+        std::uniform_int_distribution<uint64_t> distWide(0, maxSymbol);
+        std::vector<uint64_t> symbolsWide(5000);
+        for (auto& symbol : symbolsWide) {
+            symbol = distWide(gen);
+        }
+        symbolsWide[0] = maxSymbol;
+
+        const auto resultsWide = autotune::autotune(symbolsWide.data(), symbolsWide.size(), searchSpaceAll);
+        REQUIRE(!resultsWide.empty());
+        for (const auto& result : resultsWide) {
+            REQUIRE(result.config.binId != binarization::BinarizationId::TU);
+            REQUIRE(result.config.binId != binarization::BinarizationId::TB);
+            if (result.config.binId == binarization::BinarizationId::EGk) {
+                REQUIRE(maxSymbol <= UINT32_MAX);
+                REQUIRE(result.config.numMaxBins == maxSymbol);
+            }
+        }
+
+        const CodingConfig& configWide = resultsWide[0].config;
+        cabacSimpleSequenceEncoder encoderWide;
+        encoderWide.initCtx(std::max(1u, configWide.numContexts), 0.5, 8);
+        encoderWide.start();
+        encoderWide.encodeSubstream(symbolsWide, configWide);
+        encoderWide.encodeBinTrm(1);
+        encoderWide.finish();
+        encoderWide.writeByteAlignment();
+
+        cabacSimpleSequenceDecoder decoderWide(encoderWide.getBitstream());
+        decoderWide.initCtx(std::max(1u, configWide.numContexts), 0.5, 8);
+        decoderWide.start();
+        std::vector<uint64_t> symbolsWideDecoded;
+        decoderWide.decodeSubstream(symbolsWideDecoded, symbolsWide.size(), configWide);
+        REQUIRE(decoderWide.decodeBinTrm() == 1);
+        decoderWide.finish();
+        REQUIRE(symbolsWideDecoded == symbolsWide);
+    }
+    searchSpaceAll.maxSymbolTU = 1 << 20;
+    REQUIRE(searchSpaceAll.getCandidates(1 << 20).size() > searchSpaceAll.getCandidates((1 << 20) + 1).size());
+}
+
+
+TEST_CASE("test_blockSwitching")
+{
+    std::cout << "--- test_blockSwitching" << std::endl;
+
+    // Segments alternating between small, skewed values and uniform values
+    std::mt19937 gen(7);
+    std::geometric_distribution<uint64_t> distSkewed(0.7);
+    std::uniform_int_distribution<uint64_t> distUniform(0, 63);
+    std::vector<uint64_t> symbols(16000);
+    for (size_t i = 0; i < symbols.size(); i++) {
+        symbols[i] = (i / 2000) % 2 ? distUniform(gen) : std::min<uint64_t>(distSkewed(gen), 63);
+    }
+
+    const CodingConfig configTU(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINSORDERN,
+        {63}, {1, 8, 0});
+    const CodingConfig configEGk(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINPOSITION,
+        {63, 2}, {1, 16, configTU.numContexts});
+    const CodingConfig configBI(binarization::BinarizationId::BI, {6});
+    const BlockSwitchingConfig blockConfig({configTU, configEGk, configBI}, 500);
+    REQUIRE(blockConfig.ctxIdSelect == configTU.numContexts + configEGk.numContexts);
+    REQUIRE(blockConfig.numContexts == blockConfig.ctxIdSelect + 2);
+    REQUIRE_THROWS(BlockSwitchingConfig({}, 500));
+    REQUIRE_THROWS(BlockSwitchingConfig({configTU}, 0));
+
+    for (unsigned int numSymbols : {0u, 1u, 499u, 16000u}) {
+        cabacSimpleSequenceEncoder encoder;
+        encoder.initCtx(blockConfig.numContexts, 0.5, 8);
+        encoder.start();
+        const std::vector<unsigned int> selection = encoder.encodeSymbolsBlockSwitching(symbols.data(), numSymbols,
+            blockConfig);
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        REQUIRE(selection.size() == (numSymbols + 499) / 500);
+
+        cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+        decoder.initCtx(blockConfig.numContexts, 0.5, 8);
+        decoder.start();
+        std::vector<uint64_t> symbolsDecoded(numSymbols);
+        decoder.decodeSymbolsBlockSwitching(symbolsDecoded.data(), numSymbols, blockConfig);
+        REQUIRE(decoder.decodeBinTrm() == 1);
+        decoder.finish();
+        REQUIRE(std::equal(symbolsDecoded.begin(), symbolsDecoded.end(), symbols.begin()));
+
+        if (numSymbols == symbols.size()) {
+            // Context-coded candidates for the skewed segments, bypass for the uniform ones
+            REQUIRE(selection[0] != 2);
+            REQUIRE(std::count(selection.begin(), selection.end(), 2u) >= 12);
+
+            // Fewer bits than any single candidate for the whole sequence
+            for (const auto& config : blockConfig.candidates) {
+                cabacSimpleSequenceEncoder encoderSingle;
+                encoderSingle.initCtx(blockConfig.numContexts, 0.5, 8);
+                encoderSingle.start();
+                encoderSingle.encodeSubstream(symbols, config);
+                encoderSingle.encodeBinTrm(1);
+                encoderSingle.finish();
+                encoderSingle.writeByteAlignment();
+                REQUIRE(encoder.getBitstream().size() < encoderSingle.getBitstream().size());
+            }
+        }
+    }
+
+    // A single candidate is coded without selection bins, as separate encodeSymbols calls per block
+    const BlockSwitchingConfig blockConfigSingle({configTU}, 1000);
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(blockConfigSingle.numContexts, 0.5, 8);
+    encoder.start();
+    encoder.encodeSymbolsBlockSwitching(symbols.data(), 3500, blockConfigSingle);
+    encoder.finish();
+    cabacSimpleSequenceEncoder encoderBlocks;
+    encoderBlocks.initCtx(configTU.numContexts, 0.5, 8);
+    encoderBlocks.start();
+    for (unsigned int d0 = 0; d0 < 3500; d0 += 1000) {
+        encoderBlocks.encodeSymbols(symbols.data() + d0, std::min(1000u, 3500 - d0), configTU);
+    }
+    encoderBlocks.finish();
+    REQUIRE(encoder.getBitstream() == encoderBlocks.getBitstream());
+}
+
+
+TEST_CASE("test_BIbypassAligned")
+{
+    std::cout << "--- test_BIbypassAligned" << std::endl;
+
+    std::vector<std::tuple<double, uint8_t>> ctxInit {{0.9, 8}};
+    for (unsigned int numBins : {1u, 3u, 8u, 13u, 16u, 32u, 41u, 64u}) {
+        for (unsigned int numSymbols : {0u, 1u, 7u, 1000u}) {
+            std::vector<uint64_t> symbols(numSymbols);
+            fillVectorRandomUniform(0, numBins < 64 ? (uint64_t(1) << numBins) - 1 : UINT64_MAX, &symbols);
+            const CodingConfig config(binarization::BinarizationId::BI, {numBins});
+
+            // Reference: align() and bin-wise coding; context-coded bins around the sequence
+            cabacSimpleSequenceEncoder encoderRef;
+            encoderRef.initCtx(ctxInit);
+            encoderRef.start();
+            for (unsigned int i = 0; i < 20; i++) {
+                encoderRef.encodeBin(i % 7 != 0, 0);
+            }
+            encoderRef.align();
+            for (uint64_t symbol : symbols) {
+                encoderRef.encodeBinsEP64(symbol, numBins);
+            }
+            encoderRef.encodeBin(1, 0);
+            encoderRef.encodeBinTrm(1);
+            encoderRef.finish();
+            encoderRef.writeByteAlignment();
+
+            cabacSimpleSequenceEncoder encoder;
+            encoder.initCtx(ctxInit);
+            encoder.start();
+            for (unsigned int i = 0; i < 20; i++) {
+                encoder.encodeBin(i % 7 != 0, 0);
+            }
+            encoder.encodeSymbolsBypassAligned(symbols.data(), numSymbols, config);
+            encoder.encodeBin(1, 0);
+            encoder.encodeBinTrm(1);
+            encoder.finish();
+            encoder.writeByteAlignment();
+            REQUIRE(encoder.getBitstream() == encoderRef.getBitstream());
+
+            cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+            decoder.initCtx(ctxInit);
+            decoder.start();
+            for (unsigned int i = 0; i < 20; i++) {
+                REQUIRE(decoder.decodeBin(0) == (i % 7 != 0));
+            }
+            std::vector<uint64_t> decodedSymbols(numSymbols);
+            decoder.decodeSymbolsBypassAligned(decodedSymbols.data(), numSymbols, config);
+            REQUIRE(decodedSymbols == symbols);
+            REQUIRE(decoder.decodeBin(0) == 1);
+            REQUIRE(decoder.decodeBinTrm() == 1);
+            decoder.finish();
+        }
+    }
+
+    cabacSimpleSequenceEncoder encoder;
+    encoder.start();
+    const uint64_t symbol = 3;
+    REQUIRE_THROWS(encoder.encodeSymbolsBypassAligned(&symbol, 1, CodingConfig(binarization::BinarizationId::TU, {8})));
+}
+
+
+template <typename T>
+static std::vector<uint8_t> encodeDecodeSigned(const std::vector<T>& symbols, const CodingConfig& config,
+    const binarization::SignMode signMode)
+{
+    const unsigned int numContexts = config.ctxOffset + config.numContexts + CodingConfig::numSignContexts;
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(numContexts, 0.5, 8);
+    encoder.start();
+    encoder.encodeSymbolsSigned(symbols.data(), symbols.size(), config, signMode);
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(numContexts, 0.5, 8);
+    decoder.start();
+    std::vector<T> decoded(symbols.size());
+    decoder.decodeSymbolsSigned(decoded.data(), decoded.size(), config, signMode);
+    REQUIRE(decoded == symbols);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+    return encoder.getBitstream();
+}
+
+TEST_CASE("test_signedSymbols")
+{
+    std::cout << "--- test_signedSymbols" << std::endl;
+
+    const auto EGk = binarization::BinarizationId::EGk;
+    const auto ZIGZAG = binarization::SignMode::ZIGZAG;
+    const auto SIGNBYPASS = binarization::SignMode::SIGNBYPASS;
+    const auto SIGNCONTEXT = binarization::SignMode::SIGNCONTEXT;
+
+    // Mapping, including the extreme values
+    for (int64_t value : {int64_t(0), int64_t(1), int64_t(-1), int64_t(2), int64_t(-2), INT64_MAX, INT64_MIN}) {
+        for (auto signMode : {ZIGZAG, SIGNBYPASS, SIGNCONTEXT}) {
+            const uint64_t u = binarization::getUnsignedValue(value, signMode);
+            REQUIRE(binarization::getSignedValue(u, value < 0, signMode) == value);
+        }
+    }
+    REQUIRE(binarization::getUnsignedValue(-3, ZIGZAG) == 5);
+    REQUIRE(binarization::getUnsignedValue(3, ZIGZAG) == 6);
+    REQUIRE(binarization::getUnsignedValue(INT64_MIN, SIGNBYPASS) == uint64_t(1) << 63);
+
+    // Random walk with a persistent sign, with extreme values of each type
+    const unsigned int numSymbols = 20000;
+    std::mt19937 gen(0);
+    std::vector<int64_t> symbols64(numSymbols);
+    for (unsigned int i = 0; i < numSymbols; i++) {
+        const int64_t magnitude = gen() % 8 ? gen() % 20 : gen() % 100;
+        symbols64[i] = (i / 200) % 2 ? -magnitude : magnitude;
+    }
+    const std::vector<std::pair<contextSelector::ContextModelId, std::vector<unsigned int>>> ctxModels = {
+        {contextSelector::ContextModelId::BINPOSITION, {1, 8, 2}},
+        {contextSelector::ContextModelId::BINSORDERN, {2, 8, 0}},
+        {contextSelector::ContextModelId::SYMBOLORDERN, {1, 8, 1, 4}},
+        {contextSelector::ContextModelId::BINSYMBOLPOSITION, {1, 8, 0, 0, 2}},
+    };
+    for (const auto& ctxModel : ctxModels) {
+        const CodingConfig config(EGk, ctxModel.first, {1 << 16, 0}, ctxModel.second);
+        for (auto signMode : {ZIGZAG, SIGNBYPASS, SIGNCONTEXT}) {
+            std::vector<int8_t> symbols8(symbols64.begin(), symbols64.end());
+            symbols8[0] = INT8_MIN;
+            symbols8[1] = INT8_MAX;
+            std::vector<int16_t> symbols16(symbols64.begin(), symbols64.end());
+            symbols16[0] = INT16_MIN;
+            std::vector<int32_t> symbols32(symbols64.begin(), symbols64.end());
+            symbols32[0] = INT32_MIN;
+            std::vector<int64_t> symbols64Extreme(symbols64);
+            symbols64Extreme[0] = INT64_MIN;
+            symbols64Extreme[1] = INT64_MAX;
+            encodeDecodeSigned(symbols8, config, signMode);
+            encodeDecodeSigned(symbols16, config, signMode);
+            encodeDecodeSigned(symbols32, config, signMode);
+            encodeDecodeSigned(symbols64Extreme, config, signMode);
+            encodeDecodeSigned(symbols64Extreme, CodingConfig(EGk, {0, 2}), signMode);
+        }
+    }
+    encodeDecodeSigned(symbols64, CodingConfig(binarization::BinarizationId::RICE,
+        contextSelector::ContextModelId::BINPOSITION, {0, 0, 1, 5, 15}, {1, 5, 0}), SIGNCONTEXT);
+
+    // ZIGZAG is identical to coding the mapped values as unsigned symbols
+    const CodingConfig config(EGk, contextSelector::ContextModelId::BINSORDERN, {1 << 16, 0}, {2, 8, 0});
+    std::vector<uint64_t> mapped(numSymbols);
+    for (unsigned int i = 0; i < numSymbols; i++) {
+        mapped[i] = binarization::getUnsignedValue(symbols64[i], ZIGZAG);
+    }
+    cabacSimpleSequenceEncoder encoderRef;
+    encoderRef.initCtx(config.numContexts + CodingConfig::numSignContexts, 0.5, 8);
+    encoderRef.start();
+    encoderRef.encodeSymbols(mapped.data(), mapped.size(), config);
+    encoderRef.encodeBinTrm(1);
+    encoderRef.finish();
+    encoderRef.writeByteAlignment();
+    REQUIRE(encodeDecodeSigned(symbols64, config, ZIGZAG) == encoderRef.getBitstream());
+
+    // Context-coded sign bins exploit the correlation of the signs
+    const size_t sizeSignBypass = encodeDecodeSigned(symbols64, config, SIGNBYPASS).size();
+    const size_t sizeSignContext = encodeDecodeSigned(symbols64, config, SIGNCONTEXT).size();
+    std::cout << "Sign bypass: " << sizeSignBypass << " bytes, sign context: " << sizeSignContext << " bytes" << std::endl;
+    REQUIRE(sizeSignContext < sizeSignBypass);
+}
+
+
+TEST_CASE("test_prediction")
+{
+    std::cout << "--- test_prediction" << std::endl;
+
+    const auto ZIGZAG = binarization::SignMode::ZIGZAG;
+    const CodingConfig config(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINSORDERN,
+        {1 << 16, 0}, {2, 12, 0});
+
+    // Two interleaved, slowly varying channels
+    const unsigned int numSymbols = 20000;
+    std::mt19937 gen(0);
+    std::vector<int16_t> symbols(numSymbols);
+    for (unsigned int i = 0; i < numSymbols; i++) {
+        const double t = (i / 2) * 0.01;
+        const double amplitude = i % 2 ? 3000.0 : 1000.0;
+        symbols[i] = static_cast<int16_t>(std::lround(amplitude * std::sin(t)) + static_cast<int>(gen() % 5) - 2);
+    }
+
+    const size_t sizeNone = encodeDecodeSigned(symbols, config, ZIGZAG).size();
+    for (auto predictorId : {prediction::PredictorId::PREVIOUS, prediction::PredictorId::LINEAR}) {
+        for (unsigned int lag : {1u, 2u, 5u}) {
+            const prediction::Predictor predictor(predictorId, lag);
+
+            // Reference: residuals computed up front
+            std::vector<int16_t> residuals(numSymbols);
+            for (unsigned int i = 0; i < numSymbols; i++) {
+                int prediction = 0;
+                if (i >= 2 * lag && predictorId == prediction::PredictorId::LINEAR) {
+                    prediction = 2 * symbols[i - lag] - symbols[i - 2 * lag];
+                } else if (i >= lag) {
+                    prediction = symbols[i - lag];
+                }
+                residuals[i] = static_cast<int16_t>(symbols[i] - prediction);
+            }
+            const std::vector<uint8_t> bitstreamRef = encodeDecodeSigned(residuals, config, ZIGZAG);
+
+            const unsigned int numContexts = config.numContexts + CodingConfig::numSignContexts;
+            cabacSimpleSequenceEncoder encoder;
+            encoder.initCtx(numContexts, 0.5, 8);
+            encoder.start();
+            encoder.encodeSymbolsSigned(symbols.data(), symbols.size(), config, ZIGZAG, predictor);
+            encoder.encodeBinTrm(1);
+            encoder.finish();
+            encoder.writeByteAlignment();
+            REQUIRE(encoder.getBitstream() == bitstreamRef);
+
+            cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+            decoder.initCtx(numContexts, 0.5, 8);
+            decoder.start();
+            std::vector<int16_t> decoded(numSymbols);
+            decoder.decodeSymbolsSigned(decoded.data(), decoded.size(), config, ZIGZAG, predictor);
+            REQUIRE(decoded == symbols);
+            REQUIRE(decoder.decodeBinTrm() == 1);
+            decoder.finish();
+
+            std::cout << "Predictor " << static_cast<int>(predictorId) << ", lag " << lag << ": "
+                << bitstreamRef.size() << " bytes, without prediction: " << sizeNone << " bytes" << std::endl;
+            if (lag == 2) {  // matches the interleaving
+                REQUIRE(bitstreamRef.size() < sizeNone / 2);
+            }
+        }
+    }
+
+    // Residuals wrap around within the symbol type: unsigned symbols passed as signed symbols of the same width,
+    // with extreme values of the signed type
+    std::vector<uint8_t> symbolsUnsigned;
+    for (unsigned int i = 0; i < 1000; i++) {
+        symbolsUnsigned.push_back(static_cast<uint8_t>(120 + (i % 16) + (i % 7 == 0 ? 130 : 0)));
+    }
+    std::vector<int8_t> symbolsSigned = {INT8_MIN, INT8_MAX, INT8_MIN, INT8_MAX, 0, INT8_MIN, INT8_MIN, INT8_MAX};
+    for (auto predictorId : {prediction::PredictorId::PREVIOUS, prediction::PredictorId::LINEAR}) {
+        const prediction::Predictor predictor(predictorId, 1);
+        for (auto signMode : {ZIGZAG, binarization::SignMode::SIGNBYPASS, binarization::SignMode::SIGNCONTEXT}) {
+            for (const auto& symbols8 : {std::vector<int8_t>(symbolsUnsigned.begin(), symbolsUnsigned.end()), symbolsSigned}) {
+                cabacSimpleSequenceEncoder encoder;
+                encoder.initCtx(CodingConfig::numSignContexts, 0.5, 8);
+                encoder.start();
+                encoder.encodeSymbolsSigned(symbols8.data(), symbols8.size(), CodingConfig(binarization::BinarizationId::BI, {8}),
+                    signMode, predictor);
+                encoder.encodeBinTrm(1);
+                encoder.finish();
+                encoder.writeByteAlignment();
+
+                cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+                decoder.initCtx(CodingConfig::numSignContexts, 0.5, 8);
+                decoder.start();
+                std::vector<int8_t> decoded(symbols8.size());
+                decoder.decodeSymbolsSigned(decoded.data(), decoded.size(), CodingConfig(binarization::BinarizationId::BI, {8}),
+                    signMode, predictor);
+                REQUIRE(decoded == symbols8);
+                REQUIRE(decoder.decodeBinTrm() == 1);
+                decoder.finish();
+            }
+        }
+    }
+
+    REQUIRE_THROWS(prediction::Predictor(prediction::PredictorId::PREVIOUS, 0));
+}
+
+
+// Encodes and decodes symbols with remapping in chunks of chunkSize symbols and returns the bitstream
+static std::vector<uint8_t> encodeDecodeRemapped(const std::vector<uint64_t>& symbols, const CodingConfig& config,
+    const remapping::RemapperId remapperId, const unsigned int alphabetSize, const unsigned int chunkSize)
+{
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(config.numContexts, 0.5, 8);
+    encoder.start();
+    remapping::SymbolRemapper remapperEnc(remapperId, alphabetSize);
+    for (unsigned int i = 0; i < symbols.size(); i += chunkSize) {
+        const unsigned int n = std::min<unsigned int>(chunkSize, static_cast<unsigned int>(symbols.size()) - i);
+        encoder.encodeSymbolsRemapped(symbols.data() + i, n, config, remapperEnc);
+    }
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+
+    cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(config.numContexts, 0.5, 8);
+    decoder.start();
+    remapping::SymbolRemapper remapperDec(remapperId, alphabetSize);
+    std::vector<uint64_t> decoded(symbols.size());
+    for (unsigned int i = 0; i < symbols.size(); i += chunkSize) {
+        const unsigned int n = std::min<unsigned int>(chunkSize, static_cast<unsigned int>(symbols.size()) - i);
+        decoder.decodeSymbolsRemapped(decoded.data() + i, n, config, remapperDec);
+    }
+    REQUIRE(decoded == symbols);
+    REQUIRE(decoder.decodeBinTrm() == 1);
+    decoder.finish();
+
+    return encoder.getBitstream();
+}
+
+TEST_CASE("test_remapping")
+{
+    std::cout << "--- test_remapping" << std::endl;
+
+    // Few frequent symbols with large values, and runs of recently used symbols
+    const unsigned int alphabetSize = 256;
+    const unsigned int numSymbols = 20000;
+    std::mt19937 gen(0);
+    std::vector<uint64_t> symbols(numSymbols);
+    for (unsigned int i = 0; i < numSymbols; i++) {
+        const unsigned int r = gen() % 16;
+        if (r < 10) {
+            symbols[i] = r < 6 ? 200 : (r < 9 ? 17 : 250);
+        } else if (r < 14 && i > 0) {
+            symbols[i] = symbols[i - 1];
+        } else {
+            symbols[i] = gen() % alphabetSize;
+        }
+    }
+
+    const std::vector<std::pair<binarization::BinarizationId, std::vector<unsigned int>>> binarizations = {
+        {binarization::BinarizationId::BI, {8}},
+        {binarization::BinarizationId::TU, {alphabetSize - 1}},
+        {binarization::BinarizationId::EGk, {alphabetSize - 1, 0}},
+        {binarization::BinarizationId::RICE, {0, 0, 1, 5, 15}},
+        {binarization::BinarizationId::TB, {alphabetSize - 1}},
+        {binarization::BinarizationId::UEGk, {4, 0}},
+    };
+    for (const auto& bin : binarizations) {
+        for (const auto& config : {CodingConfig(bin.first, contextSelector::ContextModelId::SYMBOLORDERN, bin.second, {2, 12, 0, 3}),
+            CodingConfig(bin.first, contextSelector::ContextModelId::BINPOSITION, bin.second, {1, 12, 0}),
+            CodingConfig(bin.first, bin.second)}) {
+            // Without remapping, the bitstream matches encodeSymbols/encodeSymbolsBypass
+            cabacSimpleSequenceEncoder encoder;
+            encoder.initCtx(config.numContexts, 0.5, 8);
+            encoder.start();
+            if (config.bypass) {
+                encoder.encodeSymbolsBypass(symbols.data(), numSymbols, config);
+            } else {
+                encoder.encodeSymbols(symbols.data(), numSymbols, config);
+            }
+            encoder.encodeBinTrm(1);
+            encoder.finish();
+            encoder.writeByteAlignment();
+            const std::vector<uint8_t> bitstreamNone = encodeDecodeRemapped(symbols, config, remapping::RemapperId::NONE,
+                0, numSymbols);
+            REQUIRE(encoder.getBitstream() == bitstreamNone);
+
+            for (auto remapperId : {remapping::RemapperId::FREQUENCY, remapping::RemapperId::MTF}) {
+                // The remapper state carries over when coding in chunks
+                const std::vector<uint8_t> bitstream = encodeDecodeRemapped(symbols, config, remapperId, alphabetSize,
+                    numSymbols);
+                encodeDecodeRemapped(symbols, config, remapperId, alphabetSize, 777);
+                if (bin.first == binarization::BinarizationId::EGk) {
+                    std::cout << "EGk, remapper " << static_cast<int>(remapperId) << ", bypass " << config.bypass << ": "
+                        << bitstream.size() << " bytes, without remapping: " << bitstreamNone.size() << " bytes" << std::endl;
+                    REQUIRE(bitstream.size() < bitstreamNone.size());
+                }
+            }
+        }
+    }
+
+    // Count halving keeps encoder and decoder in sync
+    std::vector<uint64_t> symbolsLong(300000);
+    for (unsigned int i = 0; i < symbolsLong.size(); i++) {
+        symbolsLong[i] = i < 150000 ? (gen() % 4 ? 3 : gen() % 8) : (gen() % 4 ? 6 : gen() % 8);
+    }
+    encodeDecodeRemapped(symbolsLong, CodingConfig(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINPOSITION,
+        {7}, {1, 8, 0}), remapping::RemapperId::FREQUENCY, 8, 100000);
+
+    remapping::SymbolRemapper remapper(remapping::RemapperId::FREQUENCY, alphabetSize);
+    REQUIRE_THROWS(remapper.getRank(alphabetSize));
+    REQUIRE_THROWS(remapper.getSymbol(alphabetSize));
+    REQUIRE_THROWS(remapping::SymbolRemapper(remapping::RemapperId::MTF, 0));
+}
+
+
+TEST_CASE("test_transforms")
+{
+    std::cout << "--- test_transforms" << std::endl;
+
+    // Round trips of the transforms, including empty sequences, runs longer than the guard and overlapping matches
+    std::mt19937 gen(0);
+    std::vector<std::vector<uint64_t>> sequences = {{}, {0}, {5}, {0, 0, 0}, {3, 3, 3, 3, 3, 3, 3, 3, 3, 3}, {1, 2, 1, 2, 1, 2, 1}};
+    std::vector<uint64_t> symbolsRandom(5000);
+    for (auto& symbol : symbolsRandom) {
+        symbol = gen() % 3 ? gen() % 4 : gen() % 1000;
+    }
+    sequences.push_back(symbolsRandom);
+    for (const auto& symbols : sequences) {
+        const unsigned int numSymbols = static_cast<unsigned int>(symbols.size());
+        std::vector<uint64_t> decoded(numSymbols);
+
+        const transform::EqualityStreams equality = transform::encodeEquality(symbols.data(), numSymbols);
+        transform::decodeEquality(equality, decoded.data());
+        REQUIRE(decoded == symbols);
+
+        for (uint64_t guard : {0u, 1u, 2u, 4u}) {
+            const transform::RunLengthStreams runLength = transform::encodeRunLength(symbols.data(), numSymbols, guard);
+            REQUIRE(transform::getNumRuns(runLength.lengths, guard) == runLength.values.size());
+            std::fill(decoded.begin(), decoded.end(), 0);
+            transform::decodeRunLength(runLength, guard, numSymbols, decoded.data());
+            REQUIRE(decoded == symbols);
+        }
+
+        for (unsigned int windowSize : {1u, 2u, 16u, 100000u}) {
+            const transform::MatchStreams match = transform::encodeMatch(symbols.data(), numSymbols, windowSize);
+            REQUIRE(transform::getNumMatches(match.lengths) == match.offsets.size());
+            REQUIRE(match.lengths.size() - match.offsets.size() == match.literals.size());
+            for (uint64_t offset : match.offsets) {
+                REQUIRE(offset < windowSize);
+            }
+            std::fill(decoded.begin(), decoded.end(), 0);
+            transform::decodeMatch(match, numSymbols, decoded.data());
+            REQUIRE(decoded == symbols);
+        }
+    }
+    REQUIRE(transform::encodeMatch(sequences[4].data(), 10, 1).lengths.size() == 2);  // literal and overlapping match
+    REQUIRE_THROWS(transform::encodeMatch(sequences[4].data(), 10, 0));
+
+    // Sub-streams which do not yield exactly numSymbols symbols (or leave entries unused) are rejected
+    {
+        const std::vector<uint64_t>& symbols = sequences[5];
+        const unsigned int numSymbols = static_cast<unsigned int>(symbols.size());
+        std::vector<uint64_t> decoded(numSymbols + 1);
+
+        transform::EqualityStreams equality = transform::encodeEquality(symbols.data(), numSymbols);
+        equality.values.push_back(1);
+        REQUIRE_THROWS(transform::decodeEquality(equality, decoded.data()));
+
+        transform::RunLengthStreams runLength = transform::encodeRunLength(symbols.data(), numSymbols, 0);
+        REQUIRE_THROWS(transform::decodeRunLength(runLength, 0, numSymbols + 1, decoded.data()));
+        runLength.values.push_back(7);
+        REQUIRE_THROWS(transform::decodeRunLength(runLength, 0, numSymbols, decoded.data()));
+
+        transform::MatchStreams match = transform::encodeMatch(symbols.data(), numSymbols, 16);
+        REQUIRE_THROWS(transform::decodeMatch(match, numSymbols + 1, decoded.data()));
+        match.literals.push_back(7);
+        REQUIRE_THROWS(transform::decodeMatch(match, numSymbols, decoded.data()));
+    }
+
+    // Repeats of a random segment with a few mutations and runs (genomics-like data)
+    std::vector<uint64_t> segment(2000);
+    for (auto& symbol : segment) {
+        symbol = gen() % 4;
+    }
+    std::vector<uint64_t> symbols;
+    for (unsigned int r = 0; r < 20; r++) {
+        for (unsigned int i = 0; i < segment.size(); i++) {
+            symbols.push_back(gen() % 200 ? segment[i] : gen() % 4);
+        }
+        symbols.insert(symbols.end(), 50 + gen() % 100, 2);
+    }
+    const unsigned int numSymbols = static_cast<unsigned int>(symbols.size());
+
+    const CodingConfig symbolConfig(binarization::BinarizationId::BI, contextSelector::ContextModelId::BINSORDERN, {2}, {2, 2, 0});
+    const CodingConfig flagConfig(binarization::BinarizationId::BI, contextSelector::ContextModelId::BINSORDERN, {1}, {2, 1, 0});
+    const CodingConfig valueConfig(binarization::BinarizationId::TB, contextSelector::ContextModelId::BINSORDERN, {2}, {1, 2, 10});
+    const CodingConfig lengthConfig(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINPOSITION, {1u << 16, 0}, {1, 16, 20});
+    const CodingConfig offsetConfig(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINPOSITION, {1u << 16, 0}, {1, 16, 40});
+    const unsigned int numContexts = 60;
+
+    auto encode = [&](const std::function<void(cabacSimpleSequenceEncoder&)>& encodeSequence) {
+        cabacSimpleSequenceEncoder encoder;
+        encoder.initCtx(numContexts, 0.5, 8);
+        encoder.start();
+        encodeSequence(encoder);
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        return encoder.getBitstream();
+    };
+    auto decode = [&](const std::vector<uint8_t>& bitstream,
+        const std::function<void(cabacSimpleSequenceDecoder&, uint64_t *)>& decodeSequence) {
+        cabacSimpleSequenceDecoder decoder(bitstream);
+        decoder.initCtx(numContexts, 0.5, 8);
+        decoder.start();
+        std::vector<uint64_t> decoded(numSymbols);
+        decodeSequence(decoder, decoded.data());
+        REQUIRE(decoded == symbols);
+        REQUIRE(decoder.decodeBinTrm() == 1);
+        decoder.finish();
+    };
+
+    const size_t sizePlain = encode([&](cabacSimpleSequenceEncoder& encoder) {
+        encoder.encodeSymbols(symbols.data(), numSymbols, symbolConfig);
+    }).size();
+
+    const std::vector<uint8_t> bitstreamEquality = encode([&](cabacSimpleSequenceEncoder& encoder) {
+        encoder.encodeSymbolsEquality(symbols.data(), numSymbols, flagConfig, valueConfig);
+    });
+    decode(bitstreamEquality, [&](cabacSimpleSequenceDecoder& decoder, uint64_t * decoded) {
+        decoder.decodeSymbolsEquality(decoded, numSymbols, flagConfig, valueConfig);
+    });
+
+    const std::vector<uint8_t> bitstreamRunLength = encode([&](cabacSimpleSequenceEncoder& encoder) {
+        encoder.encodeSymbolsRunLength(symbols.data(), numSymbols, 8, symbolConfig, lengthConfig);
+    });
+    decode(bitstreamRunLength, [&](cabacSimpleSequenceDecoder& decoder, uint64_t * decoded) {
+        decoder.decodeSymbolsRunLength(decoded, numSymbols, 8, symbolConfig, lengthConfig);
+    });
+
+    const std::vector<uint8_t> bitstreamMatch = encode([&](cabacSimpleSequenceEncoder& encoder) {
+        encoder.encodeSymbolsMatch(symbols.data(), numSymbols, 1u << 12, lengthConfig, offsetConfig, symbolConfig);
+    });
+    decode(bitstreamMatch, [&](cabacSimpleSequenceDecoder& decoder, uint64_t * decoded) {
+        decoder.decodeSymbolsMatch(decoded, numSymbols, lengthConfig, offsetConfig, symbolConfig);
+    });
+
+    // Bypass-coded sub-streams
+    const CodingConfig lengthConfigBypass(binarization::BinarizationId::EGk, {1u << 16, 0});
+    const std::vector<uint8_t> bitstreamMatchBypass = encode([&](cabacSimpleSequenceEncoder& encoder) {
+        encoder.encodeSymbolsMatch(symbols.data(), numSymbols, 1u << 12, lengthConfigBypass, lengthConfigBypass,
+            CodingConfig(binarization::BinarizationId::BI, {2}));
+    });
+    decode(bitstreamMatchBypass, [&](cabacSimpleSequenceDecoder& decoder, uint64_t * decoded) {
+        decoder.decodeSymbolsMatch(decoded, numSymbols, lengthConfigBypass, lengthConfigBypass,
+            CodingConfig(binarization::BinarizationId::BI, {2}));
+    });
+
+    std::cout << "Plain: " << sizePlain << " bytes, equality: " << bitstreamEquality.size() << " bytes, run-length: "
+        << bitstreamRunLength.size() << " bytes, match: " << bitstreamMatch.size() << " bytes" << std::endl;
+    REQUIRE(bitstreamMatch.size() < sizePlain / 4);
+    REQUIRE(bitstreamRunLength.size() < sizePlain * 2);
+}
+
+
+// Symbols of a 16-letter alphabet with a skewed distribution, and symbols >= 15 with probability 1/64
+static std::vector<uint64_t> getMultiSymbolTestData(const unsigned int numSymbols)
+{
+    std::mt19937 gen(0);
+    std::discrete_distribution<int> letters({30, 20, 12, 9, 7, 5, 4, 3, 2, 2, 1, 1, 1, 1, 1});
+    std::vector<uint64_t> symbols(numSymbols);
+    for (auto& symbol : symbols) {
+        symbol = gen() % 64 ? letters(gen) : 15 + gen() % 1000;
+    }
+    return symbols;
+}
+
+// Encodes and decodes symbols with the multi-symbol backend and returns the bitstream
+static std::vector<uint8_t> encodeDecodeMultiSymbol(const std::vector<uint64_t>& symbols,
+    const multiSymbol::Config& config, const multiSymbol::CdfAdaptation& adaptation = multiSymbol::CdfAdaptation())
+{
+    multiSymbolSequenceEncoder encoder;
+    encoder.initCtx(config.ctxOffset + config.numContexts, config.alphabetSize, adaptation);
+    encoder.start();
+    encoder.encodeSymbols(symbols.data(), static_cast<unsigned int>(symbols.size()), config);
+    encoder.finish();
+
+    multiSymbolSequenceDecoder decoder(encoder.getBitstream());
+    decoder.initCtx(config.ctxOffset + config.numContexts, config.alphabetSize, adaptation);
+    decoder.start();
+    std::vector<uint64_t> decoded(symbols.size());
+    decoder.decodeSymbols(decoded.data(), static_cast<unsigned int>(decoded.size()), config);
+    decoder.finish();
+    REQUIRE(decoded == symbols);
+
+    return encoder.getBitstream();
+}
+
+TEST_CASE("test_multiSymbol")
+{
+    std::cout << "--- test_multiSymbol" << std::endl;
+
+    const std::vector<uint64_t> symbols = getMultiSymbolTestData(100000);
+    for (unsigned int alphabetSize : {2u, 3u, 4u, 8u, 16u}) {
+        for (unsigned int order = 0; order < 3; order++) {
+            encodeDecodeMultiSymbol(symbols, multiSymbol::Config(alphabetSize, order, 5));
+        }
+    }
+    for (const auto& adaptation : {multiSymbol::CdfAdaptation(1, 1, 1), multiSymbol::CdfAdaptation(4, 10, 1),
+        multiSymbol::CdfAdaptation(14, 14, 100)}) {
+        encodeDecodeMultiSymbol(symbols, multiSymbol::Config(16), adaptation);
+    }
+
+    // Edge cases: empty sequence, extreme escapes, constant symbols (carry propagation through runs of 0xFF bytes)
+    encodeDecodeMultiSymbol({}, multiSymbol::Config(16));
+    encodeDecodeMultiSymbol({0, UINT64_MAX - 1, 15, 14, 16, UINT64_MAX - 1}, multiSymbol::Config(16, 1));
+    const std::vector<uint8_t> bitstreamConstant = encodeDecodeMultiSymbol(std::vector<uint64_t>(100000, 0),
+        multiSymbol::Config(16));
+    REQUIRE(bitstreamConstant.size() < 200);
+    encodeDecodeMultiSymbol(std::vector<uint64_t>(100000, 14), multiSymbol::Config(16));
+
+    // Compression close to the binary engine (TU with one context per bin) on the same data
+    const multiSymbol::Config config(16);
+    const size_t sizeMultiSymbol = encodeDecodeMultiSymbol(symbols, config).size();
+    std::vector<uint64_t> symbolsClipped(symbols.size());
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        symbolsClipped[i] = std::min<uint64_t>(symbols[i], 15);
+    }
+    const CodingConfig configBinary(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINPOSITION,
+        {15}, {1, 15, 0});
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(configBinary.numContexts, 0.5, 8);
+    encoder.start();
+    encoder.encodeSymbols(symbolsClipped.data(), symbolsClipped.size(), configBinary);
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+    encoder.writeByteAlignment();
+    size_t sizeBinary = encoder.getBitstream().size();
+    size_t sizeEscapes = 0;  // EG0 bits of the escapes
+    for (uint64_t symbol : symbols) {
+        if (symbol >= 15) {
+            sizeEscapes += 2 * static_cast<size_t>(std::floor(std::log2(symbol - 15 + 1))) + 1;
+        }
+    }
+    sizeBinary += sizeEscapes / 8;
+    std::cout << "Multi-symbol: " << sizeMultiSymbol << " bytes, binary: " << sizeBinary << " bytes" << std::endl;
+    REQUIRE(sizeMultiSymbol < sizeBinary * 1.02);
+
+    multiSymbolSequenceEncoder encoderUninitialized;
+    REQUIRE_THROWS(encoderUninitialized.encodeSymbols(symbols.data(), 1, config));
+    encoderUninitialized.initCtx(1, 8);
+    REQUIRE_THROWS(encoderUninitialized.encodeSymbols(symbols.data(), 1, config));
+    REQUIRE_THROWS(multiSymbol::Config(17));
+    REQUIRE_THROWS(multiSymbol::Config(16, 3));
+    REQUIRE_THROWS(multiSymbol::CdfAdaptation(8, 4));
+}
+
+
+TEST_CASE("test_rans")
+{
+    std::cout << "--- test_rans" << std::endl;
+
+    std::mt19937 gen(0);
+    std::geometric_distribution<int> geometric(0.05);
+    std::vector<uint64_t> symbols(100003);
+    for (auto& symbol : symbols) {
+        symbol = std::min(geometric(gen), 255);
+    }
+
+    // Blocks of several configurations in one bitstream
+    std::vector<uint64_t> counts(256, 0);
+    for (auto symbol : symbols) {
+        counts[symbol]++;
+    }
+    const std::vector<rans::Config> configs = {rans::Config(256, 4), rans::Config(256, 8), rans::Config(256, 4, counts),
+        rans::Config(4096, 8)};
+    const std::vector<std::vector<uint64_t>> sequences = {symbols, {}, {7}, {1, 2, 3, 4, 5, 6, 7, 8, 9},
+        std::vector<uint64_t>(1000, 255)};
+    ransSequenceEncoder encoder;
+    encoder.start();
+    for (const auto& config : configs) {
+        for (const auto& sequence : sequences) {
+            encoder.encodeSymbols(sequence.data(), static_cast<unsigned int>(sequence.size()), config);
+        }
+    }
+    encoder.finish();
+
+    ransSequenceDecoder decoder(encoder.getBitstream());
+    decoder.start();
+    for (const auto& config : configs) {
+        for (const auto& sequence : sequences) {
+            std::vector<uint64_t> decoded(sequence.size());
+            decoder.decodeSymbols(decoded.data(), static_cast<unsigned int>(decoded.size()), config);
+            REQUIRE(decoded == sequence);
+        }
+    }
+    decoder.finish();
+
+    // Size close to the empirical entropy (semi-static table with its header)
+    double entropy = 0;
+    for (auto count : counts) {
+        if (count > 0) {
+            entropy -= count * std::log2(static_cast<double>(count) / symbols.size());
+        }
+    }
+    ransSequenceEncoder encoderSingle;
+    encoderSingle.encodeSymbols(symbols.data(), static_cast<unsigned int>(symbols.size()), rans::Config(256));
+    std::cout << "rANS: " << encoderSingle.getBitstream().size() << " bytes, entropy: " << entropy / 8 << " bytes"
+        << std::endl;
+    REQUIRE(encoderSingle.getBitstream().size() < entropy / 8 * 1.01 + 200);
+
+    REQUIRE(rans::normalizeFrequencies({0, 1, 1000000, 0, 3}) == std::vector<uint32_t>({0, 1, 4094, 0, 1}));
+    std::vector<uint8_t> header;
+    rans::writeFrequencies({0, 0, 0, 4000, 96, 0}, header);
+    size_t pos = 0;
+    REQUIRE(rans::readFrequencies(6, header, pos) == std::vector<uint32_t>({0, 0, 0, 4000, 96, 0}));
+    REQUIRE(pos == header.size());
+
+    // Corrupted headers: frequencies above 2^scaleBits (whose sum would wrap in 32 bits), and an all-zero table
+    // with symbols to decode
+    {
+        std::vector<uint8_t> headerWrap;
+        rans::writeFrequencies({0xFFFFFFFF, 4097}, headerWrap);
+        pos = 0;
+        REQUIRE_THROWS(rans::readFrequencies(2, headerWrap, pos));
+        headerWrap.resize(headerWrap.size() + 64, 0);
+        ransSequenceDecoder decoderWrap(headerWrap);
+        decoderWrap.start();
+        std::vector<uint64_t> decodedWrap(8);
+        REQUIRE_THROWS(decoderWrap.decodeSymbols(decodedWrap.data(), 8, rans::Config(2)));
+
+        ransSequenceEncoder encoderEmpty;
+        encoderEmpty.encodeSymbols(nullptr, 0, rans::Config(3));
+        std::vector<uint8_t> bitstreamZero = encoderEmpty.getBitstream();
+        bitstreamZero.resize(bitstreamZero.size() + 64, 0);
+        ransSequenceDecoder decoderZero(bitstreamZero);
+        decoderZero.start();
+        std::vector<uint64_t> decodedZero(8);
+        REQUIRE_THROWS(decoderZero.decodeSymbols(decodedZero.data(), 8, rans::Config(3)));
+        decoderZero.start();
+        decoderZero.decodeSymbols(decodedZero.data(), 0, rans::Config(3));
+    }
+
+    const std::vector<uint64_t> symbolOutside = {256};
+    REQUIRE_THROWS(encoder.encodeSymbols(symbolOutside.data(), 1, rans::Config(256)));
+    const std::vector<uint64_t> symbolZeroFreq = {0};
+    REQUIRE_THROWS(encoder.encodeSymbols(symbolZeroFreq.data(), 1, rans::Config(2, 4, {0, 1})));
+    REQUIRE_THROWS(rans::Config(256, 5));
+    REQUIRE_THROWS(rans::Config(4097));
+}
+
+
+TEST_CASE("benchmark_EGk", "[.benchmark]")
+{
+    std::cout << "--- benchmark_EGk" << std::endl;
+
+    const int numSymbols = 1000000;
+    std::vector<uint64_t> symbols(numSymbols);
+    fillVectorRandomGeometric(&symbols);
+    const CodingConfig config(binarization::BinarizationId::EGk, contextSelector::ContextModelId::BINPOSITION,
+        {UINT32_MAX, 1}, {1, 16, 0});
+
+    for (int bypass = 0; bypass < 2; bypass++) {
+        auto t0 = std::chrono::steady_clock::now();
+        cabacSimpleSequenceEncoder encoder;
+        encoder.initCtx(config.numContexts, 0.5, 8);
+        encoder.start();
+        if (bypass) {
+            encoder.encodeSymbolsBypass(symbols.data(), symbols.size(), CodingConfig(config.binId, config.binParams));
+        } else {
+            encoder.encodeSymbols(symbols.data(), symbols.size(), config);
+        }
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        auto t1 = std::chrono::steady_clock::now();
+
+        cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+        decoder.initCtx(config.numContexts, 0.5, 8);
+        decoder.start();
+        std::vector<uint64_t> symbolsDecoded(symbols.size());
+        if (bypass) {
+            decoder.decodeSymbolsBypass(symbolsDecoded.data(), symbolsDecoded.size(), CodingConfig(config.binId, config.binParams));
+        } else {
+            decoder.decodeSymbols(symbolsDecoded.data(), symbolsDecoded.size(), config);
+        }
+        decoder.decodeBinTrm();
+        decoder.finish();
+        auto t2 = std::chrono::steady_clock::now();
+
+        REQUIRE(symbolsDecoded == symbols);
+        std::cout << (bypass ? "bypass" : "context-coded") << ": encode "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, decode "
+            << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+    }
+}
+
+
+TEST_CASE("benchmark_BI", "[.benchmark]")
+{
+    std::cout << "--- benchmark_BI" << std::endl;
+
+    const int numSymbols = 1000000;
+    for (unsigned int numBins : {8u, 16u, 32u, 64u}) {
+        std::vector<uint64_t> symbols(numSymbols);
+        fillVectorRandomUniform(0, numBins < 64 ? (uint64_t(1) << numBins) - 1 : UINT64_MAX, &symbols);
+        const CodingConfig config(binarization::BinarizationId::BI, contextSelector::ContextModelId::BINPOSITION,
+            {numBins}, {1, numBins, 0});
+        const CodingConfig configBypass(binarization::BinarizationId::BI, {numBins});
+
+        for (int bypass = 0; bypass < 2; bypass++) {
+            auto t0 = std::chrono::steady_clock::now();
+            cabacSimpleSequenceEncoder encoder;
+            encoder.initCtx(config.numContexts, 0.5, 8);
+            encoder.start();
+            if (bypass) {
+                encoder.encodeSymbolsBypass(symbols.data(), symbols.size(), configBypass);
+            } else {
+                encoder.encodeSymbols(symbols.data(), symbols.size(), config);
+            }
+            encoder.encodeBinTrm(1);
+            encoder.finish();
+            encoder.writeByteAlignment();
+            auto t1 = std::chrono::steady_clock::now();
+
+            cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+            decoder.initCtx(config.numContexts, 0.5, 8);
+            decoder.start();
+            std::vector<uint64_t> symbolsDecoded(symbols.size());
+            if (bypass) {
+                decoder.decodeSymbolsBypass(symbolsDecoded.data(), symbolsDecoded.size(), configBypass);
+            } else {
+                decoder.decodeSymbols(symbolsDecoded.data(), symbolsDecoded.size(), config);
+            }
+            decoder.decodeBinTrm();
+            decoder.finish();
+            auto t2 = std::chrono::steady_clock::now();
+
+            REQUIRE(symbolsDecoded == symbols);
+            std::cout << numBins << " bins, " << (bypass ? "bypass" : "context-coded") << ": encode "
+                << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, decode "
+                << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+        }
+    }
+}
+
+
+
+TEST_CASE("benchmark_rans", "[.benchmark]")
+{
+    std::cout << "--- benchmark_rans" << std::endl;
+
+    // Stationary 8-bit symbols: rANS vs. context-coded and bypass-coded BI with the binary engine
+    const unsigned int numSymbols = 4000000;
+    std::mt19937 gen(0);
+    std::geometric_distribution<int> geometric(0.02);
+    std::vector<uint64_t> symbols(numSymbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min(geometric(gen), 255);
+    }
+
+    for (unsigned int numStates : {4u, 8u}) {
+        const rans::Config config(256, numStates);
+        auto t0 = std::chrono::steady_clock::now();
+        ransSequenceEncoder encoder;
+        encoder.encodeSymbols(symbols.data(), numSymbols, config);
+        auto t1 = std::chrono::steady_clock::now();
+
+        ransSequenceDecoder decoder(encoder.getBitstream());
+        std::vector<uint64_t> symbolsDecoded(numSymbols);
+        decoder.decodeSymbols(symbolsDecoded.data(), numSymbols, config);
+        auto t2 = std::chrono::steady_clock::now();
+
+        REQUIRE(symbolsDecoded == symbols);
+        std::cout << "rANS, " << numStates << " states: " << encoder.getBitstream().size() << " bytes, encode "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, decode "
+            << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+    }
+
+    const CodingConfig config(binarization::BinarizationId::BI, contextSelector::ContextModelId::BINSORDERN, {8}, {1, 8, 0});
+    for (int bypass = 0; bypass < 2; bypass++) {
+        auto t0 = std::chrono::steady_clock::now();
+        cabacSimpleSequenceEncoder encoder;
+        encoder.initCtx(config.numContexts, 0.5, 8);
+        encoder.start();
+        if (bypass) {
+            encoder.encodeSymbolsBypass(symbols.data(), numSymbols, CodingConfig(config.binId, config.binParams));
+        } else {
+            encoder.encodeSymbols(symbols.data(), numSymbols, config);
+        }
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        auto t1 = std::chrono::steady_clock::now();
+
+        cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+        decoder.initCtx(config.numContexts, 0.5, 8);
+        decoder.start();
+        std::vector<uint64_t> symbolsDecoded(numSymbols);
+        if (bypass) {
+            decoder.decodeSymbolsBypass(symbolsDecoded.data(), numSymbols, CodingConfig(config.binId, config.binParams));
+        } else {
+            decoder.decodeSymbols(symbolsDecoded.data(), numSymbols, config);
+        }
+        decoder.decodeBinTrm();
+        decoder.finish();
+        auto t2 = std::chrono::steady_clock::now();
+
+        REQUIRE(symbolsDecoded == symbols);
+        std::cout << "binary BI, " << (bypass ? "bypass" : "context-coded") << ": " << encoder.getBitstream().size()
+            << " bytes, encode " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, decode "
+            << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+    }
+}
+
+
+TEST_CASE("benchmark_multiSymbol", "[.benchmark]")
+{
+    std::cout << "--- benchmark_multiSymbol" << std::endl;
+
+    // Multi-symbol backend vs. binary engine (TU, one context per bin) on the same 16-letter data
+    const unsigned int numSymbols = 1000000;
+    std::vector<uint64_t> symbols = getMultiSymbolTestData(numSymbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 15);
+    }
+
+    for (unsigned int order = 0; order < 2; order++) {
+        const multiSymbol::Config config(16, order);
+        auto t0 = std::chrono::steady_clock::now();
+        multiSymbolSequenceEncoder encoder;
+        encoder.initCtx(config.numContexts, config.alphabetSize);
+        encoder.start();
+        encoder.encodeSymbols(symbols.data(), numSymbols, config);
+        encoder.finish();
+        auto t1 = std::chrono::steady_clock::now();
+
+        multiSymbolSequenceDecoder decoder(encoder.getBitstream());
+        decoder.initCtx(config.numContexts, config.alphabetSize);
+        decoder.start();
+        std::vector<uint64_t> symbolsDecoded(numSymbols);
+        decoder.decodeSymbols(symbolsDecoded.data(), numSymbols, config);
+        auto t2 = std::chrono::steady_clock::now();
+
+        REQUIRE(symbolsDecoded == symbols);
+        std::cout << "multi-symbol, order " << order << ": " << encoder.getBitstream().size() << " bytes, encode "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, decode "
+            << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+    }
+
+    for (unsigned int order = 0; order < 2; order++) {
+        const CodingConfig config = order == 0 ?
+            CodingConfig(binarization::BinarizationId::TU, contextSelector::ContextModelId::BINPOSITION, {15}, {1, 15, 0}) :
+            CodingConfig(binarization::BinarizationId::TU, contextSelector::ContextModelId::SYMBOLORDERN, {15}, {1, 15, 0, 15});
+        auto t0 = std::chrono::steady_clock::now();
+        cabacSimpleSequenceEncoder encoder;
+        encoder.initCtx(config.numContexts, 0.5, 8);
+        encoder.start();
+        encoder.encodeSymbols(symbols.data(), numSymbols, config);
+        encoder.encodeBinTrm(1);
+        encoder.finish();
+        encoder.writeByteAlignment();
+        auto t1 = std::chrono::steady_clock::now();
+
+        cabacSimpleSequenceDecoder decoder(encoder.getBitstream());
+        decoder.initCtx(config.numContexts, 0.5, 8);
+        decoder.start();
+        std::vector<uint64_t> symbolsDecoded(numSymbols);
+        decoder.decodeSymbols(symbolsDecoded.data(), numSymbols, config);
+        decoder.decodeBinTrm();
+        decoder.finish();
+        auto t2 = std::chrono::steady_clock::now();
+
+        REQUIRE(symbolsDecoded == symbols);
+        std::cout << "binary TU, order " << order << ": " << encoder.getBitstream().size() << " bytes, encode "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, decode "
+            << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+    }
+}
+
+TEST_CASE("test_ContextIdProvider")
+{
+    std::cout << "--- test_ContextIdProvider" << std::endl;
+
+    std::vector<uint64_t> symbols(200);
+    fillVectorRandomGeometric(&symbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 255);
+    }
+
+    const std::vector<std::tuple<binarization::BinarizationId, std::vector<unsigned int>>> binarizations = {
+        std::make_tuple(binarization::BinarizationId::BI, std::vector<unsigned int>{8}),
+        std::make_tuple(binarization::BinarizationId::TU, std::vector<unsigned int>{255}),
+        std::make_tuple(binarization::BinarizationId::EGk, std::vector<unsigned int>{255, 0}),
+        std::make_tuple(binarization::BinarizationId::EGk, std::vector<unsigned int>{255, 2}),
+        std::make_tuple(binarization::BinarizationId::TB, std::vector<unsigned int>{299}),
+        std::make_tuple(binarization::BinarizationId::UEGk, std::vector<unsigned int>{4, 1}),
+    };
+
+    for (const auto& binarization : binarizations) {
+        for (unsigned int m = 0; m <= 7; m++) {
+            for (unsigned int order = 1; order <= 3; order++) {
+                const binarization::BinarizationId binId = std::get<0>(binarization);
+                const std::vector<unsigned int>& binParams = std::get<1>(binarization);
+                const auto ctxModelId = static_cast<contextSelector::ContextModelId>(m);
+                const std::vector<unsigned int> ctxParams = {order, 5, 3, 4, 4, 0, 0, 0};
+
+                // Reference: all context IDs at once
+                std::vector<unsigned int> ctxIdsRef(binParams[0], 0);
+                contextSelector::ContextIdProvider ctxIds(binId, ctxModelId, binParams, ctxParams);
+                for (unsigned int d = 3; d < symbols.size(); d++) {
+                    const uint64_t symbolsPrev[3] = {symbols[d - 1], symbols[d - 2], symbols[d - 3]};
+                    contextSelector::getContextIds(ctxIdsRef, d, symbolsPrev, binId, ctxModelId, binParams, ctxParams);
+                    ctxIds.setSymbol(d, symbolsPrev);
+                    for (unsigned int n = 0; n < ctxIdsRef.size(); n++) {
+                        if (ctxIds(n) != ctxIdsRef[n]) {
+                            FAIL("Mismatch for symbol " << d << ", bin " << n);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    SUCCEED();
+}
+
+
+TEST_CASE("test_CodingConfig")
+{
+    std::cout << "--- test_CodingConfig" << std::endl;
+
+    const auto TU = binarization::BinarizationId::TU;
+    const auto EGk = binarization::BinarizationId::EGk;
+    const auto BINSORDERN = contextSelector::ContextModelId::BINSORDERN;
+    const auto BINSORDERNSYMBOLPOSITION = contextSelector::ContextModelId::BINSORDERNSYMBOLPOSITION;
+
+    // Validation
+    REQUIRE_THROWS(CodingConfig(TU, BINSORDERN, {32}, {0, 4, 0}));  // order 0
+    REQUIRE_THROWS(CodingConfig(TU, BINSORDERN, {32}, {4, 4, 0}));  // order 4
+    REQUIRE_THROWS(CodingConfig(TU, BINSORDERN, {32}, {1, 4}));  // missing offset
+    REQUIRE_THROWS(CodingConfig(EGk, BINSORDERN, {32}, {1, 4, 0}));  // missing k
+    REQUIRE_THROWS(CodingConfig(TU, contextSelector::ContextModelId::SYMBOLORDERN, {32}, {1, 4, 0}));  // missing symbolMax
+    REQUIRE_THROWS(CodingConfig(TU, BINSORDERNSYMBOLPOSITION, {32}, {1, 4, 0, 0, 1}));  // missing intervals
+    REQUIRE_THROWS(CodingConfig(binarization::BinarizationId::RICE, BINSORDERN, {0, 0, 1, 5, 15}, {1, 4, 0}));
+    REQUIRE_THROWS(CodingConfig(binarization::BinarizationId::RICE, {0, 0, 1}));
+
+    // Derived values
+    const std::vector<unsigned int> binParams = {255, 1};
+    const std::vector<unsigned int> ctxParams = {2, 6, 3, 0, 1, 10, 100, 1000};
+    const CodingConfig config(EGk, BINSORDERNSYMBOLPOSITION, binParams, ctxParams);
+    REQUIRE(config.numContexts == contextSelector::getNumContexts(EGk, BINSORDERNSYMBOLPOSITION, binParams, ctxParams));
+    REQUIRE(config.numMaxPrefixBins == 8);  // 255 -> 7 leading zeros + terminating bin
+    for (unsigned int d : {0u, 9u, 10u, 99u, 100u, 999u, 1000u}) {
+        REQUIRE(config.getSymbolPositionContextOffset(d) ==
+            contextSelector::getSymbolPositionContextOffset(d, EGk, BINSORDERNSYMBOLPOSITION, binParams, ctxParams));
+    }
+
+    // Coding with a configuration is identical to coding with the parameter vectors
+    std::vector<uint64_t> symbols(2000);
+    fillVectorRandomGeometric(&symbols);
+    for (auto& symbol : symbols) {
+        symbol = std::min<uint64_t>(symbol, 255);
+    }
+
+    cabacSimpleSequenceEncoder encoderRef;
+    encoderRef.initCtx(config.numContexts + ctxParams[2], 0.5, 8);
+    encoderRef.start();
+    encoderRef.encodeSymbols(symbols.data(), symbols.size(), EGk, BINSORDERNSYMBOLPOSITION, binParams, ctxParams);
+    encoderRef.encodeBinTrm(1);
+    encoderRef.finish();
+
+    cabacSimpleSequenceEncoder encoder;
+    encoder.initCtx(config.numContexts + ctxParams[2], 0.5, 8);
+    encoder.start();
+    encoder.encodeSymbols(symbols.data(), symbols.size(), config);
+    encoder.encodeBinTrm(1);
+    encoder.finish();
+
+    REQUIRE(encoderRef.getBitstream() == encoder.getBitstream());
+}
@@ -2,6 +2,7 @@ import unittest
 import random
 import cabac
 import math
+import numpy as np
 
 import tests.utils.symbolgenerator as symbolgenerator
 
@@ -107,6 +108,30 @@ class MainTest(unittest.TestCase):
 
         self.assertTrue(decodedSymbol == symbol)
 
+    def test_rem_abs_ep_array(self):
+        symbols = np.array(symbolgenerator.random_uniform(1000, 5000), dtype=np.uint64)
+        rice_pars = np.array([i % 4 for i in range(len(symbols))], dtype=np.uint32)
+
+        enc = cabac.cabacEncoder()
+        enc.start()
+        enc.encodeRemAbsEPArray(symbols, 1, 5, 15)
+        enc.encodeRemAbsEPArray(symbols, rice_pars, 5, 15)
+        enc.encodeBinTrm(1)
+        enc.finish()
+        enc.writeByteAlignment()
+
+        bs = enc.getBitstream()
+
+        dec = cabac.cabacDecoder(bs)
+        dec.start()
+        decoded = dec.decodeRemAbsEPArray(len(symbols), 1, 5, 15)
+        decoded_rice_pars = dec.decodeRemAbsEPArray(rice_pars, 5, 15)
+        dec.decodeBinTrm()
+        dec.finish()
+
+        self.assertTrue(np.array_equal(decoded, symbols))
+        self.assertTrue(np.array_equal(decoded_rice_pars, symbols))
+
     def test_enc_dec(self):
 
         p1_init = 0.6
@@ -207,6 +207,437 @@ class MainTest(unittest.TestCase):
                 print('Testing function: ' + fun + ' with order ' + str(order))
                 self._call_cabac_symbols_order_n(fun, order)
 
+    def test_encode_symbols_precomputed(self):
+        import numpy as np
+        random.seed(0)
+        print('test_encode_symbols_precomputed')
+        symbols = np.array(symbolgenerator.random_geometric(10000, 0.05))
+        configs = [
+            (cabac.BinarizationId.BI, cabac.ContextModelId.BINSORDERN, [8]),
+            (cabac.BinarizationId.TU, cabac.ContextModelId.BINSORDERN, [255]),
+            (cabac.BinarizationId.TU, cabac.ContextModelId.SYMBOLORDERN, [255]),
+            (cabac.BinarizationId.EGk, cabac.ContextModelId.BINSORDERN, [255, 1]),
+        ]
+        for bin_id, ctx_model_id, bin_params in configs:
+            for order in [1, 2, 3]:
+                ctx_params = [order, 24, 0, 16]
+                num_ctxs = cabac.getNumContexts(
+                    bin_id, ctx_model_id, bin_params, ctx_params
+                )
+                bitstreams = []
+                for precomputed in [False, True]:
+                    enc = cabac.cabacSimpleSequenceEncoder()
+                    enc.initCtx(num_ctxs, 0.5, 8)
+                    enc.start()
+                    if precomputed:
+                        enc.encodeSymbolsPrecomputed(
+                            symbols, bin_id, ctx_model_id, bin_params, ctx_params
+                        )
+                    else:
+                        enc.encodeSymbols(
+                            symbols, bin_id, ctx_model_id, bin_params, ctx_params
+                        )
+                    enc.encodeBinTrm(1)
+                    enc.finish()
+                    enc.writeByteAlignment()
+                    bitstreams.append(enc.getBitstream())
+
+                self.assertEqual(bitstreams[0], bitstreams[1])
+
+    def test_encode_symbols_coding_config(self):
+        import numpy as np
+        random.seed(0)
+        print('test_encode_symbols_coding_config')
+        symbols = np.array(symbolgenerator.random_geometric(10000, 0.05))
+        configs = [
+            cabac.CodingConfig(
+                cabac.BinarizationId.EGk, cabac.ContextModelId.BINSORDERN, [255, 1], [2, 24, 0]
+            ),
+            cabac.CodingConfig(cabac.BinarizationId.EGk, [255, 1]),
+            cabac.CodingConfig(
+                cabac.BinarizationId.RICE, cabac.ContextModelId.BINPOSITION, [0, 0, 0, 5, 15], [1, 5, 0]
+            ),
+            cabac.CodingConfig(
+                cabac.BinarizationId.TB, cabac.ContextModelId.BINSORDERN, [1000], [1, 10, 0]
+            ),
+            cabac.CodingConfig(
+                cabac.BinarizationId.UEGk, cabac.ContextModelId.BINPOSITION, [14, 2], [1, 14, 0]
+            ),
+        ]
+        for config in configs:
+            enc = cabac.cabacSimpleSequenceEncoder()
+            enc.initCtx(config.numContexts, 0.5, 8)
+            enc.start()
+            enc.encodeSymbols(symbols, config)
+            enc.encodeBinTrm(1)
+            enc.finish()
+            enc.writeByteAlignment()
+
+            bs = enc.getBitstream()
+
+            dec = cabac.cabacSimpleSequenceDecoder(bs)
+            dec.initCtx(config.numContexts, 0.5, 8)
+            dec.start()
+            decoded_symbols = dec.decodeSymbols(len(symbols), config)
+            dec.decodeBinTrm()
+            dec.finish()
+
+            self.assertTrue((decoded_symbols == symbols).all())
+
+    def test_encode_symbols_signed(self):
+        import numpy as np
+        random.seed(0)
+        print('test_encode_symbols_signed')
+        magnitudes = np.array(symbolgenerator.random_geometric(10000, 0.05))
+        signs = np.where(np.arange(len(magnitudes)) // 100 % 2 == 0, 1, -1)
+        config = cabac.CodingConfig(
+            cabac.BinarizationId.EGk, cabac.ContextModelId.BINSORDERN, [255, 1], [2, 8, 0]
+        )
+        num_ctx = config.numContexts + cabac.CodingConfig.numSignContexts
+        for dtype in [np.int8, np.int16, np.int32, np.int64]:
+            symbols = (np.minimum(magnitudes, 127) * signs).astype(dtype)
+            for sign_mode in [cabac.SignMode.ZIGZAG, cabac.SignMode.SIGNBYPASS, cabac.SignMode.SIGNCONTEXT]:
+                enc = cabac.cabacSimpleSequenceEncoder()
+                enc.initCtx(num_ctx, 0.5, 8)
+                enc.start()
+                enc.encodeSymbolsSigned(symbols, config, sign_mode)
+                enc.encodeBinTrm(1)
+                enc.finish()
+                enc.writeByteAlignment()
+
+                dec = cabac.cabacSimpleSequenceDecoder(enc.getBitstream())
+                dec.initCtx(num_ctx, 0.5, 8)
+                dec.start()
+                decoded_symbols = dec.decodeSymbolsSigned(len(symbols), config, sign_mode, np.dtype(dtype))
+                dec.decodeBinTrm()
+                dec.finish()
+
+                self.assertEqual(decoded_symbols.dtype, symbols.dtype)
+                self.assertTrue((decoded_symbols == symbols).all())
+
+    def test_encode_symbols_predicted(self):
+        import numpy as np
+        print('test_encode_symbols_predicted')
+        t = np.arange(10000) * 0.01
+        symbols = (30000 + 20000 * np.sin(t)).astype(np.uint16)
+        config = cabac.CodingConfig(
+            cabac.BinarizationId.EGk, cabac.ContextModelId.BINSORDERN, [1 << 16, 0], [2, 12, 0]
+        )
+        num_ctx = config.numContexts + cabac.CodingConfig.numSignContexts
+        sizes = []
+        for predictor_id in [cabac.PredictorId.NONE, cabac.PredictorId.PREVIOUS, cabac.PredictorId.LINEAR]:
+            predictor = cabac.Predictor(predictor_id, 1)
+            enc = cabac.cabacSimpleSequenceEncoder()
+            enc.initCtx(num_ctx, 0.5, 8)
+            enc.start()
+            enc.encodeSymbolsSigned(symbols, config, cabac.SignMode.ZIGZAG, predictor)
+            enc.encodeBinTrm(1)
+            enc.finish()
+            enc.writeByteAlignment()
+            bs = enc.getBitstream()
+            sizes.append(len(bs))
+
+            dec = cabac.cabacSimpleSequenceDecoder(bs)
+            dec.initCtx(num_ctx, 0.5, 8)
+            dec.start()
+            decoded_symbols = dec.decodeSymbolsSigned(len(symbols), config, cabac.SignMode.ZIGZAG, np.dtype(np.uint16), predictor)
+            dec.decodeBinTrm()
+            dec.finish()
+
+            self.assertEqual(decoded_symbols.dtype, symbols.dtype)
+            self.assertTrue((decoded_symbols == symbols).all())
+        self.assertLess(sizes[1], sizes[0])
+        self.assertLess(sizes[2], sizes[1])
+
+    def test_encode_symbols_remapped(self):
+        import numpy as np
+        print('test_encode_symbols_remapped')
+        rng = np.random.default_rng(0)
+        symbols = rng.choice([200, 17, 250, 3], size=10000, p=[0.6, 0.25, 0.1, 0.05]).astype(np.uint64)
+        config = cabac.CodingConfig(
+            cabac.BinarizationId.EGk, cabac.ContextModelId.BINSORDERN, [255, 0], [2, 12, 0]
+        )
+        sizes = []
+        for remapper_id in [cabac.RemapperId.NONE, cabac.RemapperId.FREQUENCY, cabac.RemapperId.MTF]:
+            enc = cabac.cabacSimpleSequenceEncoder()
+            enc.initCtx(config.numContexts, 0.5, 8)
+            enc.start()
+            enc.encodeSymbolsRemapped(symbols, config, cabac.SymbolRemapper(remapper_id, 256))
+            enc.encodeBinTrm(1)
+            enc.finish()
+            enc.writeByteAlignment()
+            bs = enc.getBitstream()
+            sizes.append(len(bs))
+
+            dec = cabac.cabacSimpleSequenceDecoder(bs)
+            dec.initCtx(config.numContexts, 0.5, 8)
+            dec.start()
+            decoded_symbols = dec.decodeSymbolsRemapped(len(symbols), config, cabac.SymbolRemapper(remapper_id, 256))
+            dec.decodeBinTrm()
+            dec.finish()
+
+            self.assertTrue((decoded_symbols == symbols).all())
+        self.assertLess(sizes[1], sizes[0])
+        self.assertLess(sizes[2], sizes[0])
+
+    def test_encode_symbols_transformed(self):
+        import numpy as np
+        print('test_encode_symbols_transformed')
+        rng = np.random.default_rng(0)
+        segment = rng.integers(0, 4, size=1000, dtype=np.uint64)
+        symbols = np.concatenate([segment, np.full(100, 2, dtype=np.uint64)] * 10)
+        symbol_config = cabac.CodingConfig(cabac.BinarizationId.BI, cabac.ContextModelId.BINSORDERN, [2], [2, 2, 0])
+        flag_config = cabac.CodingConfig(cabac.BinarizationId.BI, cabac.ContextModelId.BINSORDERN, [1], [2, 1, 0])
+        value_config = cabac.CodingConfig(cabac.BinarizationId.TB, cabac.ContextModelId.BINSORDERN, [2], [1, 2, 10])
+        length_config = cabac.CodingConfig(cabac.BinarizationId.EGk, cabac.ContextModelId.BINPOSITION, [1 << 16, 0], [1, 16, 20])
+        offset_config = cabac.CodingConfig(cabac.BinarizationId.EGk, cabac.ContextModelId.BINPOSITION, [1 << 16, 0], [1, 16, 40])
+        transforms = [
+            (lambda enc: enc.encodeSymbolsEquality(symbols, flag_config, value_config),
+             lambda dec: dec.decodeSymbolsEquality(len(symbols), flag_config, value_config)),
+            (lambda enc: enc.encodeSymbolsRunLength(symbols, 8, symbol_config, length_config),
+             lambda dec: dec.decodeSymbolsRunLength(len(symbols), 8, symbol_config, length_config)),
+            (lambda enc: enc.encodeSymbolsMatch(symbols, 4096, length_config, offset_config, symbol_config),
+             lambda dec: dec.decodeSymbolsMatch(len(symbols), length_config, offset_config, symbol_config)),
+        ]
+        sizes = []
+        for encode, decode in transforms:
+            enc = cabac.cabacSimpleSequenceEncoder()
+            enc.initCtx(60, 0.5, 8)
+            enc.start()
+            encode(enc)
+            enc.encodeBinTrm(1)
+            enc.finish()
+            enc.writeByteAlignment()
+            bs = enc.getBitstream()
+            sizes.append(len(bs))
+
+            dec = cabac.cabacSimpleSequenceDecoder(bs)
+            dec.initCtx(60, 0.5, 8)
+            dec.start()
+            decoded_symbols = decode(dec)
+            dec.decodeBinTrm()
+            dec.finish()
+            self.assertTrue((decoded_symbols == symbols).all())
+        self.assertLess(sizes[2], sizes[0] / 4)
+
+    def test_encode_symbols_multi_symbol(self):
+        import numpy as np
+        print('test_encode_symbols_multi_symbol')
+        rng = np.random.default_rng(0)
+        symbols = rng.geometric(0.3, size=10000).astype(np.uint64) - 1
+        for order in range(3):
+            config = cabac.MultiSymbolConfig(16, order)
+            for adaptation in [cabac.CdfAdaptation(), cabac.CdfAdaptation(4, 6, 8)]:
+                enc = cabac.multiSymbolSequenceEncoder()
+                enc.initCtx(config.numContexts, config.alphabetSize, adaptation)
+                enc.start()
+                enc.encodeSymbols(symbols, config)
+                enc.finish()
+                bs = enc.getBitstream()
+
+                dec = cabac.multiSymbolSequenceDecoder(bs)
+                dec.initCtx(config.numContexts, config.alphabetSize, adaptation)
+                dec.start()
+                decoded_symbols = dec.decodeSymbols(len(symbols), config)
+                dec.finish()
+                self.assertTrue((decoded_symbols == symbols).all())
+
+    def test_encode_symbols_rans(self):
+        import numpy as np
+        print('test_encode_symbols_rans')
+        rng = np.random.default_rng(0)
+        symbols = np.minimum(rng.geometric(0.05, size=10001) - 1, 255).astype(np.uint64)
+        counts = np.bincount(symbols.astype(np.int64), minlength=256).tolist()
+        configs = [cabac.RansConfig(256, 4), cabac.RansConfig(256, 8), cabac.RansConfig(256, 4, counts)]
+        enc = cabac.ransSequenceEncoder()
+        enc.start()
+        for config in configs:
+            enc.encodeSymbols(symbols, config)
+        enc.finish()
+        bs = enc.getBitstream()
+
+        dec = cabac.ransSequenceDecoder(bs)
+        dec.start()
+        for config in configs:
+            decoded_symbols = dec.decodeSymbols(len(symbols), config)
+            self.assertTrue((decoded_symbols == symbols).all())
+        dec.finish()
+
+    def test_mps_run(self):
+        print('test_mps_run')
+        random.seed(0)
+        runs = [random.randint(0, 300) for _ in range(200)]
+        bitstreams = []
+        for run_mode in [False, True]:
+            enc = cabac.cabacEncoder()
+            enc.initCtx(1, 0.9, 8)
+            enc.start()
+            for run in runs:
+                mps = enc.getMps(0)
+                if run_mode:
+                    enc.encodeMPSRun(0, run)
+                else:
+                    for _ in range(run):
+                        enc.encodeBin(mps, 0)
+                enc.encodeBin(1 - enc.getMps(0), 0)
+            enc.encodeBinTrm(1)
+            enc.finish()
+            enc.writeByteAlignment()
+            bitstreams.append(enc.getBitstream())
+        self.assertEqual(bitstreams[0], bitstreams[1])
+
+        dec = cabac.cabacDecoder(bitstreams[1])
+        dec.initCtx(1, 0.9, 8)
+        dec.start()
+        for run in runs:
+            self.assertEqual(dec.decodeMPSRun(0, 1000), run)
+            dec.decodeBin(0)
+        self.assertEqual(dec.decodeBinTrm(), 1)
+        dec.finish()
+
+    def test_frozen_contexts(self):
+        print('test_frozen_contexts')
+        random.seed(0)
+        bins = [int(random.random() < 0.2) for _ in range(2000)]
+        frozen_ctx = cabac.FrozenContexts([(0.2, 8), (0.5, 8)])
+        enc = cabac.cabacEncoder()
+        enc.initCtx(frozen_ctx)
+        self.assertTrue(enc.isCtxFrozen(0))
+        enc.start()
+        for b in bins:
+            enc.encodeBin(b, 0)
+        enc.encodeBinTrm(1)
+        enc.finish()
+        enc.writeByteAlignment()
+
+        dec = cabac.cabacDecoder(enc.getBitstream())
+        dec.initCtx(frozen_ctx)
+        dec.start()
+        for b in bins:
+            self.assertEqual(dec.decodeBin(0), b)
+        self.assertEqual(dec.decodeBinTrm(), 1)
+        dec.finish()
+
+    def test_export_import_contexts(self):
+        print('test_export_import_contexts')
+        random.seed(0)
+        bins = [int(random.random() < 0.1) for _ in range(1000)]
+        enc = cabac.cabacEncoder()
+        enc.initCtx(1, 0.5, 8)
+        enc.start()
+        for b in bins:
+            enc.encodeBin(b, 0)
+        words = enc.exportContexts()
+        self.assertEqual(len(words), 3)
+
+        bitstreams = []
+        for warm in [False, True]:
+            enc = cabac.cabacEncoder()
+            if warm:
+                enc.importContexts(words)
+            else:
+                enc.initCtx(1, 0.5, 8)
+            enc.start()
+            for b in bins[:100]:
+                enc.encodeBin(b, 0)
+            enc.encodeBinTrm(1)
+            enc.finish()
+            enc.writeByteAlignment()
+            bitstreams.append(enc.getBitstream())
+        self.assertLess(len(bitstreams[1]), len(bitstreams[0]))
+
+        dec = cabac.cabacDecoder(bitstreams[1])
+        dec.importContexts(words)
+        dec.start()
+        for b in bins[:100]:
+            self.assertEqual(dec.decodeBin(0), b)
+        self.assertEqual(dec.decodeBinTrm(), 1)
+        dec.finish()
+
+    def test_train_context_init(self):
+        import numpy as np
+        print('test_train_context_init')
+        rng = np.random.default_rng(0)
+        samples = [np.minimum(rng.geometric(0.6, size=200) - 1, 15).astype(np.uint64) for _ in range(10)]
+        config = cabac.CodingConfig(cabac.BinarizationId.TU, cabac.ContextModelId.BINSORDERN, [15], [1, 4, 0])
+        init_ctx = cabac.trainContextInit(samples, config, numThreads=2)
+        self.assertEqual(len(init_ctx), config.numContexts)
+
+        enc = cabac.cabacSimpleSequenceEncoder()
+        enc.initCtx(init_ctx)
+        enc.start()
+        enc.encodeSymbols(samples[0], config)
+        enc.encodeBinTrm(1)
+        enc.finish()
+        enc.writeByteAlignment()
+
+        dec = cabac.cabacSimpleSequenceDecoder(enc.getBitstream())
+        dec.initCtx(init_ctx)
+        dec.start()
+        decoded_symbols = dec.decodeSymbols(len(samples[0]), config)
+        self.assertTrue((decoded_symbols == samples[0]).all())
+        dec.decodeBinTrm()
+        dec.finish()
+
+    def test_autotune(self):
+        import numpy as np
+        print('test_autotune')
+        rng = np.random.default_rng(1)
+        symbols = np.minimum(rng.geometric(0.3, size=5000) - 1, 40).astype(np.uint64)
+        search_space = cabac.SearchSpace()
+        search_space.binIds = [cabac.BinarizationId.TU, cabac.BinarizationId.EGk]
+        results = cabac.autotune(symbols, search_space, numThreads=2)
+        self.assertEqual(len(results), len(search_space.getCandidates(40)))
+        bits = [r.bitsPerSymbol for r in results]
+        self.assertEqual(bits, sorted(bits))
+        self.assertTrue(all(r.symbolsPerSecond > 0 for r in results))
+
+        config = results[0].config
+        enc = cabac.cabacSimpleSequenceEncoder()
+        enc.initCtx(config.numContexts, 0.5, 8)
+        enc.start()
+        enc.encodeSymbols(symbols, config)
+        enc.encodeBinTrm(1)
+        enc.finish()
+        enc.writeByteAlignment()
+        self.assertAlmostEqual(len(enc.getBitstream()) * 8 / len(symbols), results[0].bitsPerSymbol, delta=0.05)
+
+        dec = cabac.cabacSimpleSequenceDecoder(enc.getBitstream())
+        dec.initCtx(config.numContexts, 0.5, 8)
+        dec.start()
+        decoded_symbols = dec.decodeSymbols(len(symbols), config)
+        self.assertTrue((decoded_symbols == symbols).all())
+        dec.decodeBinTrm()
+        dec.finish()
+
+    def test_block_switching(self):
+        import numpy as np
+        print('test_block_switching')
+        rng = np.random.default_rng(2)
+        skewed = np.minimum(rng.geometric(0.7, size=2000) - 1, 63)
+        uniform = rng.integers(0, 64, size=2000)
+        symbols = np.concatenate([skewed, uniform, skewed]).astype(np.uint64)
+        config_tu = cabac.CodingConfig(cabac.BinarizationId.TU, cabac.ContextModelId.BINSORDERN, [63], [1, 8, 0])
+        config_bi = cabac.CodingConfig(cabac.BinarizationId.BI, [6])
+        block_config = cabac.BlockSwitchingConfig([config_tu, config_bi], 500)
+
+        enc = cabac.cabacSimpleSequenceEncoder()
+        enc.initCtx(block_config.numContexts, 0.5, 8)
+        enc.start()
+        selection = enc.encodeSymbolsBlockSwitching(symbols, block_config)
+        enc.encodeBinTrm(1)
+        enc.finish()
+        enc.writeByteAlignment()
+        self.assertEqual(selection, [0] * 4 + [1] * 4 + [0] * 4)
+
+        dec = cabac.cabacSimpleSequenceDecoder(enc.getBitstream())
+        dec.initCtx(block_config.numContexts, 0.5, 8)
+        dec.start()
+        decoded_symbols = dec.decodeSymbolsBlockSwitching(len(symbols), block_config)
+        self.assertTrue((decoded_symbols == symbols).all())
+        dec.decodeBinTrm()
+        dec.finish()
+
     def _call_cabac_symbols_bypass(self, fun='EGk', k_or_rice_param=0):
         import numpy as np
 
@@ -329,6 +760,45 @@ class MainTest(unittest.TestCase):
 
         self.assertTrue((symbols_dec == symbols).all())
 
+    def test_encode_symbols_bypass_aligned(self):
+        random.seed(0)
+        num_bins = 12
+        symbols = symbolgenerator.random_uniform(
+            num_values=10000, max_val=(1 << num_bins)
+        )
+
+        bin_id = cabac.BinarizationId.BI
+        bin_params = [num_bins]
+
+        enc = cabac.cabacSimpleSequenceEncoder()
+        enc.initCtx(1, 0.5, 8)
+        enc.start()
+
+        enc.encodeBin(1, 0)
+        enc.encodeSymbolsBypassAligned(symbols, bin_id, bin_params)
+        enc.encodeBin(0, 0)
+
+        enc.encodeBinTrm(1)
+        enc.finish()
+        enc.writeByteAlignment()
+
+        bs = enc.getBitstream()
+
+        # Decode
+        dec = cabac.cabacSimpleSequenceDecoder(bs)
+        dec.initCtx(1, 0.5, 8)
+        dec.start()
+
+        self.assertEqual(dec.decodeBin(0), 1)
+        symbols_dec = dec.decodeSymbolsBypassAligned(len(symbols), bin_id, bin_params)
+        self.assertEqual(dec.decodeBin(0), 0)
+
+        dec.decodeBinTrm()
+        dec.finish()
+        print('Bitstream length: ' + str(len(bs)))
+
+        self.assertTrue((symbols_dec == symbols).all())
+
 
 if __name__ == "__main__":
     unittest.main()